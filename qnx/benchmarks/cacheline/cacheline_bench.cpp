@@ -6,6 +6,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include "ubench/measure/perf_benchmark.h"
 #include "options.h"
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
@@ -25,6 +26,7 @@ __attribute__((noinline)) auto stride_copy(
 }
 
 __attribute__((noinline)) static void BM_CopyStride(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   int slice = static_cast<int>(state.range(0));
 
   // Using `std::vector` adds noise due to the `std::memset` and the data is not
@@ -259,6 +259,10 @@ auto main(int argc, char* argv[]) -> int {
   std::uint32_t busy = mr.busy_time.count() * 10000 / mr.run_time.count();
   std::cout << "Total CPU Busy: " << busy / 100 << "." << std::setw(2)
             << std::setfill('0') << busy % 100 << "%" << std::endl;
+  auto cpus = ubench::measure::make_cpu_table(mr);
+  if (cpus.size() > 0) {
+    std::cout << std::setfill(' ') << std::endl << cpus << std::endl;
+  }
   for (auto& time : m.times()) {
     float rate = options->iterations() * 1000.0 / time.count();
     std::cout << "Thread duration: " << time.count() << "ms (" << rate
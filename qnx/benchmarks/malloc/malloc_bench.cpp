@@ -12,6 +12,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include "ubench/measure/perf_benchmark.h"
 #include "ubench/os.h"
 #include "ubench/string.h"
 #include "allocator.h"
@@ -21,6 +22,7 @@
 // NOLINTBEGIN
 
 static void BM_MallocFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -33,6 +35,7 @@ static void BM_MallocFreeBench(benchmark::State& state) {
 }
 
 static void BM_CallocFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -45,6 +48,7 @@ static void BM_CallocFreeBench(benchmark::State& state) {
 }
 
 static void BM_MallocBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -59,6 +63,7 @@ static void BM_MallocBench(benchmark::State& state) {
 }
 
 static void BM_CallocBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -73,6 +78,7 @@ static void BM_CallocBench(benchmark::State& state) {
 }
 
 static void BM_MFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -87,6 +93,7 @@ static void BM_MFreeBench(benchmark::State& state) {
 }
 
 static void BM_CFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -101,6 +108,7 @@ static void BM_CFreeBench(benchmark::State& state) {
 }
 
 static void BM_MallocWalkFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -124,6 +132,7 @@ static void BM_MallocWalkFreeBench(benchmark::State& state) {
 }
 
 static void BM_MallocClearFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
 
@@ -139,6 +148,7 @@ static void BM_MallocClearFreeBench(benchmark::State& state) {
 }
 
 static void BM_MallocClearWalkFreeBench(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   std::size_t alloc_size = state.range(0);
   auto page_size = ubench::os::get_syspage_size();
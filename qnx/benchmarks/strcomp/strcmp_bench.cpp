@@ -4,6 +4,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include "ubench/measure/perf_benchmark.h"
+
 #ifdef NDEBUG
 #include <cassert>
 #endif
@@ -49,6 +51,7 @@ static std::string token_nomatchlonger{
     "this_is_a_longer_string_that_doesnt_match"};
 
 static void BM_StrFindWithSubStr(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -61,6 +64,7 @@ static void BM_StrFindWithSubStr(benchmark::State& state) {
 }
 
 static void BM_StrFindWithSubStrLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -73,6 +77,7 @@ static void BM_StrFindWithSubStrLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithSubStrFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -85,6 +90,7 @@ static void BM_StrFindWithSubStrFail(benchmark::State& state) {
 }
 
 static void BM_StrFindWithSubStrFailLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -99,6 +105,7 @@ static void BM_StrFindWithSubStrFailLenCheck(benchmark::State& state) {
 // The string being searched for is longer. Should be very fast as only length
 // comparisons are needed.
 static void BM_StrFindWithSubStrLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -111,6 +118,7 @@ static void BM_StrFindWithSubStrLong(benchmark::State& state) {
 }
 
 static void BM_StrFindWithSubStrLongLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -123,6 +131,7 @@ static void BM_StrFindWithSubStrLongLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithCompare(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -135,6 +144,7 @@ static void BM_StrFindWithCompare(benchmark::State& state) {
 }
 
 static void BM_StrFindWithCompareLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -147,6 +157,7 @@ static void BM_StrFindWithCompareLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithCompareFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -159,6 +170,7 @@ static void BM_StrFindWithCompareFail(benchmark::State& state) {
 }
 
 static void BM_StrFindWithCompareFailLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -171,6 +183,7 @@ static void BM_StrFindWithCompareFailLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithCompareLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -183,6 +196,7 @@ static void BM_StrFindWithCompareLong(benchmark::State& state) {
 }
 
 static void BM_StrFindWithCompareLongLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -195,6 +209,7 @@ static void BM_StrFindWithCompareLongLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithFirstOf(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -207,6 +222,7 @@ static void BM_StrFindWithFirstOf(benchmark::State& state) {
 }
 
 static void BM_StrFindWithFirstOfLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -219,6 +235,7 @@ static void BM_StrFindWithFirstOfLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithFirstOfFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -231,6 +248,7 @@ static void BM_StrFindWithFirstOfFail(benchmark::State& state) {
 }
 
 static void BM_StrFindWithFirstOfFailLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -243,6 +261,7 @@ static void BM_StrFindWithFirstOfFailLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrFindWithFirstOfLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -254,6 +273,7 @@ static void BM_StrFindWithFirstOfLong(benchmark::State& state) {
   }
 }
 static void BM_StrFindWithFirstOfLongLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -328,6 +348,7 @@ static std::string_view token_nomatchlonger_v{
     "this_is_a_longer_string_that_doesnt_match"};
 
 static void BM_StrVFindWithSubStr(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -340,6 +361,7 @@ static void BM_StrVFindWithSubStr(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithSubStrLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -352,6 +374,7 @@ static void BM_StrVFindWithSubStrLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithSubStrFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -364,6 +387,7 @@ static void BM_StrVFindWithSubStrFail(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithSubStrFailLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -378,6 +402,7 @@ static void BM_StrVFindWithSubStrFailLenCheck(benchmark::State& state) {
 // The string being searched for is longer. Should be very fast as only length
 // comparisons are needed.
 static void BM_StrVFindWithSubStrLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -390,6 +415,7 @@ static void BM_StrVFindWithSubStrLong(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithSubStrLongLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -403,6 +429,7 @@ static void BM_StrVFindWithSubStrLongLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithCompare(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -415,6 +442,7 @@ static void BM_StrVFindWithCompare(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithCompareLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -427,6 +455,7 @@ static void BM_StrVFindWithCompareLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithCompareFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -439,6 +468,7 @@ static void BM_StrVFindWithCompareFail(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithCompareFailLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -451,6 +481,7 @@ static void BM_StrVFindWithCompareFailLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithCompareLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -463,6 +494,7 @@ static void BM_StrVFindWithCompareLong(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithCompareLongLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -476,6 +508,7 @@ static void BM_StrVFindWithCompareLongLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithFirstOf(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -488,6 +521,7 @@ static void BM_StrVFindWithFirstOf(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithFirstOfLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -500,6 +534,7 @@ static void BM_StrVFindWithFirstOfLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithFirstOfFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -512,6 +547,7 @@ static void BM_StrVFindWithFirstOfFail(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithFirstOfFailLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -524,6 +560,7 @@ static void BM_StrVFindWithFirstOfFailLenCheck(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithFirstOfLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -536,6 +573,7 @@ static void BM_StrVFindWithFirstOfLong(benchmark::State& state) {
 }
 
 static void BM_StrVFindWithFirstOfLongLenCheck(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -594,6 +632,7 @@ static const char* token_nomatchlonger_c =
     "this_is_a_longer_string_that_doesnt_match";
 
 static void BM_StrCFindWithCompareN(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -606,6 +645,7 @@ static void BM_StrCFindWithCompareN(benchmark::State& state) {
 }
 
 static void BM_StrCFindWithCompareNFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -618,6 +658,7 @@ static void BM_StrCFindWithCompareNFail(benchmark::State& state) {
 }
 
 static void BM_StrCFindWithCompareNLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -630,6 +671,7 @@ static void BM_StrCFindWithCompareNLong(benchmark::State& state) {
 }
 
 static void BM_StrCFindWithCompare(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -642,6 +684,7 @@ static void BM_StrCFindWithCompare(benchmark::State& state) {
 }
 
 static void BM_StrCFindWithCompareFail(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
@@ -654,6 +697,7 @@ static void BM_StrCFindWithCompareFail(benchmark::State& state) {
 }
 
 static void BM_StrCFindWithCompareLong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   // Perform setup here
   for (auto _ : state) {
     // This code gets timed
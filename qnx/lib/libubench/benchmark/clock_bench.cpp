@@ -0,0 +1,86 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "ubench/clock.h"
+
+// NOLINTBEGIN
+
+/// @brief The idle clock, as sampled while measuring a benchmark.
+static void BM_IdleClock_now(benchmark::State& state) {
+  for (auto _ : state) {
+    auto now = ubench::chrono::idle_clock::now();
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+/// @brief The CPU time of the process.
+static void BM_ProcessClock_now(benchmark::State& state) {
+  for (auto _ : state) {
+    auto now = ubench::chrono::process_clock::now();
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+/// @brief The steady clock, for reference.
+static void BM_SteadyClock_now(benchmark::State& state) {
+  for (auto _ : state) {
+    auto now = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+#if defined(__linux__)
+/// @brief The idle time read from /proc/stat with a std::ifstream, as the
+/// idle clock did before it used pread().
+///
+/// The line is read with std::getline(), split with a std::istringstream,
+/// converted with std::stoull(), then the stream is rewound.
+static void BM_ProcStat_ifstream(benchmark::State& state) {
+  std::ifstream cpu_stats{"/proc/stat"};
+  if (!cpu_stats) {
+    state.SkipWithError("Couldn't open /proc/stat");
+    return;
+  }
+  cpu_stats.imbue(std::locale::classic());
+  long ticks = sysconf(_SC_CLK_TCK);
+
+  for (auto _ : state) {
+    std::uint64_t idle_ns = 0;
+    std::string line;
+    if (std::getline(cpu_stats, line)) {
+      std::istringstream iss(line);
+      std::string token;
+      int i = 0;
+      while (iss >> token) {
+        if (i == 4) {
+          idle_ns = 1000000000 / ticks * std::stoull(token);
+          break;
+        }
+        i++;
+      }
+    }
+    cpu_stats.clear();
+    cpu_stats.seekg(0);
+    benchmark::DoNotOptimize(idle_ns);
+  }
+}
+
+BENCHMARK(BM_ProcStat_ifstream);
+#endif
+
+BENCHMARK(BM_IdleClock_now);
+BENCHMARK(BM_ProcessClock_now);
+BENCHMARK(BM_SteadyClock_now);
+
+// Run the benchmark
+BENCHMARK_MAIN();
+
+// NOLINTEND
@@ -0,0 +1,107 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ubench/str_hash.h"
+
+// The number of words of each length, per 1000 words, of English text split on
+// whitespace (so punctuation is part of the word). This approximates the
+// Project Gutenberg corpus used by the str_intern benchmark, where most words
+// are shorter than 8 bytes, and few are longer than 16.
+static constexpr std::array<unsigned int, 20> word_lengths = {
+    0, 30, 160, 200, 160, 110, 85, 75, 55, 40,  // 0..9
+    30, 20, 12, 8, 5, 4, 2, 2, 1, 1};           // 10..19
+
+/// @brief Make a list of words with the length distribution above.
+///
+/// The seed is fixed, so that every run hashes the same words.
+static auto make_words() -> std::vector<std::string> {
+  std::vector<unsigned int> weights(word_lengths.begin(), word_lengths.end());
+  std::discrete_distribution<std::size_t> length(
+      weights.begin(), weights.end());
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::mt19937 gen{42};
+
+  std::vector<std::string> words{};
+  for (int i = 0; i < 4096; i++) {
+    std::string word(length(gen), '\0');
+    for (auto& c : word) {
+      c = static_cast<char>(letter(gen));
+    }
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+static const std::vector<std::string> words = make_words();
+
+struct std_hasher {
+  auto operator()(std::string_view str) const noexcept -> std::size_t {
+    return std::hash<std::string_view>{}(str);
+  }
+};
+
+// NOLINTBEGIN
+
+/// @brief Hash a single string of the length given by the argument.
+template <typename H>
+static void BM_Hash_length(benchmark::State& state) {
+  std::string str(static_cast<std::size_t>(state.range(0)), 'x');
+  H hash{};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str);
+    auto result = hash(str);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Hash words of different lengths, one after the other.
+///
+/// The length of the next word isn't known, so branches on the length are
+/// mispredicted as they would be when interning a file.
+template <typename H>
+static void BM_Hash_words(benchmark::State& state) {
+  H hash{};
+  std::size_t bytes = 0;
+  for (const auto& word : words) {
+    bytes += word.size();
+  }
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      auto result = hash(word);
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * words.size());
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+using ubench::string::fast_hash;
+using ubench::string::simd_hash;
+
+BENCHMARK_TEMPLATE(BM_Hash_length, std_hasher)
+    ->RangeMultiplier(2)
+    ->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Hash_length, fast_hash)
+    ->RangeMultiplier(2)
+    ->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Hash_length, simd_hash)
+    ->RangeMultiplier(2)
+    ->Range(4, 256);
+BENCHMARK_TEMPLATE(BM_Hash_words, std_hasher);
+BENCHMARK_TEMPLATE(BM_Hash_words, fast_hash);
+BENCHMARK_TEMPLATE(BM_Hash_words, simd_hash);
+
+// Run the benchmark
+BENCHMARK_MAIN();
+
+// NOLINTEND
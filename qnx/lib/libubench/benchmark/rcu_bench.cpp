@@ -1,98 +1,488 @@
-#include <charconv>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <cstring>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
 #include <string_view>
 #include <thread>
 #include <vector>
 
 #include "ubench/atomics.h"
+#include "ubench/measure/latency_histogram.h"
+#include "ubench/measure/print.h"
+#include "ubench/measure/sampler.h"
 #include "ubench/options.h"
+#include "ubench/string.h"
 #include "ubench/thread.h"
 
-using namespace std::chrono_literals;
+namespace {
+
+using ubench::measure::latency_histogram;
 
 auto print_help(std::string_view prog_name) -> void {
-  std::cout << "USAGE: " << prog_name << " [-p <threads>]" << std::endl;
+  std::cout << "USAGE: " << prog_name
+            << " [-p <readers>] [-u <updates>] [-m <modes>] [-d <seconds>] "
+               "[-S <every>] [-t <ms>] [-n] [-j]"
+            << std::endl;
   std::cout << std::endl;
-  std::cout << "Execute RCU stress test for [-p] threads on the system"
+  std::cout << "Measure reads of a shared object, while one thread updates it "
+               "at a fixed rate."
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << " -p <readers>  - The number of reader threads, or a list "
+               "separated by commas."
+            << std::endl;
+  std::cout << "                 Default is powers of 2 up to one less than "
+               "all hardware threads,"
+            << std::endl;
+  std::cout << "                 or two less with -t." << std::endl;
+  std::cout << " -u <updates>  - The updates per second, or a list separated "
+               "by commas. 0 is no"
+            << std::endl;
+  std::cout << "                 updates. Default is 10,1000." << std::endl;
+  std::cout << " -m <modes>    - The modes to test, separated by commas. "
+               "Default is all."
+            << std::endl;
+  std::cout << "                 refcount: rcu with a shared reference count "
+               "for each slot"
+            << std::endl;
+  std::cout << "                 epoch: rcu_epoch with a per-thread epoch"
+            << std::endl;
+  std::cout << "                 sharded: rcu_sharded with a reference count "
+               "for each slot in"
+            << std::endl;
+  std::cout << "                   each thread" << std::endl;
+  std::cout << "                 deferred: rcu_epoch with frees deferred to a "
+               "rcu_reclaimer"
+            << std::endl;
+  std::cout << "                 shared_mutex: a copy under a "
+               "std::shared_mutex"
+            << std::endl;
+  std::cout << "                 shared_ptr: std::atomic_load of a "
+               "std::shared_ptr"
+            << std::endl;
+  std::cout << "                 seqlock: a copy under a sequence lock"
+            << std::endl;
+  std::cout << " -d <seconds>  - The time to run each test. Default is 2."
+            << std::endl;
+  std::cout << " -S <every>    - Time one read out of every N. Default is 100."
+            << std::endl;
+  std::cout << " -t <ms>       - Sample the CPU load every period, and print "
+               "the timeline."
             << std::endl;
+  std::cout << " -n            - Don't pin the threads to cores." << std::endl;
+  std::cout << " -j            - Print the results as JSON." << std::endl;
 }
 
-auto run_stress(unsigned int threads) {
-  std::cout << "Running with " << threads << " threads" << std::endl;
+/// @brief The object shared by the readers and the updater.
+///
+/// The second field is always the inverse of the first, so that a reader can
+/// check that it didn't see half of an update.
+struct payload {
+  std::uint64_t value{};
+  std::uint64_t inverse{~std::uint64_t{0}};
 
-  std::unique_ptr data(std::make_unique<int>(42));
-  rcu rcu(std::move(data));
+  [[nodiscard]] static auto make(std::uint64_t v) -> payload {
+    return payload{v, ~v};
+  }
+
+  [[nodiscard]] auto valid() const -> bool { return inverse == ~value; }
+};
+
+/// @brief A mode using one of the rcu classes.
+///
+/// @tparam R the rcu class, with read() and update().
+template <typename R>
+class rcu_mode {
+ public:
+  rcu_mode() : rcu_{std::make_unique<payload>()} {}
+
+  [[nodiscard]] auto read() -> payload {
+    auto ptr = rcu_.read();
+    return *ptr;
+  }
+
+  auto update(const payload& p) -> bool {
+    return rcu_.update(std::make_unique<payload>(p));
+  }
+
+  [[nodiscard]] auto max_deferred_bytes() const -> std::optional<std::size_t> {
+    return std::nullopt;
+  }
+
+ private:
+  R rcu_;
+};
+
+/// @brief A mode using rcu_epoch, with the frees deferred to a reclaimer
+/// thread.
+class deferred_mode {
+ public:
+  deferred_mode() : rcu_{std::make_unique<payload>(), reclaimer_} {}
+
+  [[nodiscard]] auto read() -> payload {
+    auto ptr = rcu_.read();
+    return *ptr;
+  }
+
+  auto update(const payload& p) -> bool {
+    return rcu_.update(std::make_unique<payload>(p));
+  }
+
+  [[nodiscard]] auto max_deferred_bytes() const -> std::optional<std::size_t> {
+    return reclaimer_.stats().max_pending_bytes;
+  }
 
+ private:
+  rcu_reclaimer reclaimer_{};
+  rcu_epoch<payload> rcu_;
+};
+
+/// @brief The baseline of a copy protected by a readers-writer lock.
+class shared_mutex_mode {
+ public:
+  [[nodiscard]] auto read() -> payload {
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+    return data_;
+  }
+
+  auto update(const payload& p) -> bool {
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+    data_ = p;
+    return true;
+  }
+
+  [[nodiscard]] auto max_deferred_bytes() const -> std::optional<std::size_t> {
+    return std::nullopt;
+  }
+
+ private:
+  std::shared_mutex mutex_{};
+  payload data_{};
+};
+
+/// @brief The baseline of a std::shared_ptr loaded and stored atomically.
+///
+/// This uses the atomic functions for std::shared_ptr, as
+/// std::atomic<std::shared_ptr> needs C++20.
+class shared_ptr_mode {
+ public:
+  [[nodiscard]] auto read() -> payload {
+    std::shared_ptr<const payload> ptr = std::atomic_load(&data_);
+    return *ptr;
+  }
+
+  auto update(const payload& p) -> bool {
+    std::atomic_store(&data_, std::make_shared<const payload>(p));
+    return true;
+  }
+
+  [[nodiscard]] auto max_deferred_bytes() const -> std::optional<std::size_t> {
+    return std::nullopt;
+  }
+
+ private:
+  std::shared_ptr<const payload> data_{std::make_shared<const payload>()};
+};
+
+/// @brief A copy protected by a sequence lock.
+class seqlock_mode {
+ public:
+  [[nodiscard]] auto read() -> payload { return data_.load(); }
+
+  auto update(const payload& p) -> bool {
+    data_.store(p);
+    return true;
+  }
+
+  [[nodiscard]] auto max_deferred_bytes() const -> std::optional<std::size_t> {
+    return std::nullopt;
+  }
+
+ private:
+  seqlock<payload> data_{};
+};
+
+/// @brief The parameters of one test.
+struct test_config {
+  unsigned int readers{};
+  unsigned int update_rate{};  //< Updates per second, or 0 for none.
+  std::chrono::seconds duration{};
+  unsigned int sample_every{};
+  bool pin{};
+  std::atomic<std::uint64_t>* updates{};  //< Incremented by each update.
+};
+
+/// @brief The counts of a reader, in a cache line of its own.
+struct alignas(64) reader_result {
+  std::uint64_t reads{};
+  std::uint64_t torn{};
+  latency_histogram latency{};
+};
+
+/// @brief The results of one test.
+struct result {
+  std::uint64_t reads{};
+  std::uint64_t torn{};
+  latency_histogram read_latency{};
+  std::uint64_t updates{};
+  std::uint64_t update_fails{};
+  latency_histogram update_latency{};
+  std::optional<std::size_t> max_deferred_bytes{};
+  std::chrono::duration<double> elapsed{};
+  bool pinned{true};
+};
+
+/// @brief Pin the calling thread to a core, if asked to.
+///
+/// @return the pinned core, which must be destroyed on the same thread.
+auto pin_thread(bool pin, unsigned int core, std::atomic<bool>& pinned)
+    -> std::optional<ubench::thread::pin_core> {
+  if (!pin) return std::nullopt;
+  std::optional<ubench::thread::pin_core> p{
+      std::in_place, core % ubench::thread::thread_count()};
+  if (!*p) pinned.store(false, std::memory_order_relaxed);
+  return p;
+}
+
+/// @brief Run readers and an updater on a mode.
+///
+/// Each thread counts in its own memory, so that the counting doesn't add
+/// contention between the readers. Reader t is pinned to core t, and the
+/// updater to the core after the last reader.
+///
+/// @tparam Mode the object tested, with read() and update().
+template <typename Mode>
+auto run_test(const test_config& config) -> result {
+  Mode mode{};
+  std::atomic<bool> start{false};
   std::atomic<bool> terminate{false};
-  std::atomic<std::uint32_t> counter{0};
-  std::atomic<std::uint32_t> updates{0};
-
-  std::thread thread_update([&]() -> void {
-    while (!terminate.load()) {
-      std::this_thread::sleep_for(10ms);
-      std::unique_ptr new_data(std::make_unique<int>(24));
-      bool r = rcu.update(std::move(new_data));
-      if (!r) {
-        std::cout << "Error updating" << std::endl;
-        std::abort();
+  std::atomic<unsigned int> ready{0};
+  std::atomic<bool> pinned{true};
+
+  std::vector<reader_result> readers(config.readers);
+  std::vector<std::thread> threads{};
+  for (unsigned int t = 0; t < config.readers; t++) {
+    threads.emplace_back([&, t]() {
+      auto core = pin_thread(config.pin, t, pinned);
+      reader_result local{};
+      unsigned int countdown = config.sample_every;
+      ready++;
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
       }
-      updates++;
-    }
-  });
 
-  std::vector<std::thread> reads;
-  for (unsigned int t = 0; t < threads; t++) {
-    reads.emplace_back([&]() -> void {
-      while (!terminate.load()) {
-        rcu_ptr ptr = rcu.read();
-        counter++;
+      while (!terminate.load(std::memory_order_relaxed)) {
+        payload p{};
+        if (--countdown == 0) {
+          countdown = config.sample_every;
+          auto t0 = std::chrono::steady_clock::now();
+          p = mode.read();
+          local.latency.record(std::chrono::steady_clock::now() - t0);
+        } else {
+          p = mode.read();
+        }
+        if (!p.valid()) local.torn++;
+        local.reads++;
       }
+      readers[t] = local;
     });
   }
 
-  std::this_thread::sleep_for(std::chrono::seconds(30));
+  result res{};
+  std::thread updater([&]() {
+    auto core = pin_thread(config.pin, config.readers, pinned);
+    ready++;
+    while (!start.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+    if (config.update_rate == 0) return;
+
+    // Updates are at fixed times, so that a slow update doesn't lower the
+    // rate, unless it is longer than the period.
+    std::chrono::nanoseconds period = std::chrono::seconds{1};
+    period /= config.update_rate;
+    auto next = std::chrono::steady_clock::now();
+    std::uint64_t value = 0;
+    while (!terminate.load(std::memory_order_relaxed)) {
+      next += period;
+      std::this_thread::sleep_until(next);
+      auto t0 = std::chrono::steady_clock::now();
+      bool updated = mode.update(payload::make(++value));
+      res.update_latency.record(std::chrono::steady_clock::now() - t0);
+      if (updated) {
+        res.updates++;
+        config.updates->fetch_add(1, std::memory_order_relaxed);
+      } else {
+        res.update_fails++;
+      }
+    }
+  });
+
+  while (ready.load() != config.readers + 1) {
+    std::this_thread::yield();
+  }
+  auto t_start = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(config.duration);
   terminate.store(true);
-  thread_update.join();
-  for (std::thread& r : reads) {
-    r.join();
+  updater.join();
+  for (auto& t : threads) {
+    t.join();
   }
+  res.elapsed = std::chrono::steady_clock::now() - t_start;
 
-  std::cout << " Updates: " << updates << std::endl;
-  std::cout << " Reads: " << counter << std::endl;
-  std::cout << " Reads/core/sec: " << counter / threads / 30 << std::endl;
+  for (const auto& r : readers) {
+    res.reads += r.reads;
+    res.torn += r.torn;
+    res.read_latency.merge(r.latency);
+  }
+  res.max_deferred_bytes = mode.max_deferred_bytes();
+  res.pinned = pinned.load();
+  return res;
+}
+
+/// @brief The modes that can be tested, in the order they are run.
+constexpr std::array<std::string_view, 7> modes = {"refcount", "epoch",
+    "sharded", "deferred", "shared_mutex", "shared_ptr", "seqlock"};
+
+auto run_mode(std::string_view name, const test_config& config) -> result {
+  if (name == "refcount") return run_test<rcu_mode<rcu<payload>>>(config);
+  if (name == "epoch") return run_test<rcu_mode<rcu_epoch<payload>>>(config);
+  if (name == "sharded") {
+    return run_test<rcu_mode<rcu_sharded<payload>>>(config);
+  }
+  if (name == "deferred") return run_test<deferred_mode>(config);
+  if (name == "shared_mutex") return run_test<shared_mutex_mode>(config);
+  if (name == "shared_ptr") return run_test<shared_ptr_mode>(config);
+  return run_test<seqlock_mode>(config);
 }
 
+auto per_second(std::uint64_t count, std::chrono::duration<double> elapsed)
+    -> std::string {
+  return std::to_string(
+      static_cast<std::uint64_t>(static_cast<double>(count) / elapsed.count()));
+}
+
+auto ns(std::chrono::nanoseconds latency) -> std::string {
+  return std::to_string(latency.count());
+}
+
+}  // namespace
+
 auto main(int argc, char* argv[]) -> int {
-  unsigned int threads = 0;
+  std::vector<unsigned int> readers{};
+  std::vector<unsigned int> update_rates{10, 1000};
+  std::vector<std::string_view> run_modes{};
+  test_config config{};
+  config.duration = std::chrono::seconds{2};
+  config.sample_every = 100;
+  config.pin = true;
+  std::chrono::milliseconds sample_period{0};
+  bool json = false;
   bool help = false;
   int exit_code = 0;
 
-  ubench::options opts{argc, argv, "p:?"};
+  ubench::options opts{argc, argv, "p:u:m:d:S:t:nj?"};
   for (const auto& opt : opts) {
     if (opt) {
       switch (opt->get_option()) {
         case 'p': {
           // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-          std::string thread_string{*opt->argument()};
-          auto [ptr, ec] = std::from_chars(thread_string.data(),
-              // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-              thread_string.data() + thread_string.size(), threads);
-          if (ec == std::errc()) {
-            if (threads < 1 || threads > ubench::thread::thread_count()) {
+          auto arg = *opt->argument();
+          readers = ubench::string::split_args_int<unsigned int>(arg);
+          if (readers.empty() ||
+              std::any_of(readers.begin(), readers.end(), [](unsigned int r) {
+                return r < 1 || r > ubench::thread::thread_count();
+              })) {
+            exit_code = 1;
+            std::cerr << "Error: Specify a minimum of 1 reader and not more "
+                         "than "
+                      << ubench::thread::thread_count() << " readers"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'u': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          update_rates = ubench::string::split_args_int<unsigned int>(arg);
+          if (update_rates.empty() ||
+              std::any_of(update_rates.begin(), update_rates.end(),
+                  [](unsigned int u) { return u > 1000000; })) {
+            exit_code = 1;
+            std::cerr << "Error: Specify updates per second from 0 to 1000000"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'm': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          for (auto field : ubench::string::split_args(arg)) {
+            if (field == "all") {
+              run_modes.insert(run_modes.end(), modes.begin(), modes.end());
+              continue;
+            }
+            auto it = std::find(modes.begin(), modes.end(), field);
+            if (it != modes.end()) {
+              run_modes.push_back(*it);
+            } else {
               exit_code = 1;
-              std::cerr
-                  << "Error: Specify a minimum of 1 thread and not more than "
-                  << ubench::thread::thread_count() << " threads" << std::endl;
+              std::cerr << "Error: Unknown mode " << field << std::endl;
             }
+          }
+          break;
+        }
+        case 'd': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = ubench::string::parse_int<unsigned int>(*opt->argument());
+          if (arg && *arg >= 1) {
+            config.duration = std::chrono::seconds{*arg};
           } else {
             exit_code = 1;
-            std::cerr << "Error: Specify a thread count as a number"
+            std::cerr << "Error: Specify a duration of 1 second or more"
                       << std::endl;
           }
           break;
         }
+        case 'S': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = ubench::string::parse_int<unsigned int>(*opt->argument());
+          if (arg && *arg >= 1) {
+            config.sample_every = *arg;
+          } else {
+            exit_code = 1;
+            std::cerr << "Error: Specify a sample rate of 1 or more"
+                      << std::endl;
+          }
+          break;
+        }
+        case 't': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = ubench::string::parse_int<unsigned int>(*opt->argument());
+          if (arg && *arg >= 1) {
+            sample_period = std::chrono::milliseconds{*arg};
+          } else {
+            exit_code = 1;
+            std::cerr << "Error: Specify a sample period of 1ms or more"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'n':
+          config.pin = false;
+          break;
+        case 'j':
+          json = true;
+          break;
         case '?':
           help = true;
           break;
@@ -113,10 +503,124 @@ auto main(int argc, char* argv[]) -> int {
     return exit_code;
   }
 
-  if (threads == 0) {
-    threads = ubench::thread::thread_count();
+  // Leave one core for the updater, and one for the sampler which is pinned to
+  // the last core.
+  unsigned int spare_cores = sample_period.count() > 0 ? 2 : 1;
+  if (readers.empty()) {
+    unsigned int cores = ubench::thread::thread_count();
+    unsigned int max_readers = cores > spare_cores ? cores - spare_cores : 1U;
+    for (unsigned int r = 1; r < max_readers; r *= 2) {
+      readers.push_back(r);
+    }
+    readers.push_back(max_readers);
+  }
+  if (config.pin && sample_period.count() > 0 &&
+      *std::max_element(readers.begin(), readers.end()) + spare_cores >
+          ubench::thread::thread_count()) {
+    std::cerr << "Warning: The sampler shares the last core with a reader or "
+                 "the updater"
+              << std::endl;
   }
+  if (run_modes.empty()) {
+    run_modes.assign(modes.begin(), modes.end());
+  }
+
+  ubench::measure::table table{};
+  table.add_column("Mode");
+  table.add_column("Readers", ubench::measure::alignment::right);
+  table.add_column("Updates/sec", ubench::measure::alignment::right);
+  table.add_column("Reads/sec", ubench::measure::alignment::right);
+  table.add_column("Reads/thread/sec", ubench::measure::alignment::right);
+  table.add_column("Read p50 ns", ubench::measure::alignment::right);
+  table.add_column("Read p99 ns", ubench::measure::alignment::right);
+  table.add_column("Read p99.9 ns", ubench::measure::alignment::right);
+  table.add_column("Read max ns", ubench::measure::alignment::right);
+  table.add_column("Updates", ubench::measure::alignment::right);
+  table.add_column("Update fails", ubench::measure::alignment::right);
+  table.add_column("Update p99 ns", ubench::measure::alignment::right);
+  table.add_column("Update max ns", ubench::measure::alignment::right);
+  table.add_column("Deferred max bytes", ubench::measure::alignment::right);
 
-  run_stress(threads);
-  return exit_code;
+  // One sampler covers all tests, so that the load between them is seen too.
+  // The start of each test is given, to find it in the timeline.
+  std::atomic<std::uint64_t> updates{0};
+  config.updates = &updates;
+  std::optional<ubench::measure::sampler> sampler{};
+  if (sample_period.count() > 0) {
+    table.add_column("Start ms", ubench::measure::alignment::right);
+    auto tests = run_modes.size() * update_rates.size() * readers.size();
+    auto samples = tests * (config.duration + std::chrono::seconds{1}) /
+                   sample_period;
+    std::optional<unsigned int> core{};
+    if (config.pin) core = ubench::thread::thread_count() - 1;
+    sampler.emplace(sample_period, samples, core);
+    sampler->add_counter("Updates", updates);
+    sampler->start();
+  }
+
+  bool pinned = true;
+  for (auto name : run_modes) {
+    for (auto u : update_rates) {
+      for (auto r : readers) {
+        config.readers = r;
+        config.update_rate = u;
+        auto start_ms = sampler
+            ? std::chrono::duration_cast<std::chrono::milliseconds>(
+                  sampler->elapsed())
+            : std::chrono::milliseconds{0};
+        result res = run_mode(name, config);
+        if (res.torn != 0) {
+          std::cerr << "Error: " << name << " read " << res.torn
+                    << " torn objects" << std::endl;
+        }
+        pinned = pinned && res.pinned;
+
+        std::vector<std::string> line{std::string{name}, std::to_string(r),
+            std::to_string(u), per_second(res.reads, res.elapsed),
+            per_second(res.reads / r, res.elapsed),
+            ns(res.read_latency.percentile(50.0)),
+            ns(res.read_latency.percentile(99.0)),
+            ns(res.read_latency.percentile(99.9)), ns(res.read_latency.max()),
+            std::to_string(res.updates), std::to_string(res.update_fails),
+            ns(res.update_latency.percentile(99.0)),
+            ns(res.update_latency.max()),
+            res.max_deferred_bytes ? std::to_string(*res.max_deferred_bytes)
+                                   : "-"};
+        if (sampler) line.push_back(std::to_string(start_ms.count()));
+        table.add_line(std::move(line));
+      }
+    }
+  }
+  if (sampler) {
+    sampler->stop();
+    pinned = pinned && sampler->pinned();
+    if (sampler->overwritten() > 0) {
+      std::cerr << "Warning: The first " << sampler->overwritten()
+                << " samples were overwritten" << std::endl;
+    }
+  }
+  if (!pinned) {
+    std::cerr << "Warning: Some threads couldn't be pinned to a core"
+              << std::endl;
+  }
+
+  if (json) {
+    if (sampler) {
+      std::cout << "{\"results\": ";
+      table.write_json(std::cout);
+      std::cout << ",\n\"timeline\": ";
+      sampler->make_table().write_json(std::cout);
+      std::cout << "}";
+    } else {
+      table.write_json(std::cout);
+    }
+  } else {
+    std::cout << table;
+    if (sampler) {
+      std::cout << std::endl << std::endl << "Timeline:" << std::endl;
+      std::cout << sampler->make_table();
+    }
+  }
+  std::cout << std::endl;
+  return 0;
 }
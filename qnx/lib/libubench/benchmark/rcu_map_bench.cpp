@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ubench/atomics.h"
+#include "ubench/measure/print.h"
+#include "ubench/options.h"
+#include "ubench/string.h"
+#include "ubench/thread.h"
+
+namespace {
+
+auto print_help(std::string_view prog_name) -> void {
+  std::cout << "USAGE: " << prog_name
+            << " [-p <threads>] [-k <keys>] [-r <reads>:<writes>] "
+               "[-d <seconds>] [-m <map>]"
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "Compare rcu_map to a std::unordered_map with a "
+               "std::shared_mutex, with threads"
+            << std::endl;
+  std::cout << "that look up and assign random keys." << std::endl;
+  std::cout << std::endl;
+  std::cout << " -p <threads>  - The number of threads. Default is all "
+               "hardware threads."
+            << std::endl;
+  std::cout << " -k <keys>     - The number of keys, or a list separated by "
+               "commas. Default"
+            << std::endl;
+  std::cout << "                 is 1000." << std::endl;
+  std::cout << " -r <ratio>    - The ratio of lookups to assignments, or a "
+               "list separated by"
+            << std::endl;
+  std::cout << "                 commas. Default is 99:1,99.9:0.1."
+            << std::endl;
+  std::cout << " -d <seconds>  - The time to run each test. Default is 2."
+            << std::endl;
+  std::cout << " -m <map>      - rcu, mutex or all (default)." << std::endl;
+}
+
+/// @brief A ratio of reads to writes.
+struct ratio {
+  std::string name;           //< The ratio as given by the user.
+  std::uint64_t write_ppm{};  //< The writes per million operations.
+};
+
+/// @brief Parse a ratio of reads to writes, such as 99:1 or 99.9:0.1.
+auto parse_ratio(std::string_view arg) -> std::optional<ratio> {
+  auto colon = arg.find(':');
+  if (colon == std::string_view::npos) return std::nullopt;
+
+  std::string reads_s{arg.substr(0, colon)};
+  std::string writes_s{arg.substr(colon + 1)};
+  char* reads_end = nullptr;
+  char* writes_end = nullptr;
+  double reads = std::strtod(reads_s.c_str(), &reads_end);
+  double writes = std::strtod(writes_s.c_str(), &writes_end);
+  if (reads_s.empty() || writes_s.empty() || *reads_end != '\0' ||
+      *writes_end != '\0' || !std::isfinite(reads) || !std::isfinite(writes) ||
+      reads < 0 || writes < 0 || reads + writes <= 0) {
+    return std::nullopt;
+  }
+  return ratio{std::string{arg}, static_cast<std::uint64_t>(std::llround(
+                                     writes / (reads + writes) * 1000000.0))};
+}
+
+/// @brief The map protected by a readers-writer lock, to compare against.
+class shared_mutex_map {
+ public:
+  [[nodiscard]] auto get(std::uint64_t key) const
+      -> std::optional<std::uint64_t> {
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+    auto it = map_.find(key);
+    if (it == map_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  auto insert_or_assign(std::uint64_t key, std::uint64_t value) -> bool {
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+    return map_.insert_or_assign(key, value).second;
+  }
+
+ private:
+  mutable std::shared_mutex mutex_{};
+  std::unordered_map<std::uint64_t, std::uint64_t> map_{};
+};
+
+/// @brief The operations counted by a thread, in a cache line of its own.
+struct alignas(64) thread_ops {
+  std::uint64_t reads{};
+  std::uint64_t writes{};
+  std::uint64_t misses{};
+};
+
+/// @brief The results of one test.
+struct result {
+  std::uint64_t reads{};
+  std::uint64_t writes{};
+  std::uint64_t misses{};
+  std::chrono::duration<double> elapsed{};
+};
+
+/// @brief Run a mix of lookups and assignments on all threads.
+///
+/// @tparam Map the map, with get() and insert_or_assign().
+template <typename Map>
+auto run_test(unsigned int threads, std::uint64_t keys, const ratio& r,
+    std::chrono::seconds duration) -> result {
+  Map map{};
+  for (std::uint64_t k = 0; k < keys; k++) {
+    map.insert_or_assign(k, k);
+  }
+
+  std::atomic<bool> terminate{false};
+  std::vector<thread_ops> ops(threads);
+  std::vector<std::thread> workers{};
+  for (unsigned int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      // Xorshift, seeded differently for each thread.
+      std::uint64_t x = 0x9e3779b97f4a7c15ULL * (t + 1);
+      thread_ops local{};
+      while (!terminate.load(std::memory_order_relaxed)) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        std::uint64_t key = (x >> 20) % keys;
+        if (x % 1000000 < r.write_ppm) {
+          map.insert_or_assign(key, x);
+          local.writes++;
+        } else {
+          if (!map.get(key)) local.misses++;
+          local.reads++;
+        }
+      }
+      ops[t] = local;
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(duration);
+  terminate.store(true);
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  result res{};
+  res.elapsed = std::chrono::steady_clock::now() - start;
+  for (const auto& o : ops) {
+    res.reads += o.reads;
+    res.writes += o.writes;
+    res.misses += o.misses;
+  }
+  return res;
+}
+
+auto per_second(std::uint64_t count, std::chrono::duration<double> elapsed)
+    -> std::string {
+  return std::to_string(
+      static_cast<std::uint64_t>(static_cast<double>(count) / elapsed.count()));
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  unsigned int threads = 0;
+  std::vector<std::uint64_t> keys{1000};
+  std::vector<ratio> ratios{};
+  std::chrono::seconds duration{2};
+  bool run_rcu = true;
+  bool run_mutex = true;
+  bool help = false;
+  int exit_code = 0;
+
+  ubench::options opts{argc, argv, "p:k:r:d:m:?"};
+  for (const auto& opt : opts) {
+    if (opt) {
+      switch (opt->get_option()) {
+        case 'p': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = ubench::string::parse_int<unsigned int>(*opt->argument());
+          if (arg && *arg >= 1 && *arg <= ubench::thread::thread_count()) {
+            threads = *arg;
+          } else {
+            exit_code = 1;
+            std::cerr << "Error: Specify a minimum of 1 thread and not more "
+                         "than "
+                      << ubench::thread::thread_count() << " threads"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'k': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          keys = ubench::string::split_args_int<std::uint64_t>(arg);
+          if (keys.empty() ||
+              std::find(keys.begin(), keys.end(), 0) != keys.end()) {
+            exit_code = 1;
+            std::cerr << "Error: Specify one or more keys" << std::endl;
+          }
+          break;
+        }
+        case 'r': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          for (auto field : ubench::string::split_args(arg)) {
+            auto r = parse_ratio(field);
+            if (r) {
+              ratios.push_back(*r);
+            } else {
+              exit_code = 1;
+              std::cerr << "Error: Specify a ratio as <reads>:<writes>"
+                        << std::endl;
+            }
+          }
+          break;
+        }
+        case 'd': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = ubench::string::parse_int<unsigned int>(*opt->argument());
+          if (arg && *arg >= 1) {
+            duration = std::chrono::seconds{*arg};
+          } else {
+            exit_code = 1;
+            std::cerr << "Error: Specify a duration of 1 second or more"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'm': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          run_rcu = arg == "rcu" || arg == "all";
+          run_mutex = arg == "mutex" || arg == "all";
+          if (!run_rcu && !run_mutex) {
+            exit_code = 1;
+            std::cerr << "Error: Specify a map of rcu, mutex or all"
+                      << std::endl;
+          }
+          break;
+        }
+        case '?':
+          help = true;
+          break;
+        default:
+          exit_code = 1;
+          ubench::options::print_error(opt->get_option());
+          break;
+      }
+    } else {
+      exit_code = 1;
+      ubench::options::print_error(opt.error());
+    }
+  }
+
+  if (exit_code || help) {
+    if (exit_code) std::cerr << std::endl;
+    print_help(opts.prog_name());
+    return exit_code;
+  }
+
+  if (threads == 0) threads = ubench::thread::thread_count();
+  if (ratios.empty()) {
+    // NOLINTBEGIN(bugprone-unchecked-optional-access)
+    ratios.push_back(*parse_ratio("99:1"));
+    ratios.push_back(*parse_ratio("99.9:0.1"));
+    // NOLINTEND(bugprone-unchecked-optional-access)
+  }
+
+  ubench::measure::table table{};
+  table.add_column("Map");
+  table.add_column("Keys", ubench::measure::alignment::right);
+  table.add_column("Reads:Writes", ubench::measure::alignment::right);
+  table.add_column("Threads", ubench::measure::alignment::right);
+  table.add_column("Reads/sec", ubench::measure::alignment::right);
+  table.add_column("Writes/sec", ubench::measure::alignment::right);
+  table.add_column("Reads/thread/sec", ubench::measure::alignment::right);
+
+  auto add_result = [&](const std::string& name, std::uint64_t k,
+                        const ratio& r, const result& res) {
+    if (res.misses != 0) {
+      std::cerr << "Error: " << name << " missed " << res.misses << " keys"
+                << std::endl;
+    }
+    table.add_line({name, std::to_string(k), r.name, std::to_string(threads),
+        per_second(res.reads, res.elapsed),
+        per_second(res.writes, res.elapsed),
+        per_second(res.reads / threads, res.elapsed)});
+  };
+
+  for (auto k : keys) {
+    for (const auto& r : ratios) {
+      if (run_rcu) {
+        add_result("rcu_map", k, r,
+            run_test<rcu_map<std::uint64_t, std::uint64_t>>(
+                threads, k, r, duration));
+      }
+      if (run_mutex) {
+        add_result("shared_mutex", k, r,
+            run_test<shared_mutex_map>(threads, k, r, duration));
+      }
+    }
+  }
+  std::cout << table;
+  return 0;
+}
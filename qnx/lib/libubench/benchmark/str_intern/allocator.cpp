@@ -1,5 +1,6 @@
 #include "allocator.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
@@ -8,9 +9,19 @@
 
 namespace {
 
-// Maintain the memory allocation metrics.
+// Maintain the memory allocation metrics. These are atomic, as the benchmark
+// may intern from multiple threads at the same time.
+struct atomic_mem_metrics {
+  std::atomic<std::uint64_t> total_alloc{};
+  std::atomic<std::uint64_t> total_free{};
+  std::atomic<std::uint64_t> max_alloc{};
+  std::atomic<std::int64_t> current_alloc{};
+  std::atomic<std::uint64_t> allocs{};
+  std::atomic<std::uint64_t> frees{};
+};
+
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-mem_metrics metrics_{};
+atomic_mem_metrics metrics_{};
 
 struct mem_block {
   mem_block(std::size_t size) : block{size} {}
@@ -18,32 +29,52 @@ struct mem_block {
   std::size_t block;
 };
 
-auto alloc(mem_metrics &metrics, std::size_t size) -> void {
-  ++metrics.allocs;
-  metrics.total_alloc += size;
-  metrics.current_alloc += static_cast<std::int64_t>(size);
-  if (metrics.current_alloc > 0 &&
-      static_cast<std::uint64_t>(metrics.current_alloc) > metrics.max_alloc)
-    metrics.max_alloc = metrics.current_alloc;
+auto alloc(atomic_mem_metrics &metrics, std::size_t size) -> void {
+  metrics.allocs.fetch_add(1, std::memory_order_relaxed);
+  metrics.total_alloc.fetch_add(size, std::memory_order_relaxed);
+  auto ssize = static_cast<std::int64_t>(size);
+  std::int64_t current =
+      metrics.current_alloc.fetch_add(ssize, std::memory_order_relaxed) + ssize;
+  if (current <= 0) return;
+
+  std::uint64_t max_alloc = metrics.max_alloc.load(std::memory_order_relaxed);
+  while (static_cast<std::uint64_t>(current) > max_alloc &&
+         !metrics.max_alloc.compare_exchange_weak(max_alloc,
+             static_cast<std::uint64_t>(current), std::memory_order_relaxed)) {
+  }
 }
 
-auto dealloc(mem_metrics &metrics, std::size_t size) -> void {
-  ++metrics.frees;
-  metrics.total_free += size;
-  metrics.current_alloc -= static_cast<std::int64_t>(size);
+auto dealloc(atomic_mem_metrics &metrics, std::size_t size) -> void {
+  metrics.frees.fetch_add(1, std::memory_order_relaxed);
+  metrics.total_free.fetch_add(size, std::memory_order_relaxed);
+  metrics.current_alloc.fetch_sub(
+      static_cast<std::int64_t>(size), std::memory_order_relaxed);
 }
 
-auto reset(mem_metrics &metrics) -> void {
-  metrics = {
-      0,
-  };
+auto reset(atomic_mem_metrics &metrics) -> void {
+  metrics.total_alloc.store(0, std::memory_order_relaxed);
+  metrics.total_free.store(0, std::memory_order_relaxed);
+  metrics.max_alloc.store(0, std::memory_order_relaxed);
+  metrics.current_alloc.store(0, std::memory_order_relaxed);
+  metrics.allocs.store(0, std::memory_order_relaxed);
+  metrics.frees.store(0, std::memory_order_relaxed);
 }
 
 }  // namespace
 
 auto reset_alloc() -> void { reset(metrics_); }
 
-auto get_stats() -> mem_metrics { return metrics_; }
+auto get_stats() -> mem_metrics {
+  mem_metrics metrics{};
+  metrics.total_alloc = metrics_.total_alloc.load(std::memory_order_relaxed);
+  metrics.total_free = metrics_.total_free.load(std::memory_order_relaxed);
+  metrics.max_alloc = metrics_.max_alloc.load(std::memory_order_relaxed);
+  metrics.current_alloc =
+      metrics_.current_alloc.load(std::memory_order_relaxed);
+  metrics.allocs = metrics_.allocs.load(std::memory_order_relaxed);
+  metrics.frees = metrics_.frees.load(std::memory_order_relaxed);
+  return metrics;
+}
 
 // Assume no memory operators are replaced, and only done here. Then
 // `new[](size)` calls `new(size)` and `new[](size, al)` calls `new(size, al)`.
@@ -0,0 +1,251 @@
+#include "corpus.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "ubench/string.h"
+
+namespace {
+
+/// @brief The number of times to try for a word not yet in the vocabulary,
+/// before giving up.
+constexpr int VOCABULARY_TRIES = 1000;
+
+/// @brief The number of different words of lowercase letters with lengths
+/// from min to max, up to the maximum of std::size_t.
+auto word_capacity(unsigned int min, unsigned int max) -> std::size_t {
+  constexpr std::size_t limit = std::numeric_limits<std::size_t>::max() / 26;
+  std::size_t capacity = 0;
+  std::size_t words = 1;
+  for (unsigned int l = 1; l <= max; l++) {
+    if (words > limit) return std::numeric_limits<std::size_t>::max();
+    words *= 26;
+    if (l >= min) capacity += words;
+  }
+  return capacity;
+}
+
+auto parse_double(std::string_view arg) -> std::optional<double> {
+  std::string s{arg};
+  char* end = nullptr;
+  double value = std::strtod(s.c_str(), &end);
+  if (s.empty() || end != s.c_str() + s.size() || !std::isfinite(value)) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+}  // namespace
+
+corpus_generator::corpus_generator(const corpus_params& params)
+    : params_{params}, state_{params.seed} {
+  if (params.vocabulary == 0 || params.min_length == 0 ||
+      params.min_length > params.mean_length ||
+      params.mean_length > params.max_length || params.zipf < 0 ||
+      params.unique < 0 || params.unique > 1) {
+    throw std::invalid_argument("Invalid corpus parameters");
+  }
+  std::size_t capacity = word_capacity(params.min_length, params.max_length);
+  if (params.vocabulary > capacity / 2) {
+    throw std::invalid_argument(
+        "The vocabulary is too large for the lengths of the words");
+  }
+
+  // The vocabulary is reserved, so that the views in the set remain valid.
+  vocabulary_.reserve(params.vocabulary);
+  std::unordered_set<std::string_view> words{};
+  words.reserve(params.vocabulary);
+  std::string word{};
+  for (std::size_t i = 0; i < params.vocabulary; i++) {
+    int tries = 0;
+    do {
+      if (++tries > VOCABULARY_TRIES) {
+        throw std::invalid_argument(
+            "The vocabulary is too large for the lengths of the words");
+      }
+      random_letters(word, random_length());
+    } while (words.find(word) != words.end());
+    words.insert(vocabulary_.emplace_back(word));
+  }
+
+  // The cumulative probability of each rank, not normalised.
+  cdf_.reserve(params.vocabulary);
+  double sum = 0;
+  for (std::size_t r = 1; r <= params.vocabulary; r++) {
+    sum += std::pow(static_cast<double>(r), -params.zipf);
+    cdf_.push_back(sum);
+  }
+}
+
+auto corpus_generator::random() noexcept -> std::uint64_t {
+  // SplitMix64.
+  std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+auto corpus_generator::random_double() noexcept -> double {
+  // The upper 53 bits, in the range [0, 1).
+  return static_cast<double>(random() >> 11) * 0x1.0p-53;
+}
+
+auto corpus_generator::random_length() noexcept -> unsigned int {
+  if (params_.mean_length == params_.min_length) return params_.min_length;
+
+  // A geometric distribution, where each extra letter has the probability p.
+  // Lengths longer than the maximum are drawn again.
+  double p = static_cast<double>(params_.mean_length - params_.min_length) /
+             static_cast<double>(params_.mean_length - params_.min_length + 1);
+  while (true) {
+    double u = 1.0 - random_double();
+    auto extra = static_cast<unsigned int>(
+        std::min(std::floor(std::log(u) / std::log(p)),
+            static_cast<double>(params_.max_length)));
+    if (extra <= params_.max_length - params_.min_length) {
+      return params_.min_length + extra;
+    }
+  }
+}
+
+auto corpus_generator::random_letters(std::string& word, std::size_t length)
+    -> void {
+  word.resize(length);
+  for (auto& c : word) {
+    c = static_cast<char>('a' + random() % 26);
+  }
+}
+
+auto corpus_generator::next() -> std::optional<std::string_view> {
+  if (count_ == params_.words) return std::nullopt;
+  count_++;
+
+  if (params_.unique > 0 && random_double() < params_.unique) {
+    // The counter in upper case letters, which the vocabulary doesn't have,
+    // then lower case letters up to the length. The upper case letters end
+    // where the lower case start, so every word is different.
+    unique_.clear();
+    for (std::uint64_t n = ++unique_count_; n > 0; n = (n - 1) / 26) {
+      unique_.push_back(static_cast<char>('A' + (n - 1) % 26));
+    }
+    std::size_t length = random_length();
+    while (unique_.size() < length) {
+      unique_.push_back(static_cast<char>('a' + random() % 26));
+    }
+    return unique_;
+  }
+
+  double u = random_double() * cdf_.back();
+  auto it = std::upper_bound(cdf_.begin(), cdf_.end(), u);
+  auto r = static_cast<std::size_t>(it - cdf_.begin());
+  return vocabulary_[std::min(r, vocabulary_.size() - 1)];
+}
+
+auto corpus::append(std::string_view word) -> void {
+  data_.insert(data_.end(), word.begin(), word.end());
+  data_.push_back(' ');
+  lengths_.push_back(word.size());
+}
+
+auto corpus::finish() -> void {
+  // The views are made after, as the data moves while it grows.
+  tokens_.clear();
+  tokens_.reserve(lengths_.size());
+  std::size_t pos = 0;
+  for (auto length : lengths_) {
+    tokens_.emplace_back(&data_[pos], length);
+    pos += length + 1;
+  }
+  lengths_.clear();
+  lengths_.shrink_to_fit();
+}
+
+auto generate_corpus(const corpus_params& params) -> corpus {
+  corpus_generator gen{params};
+  corpus c{};
+  while (auto word = gen.next()) {
+    c.append(*word);
+  }
+  c.finish();
+  return c;
+}
+
+auto parse_corpus_option(char opt, std::string_view arg, corpus_params& params)
+    -> bool {
+  switch (opt) {
+    case 's': {
+      auto seed = ubench::string::parse_int<std::uint64_t>(arg);
+      if (seed) {
+        params.seed = *seed;
+        return true;
+      }
+      std::cerr << "Error: Invalid seed" << std::endl;
+      return false;
+    }
+    case 'n': {
+      auto words = ubench::string::parse_int<std::size_t>(arg);
+      if (words) {
+        params.words = *words;
+        return true;
+      }
+      std::cerr << "Error: Invalid number of words" << std::endl;
+      return false;
+    }
+    case 'v': {
+      auto vocabulary = ubench::string::parse_int<std::size_t>(arg);
+      if (vocabulary && *vocabulary >= 1 &&
+          *vocabulary <= std::numeric_limits<std::uint32_t>::max()) {
+        params.vocabulary = *vocabulary;
+        return true;
+      }
+      std::cerr << "Error: Specify a vocabulary of at least one word"
+                << std::endl;
+      return false;
+    }
+    case 'z': {
+      auto zipf = parse_double(arg);
+      if (zipf && *zipf >= 0) {
+        params.zipf = *zipf;
+        return true;
+      }
+      std::cerr << "Error: Specify a Zipf skew of zero or more" << std::endl;
+      return false;
+    }
+    case 'l': {
+      auto lengths = ubench::string::split_args_int<unsigned int>(arg);
+      if (lengths.size() == 3 && lengths[0] >= 1 && lengths[0] <= lengths[1] &&
+          lengths[1] <= lengths[2] && lengths[2] <= 65536) {
+        params.min_length = lengths[0];
+        params.mean_length = lengths[1];
+        params.max_length = lengths[2];
+        return true;
+      }
+      std::cerr << "Error: Specify the lengths as <min>,<mean>,<max> with "
+                   "1 <= min <= mean <= max"
+                << std::endl;
+      return false;
+    }
+    case 'u': {
+      auto unique = parse_double(arg);
+      if (unique && *unique >= 0 && *unique <= 1) {
+        params.unique = *unique;
+        return true;
+      }
+      std::cerr << "Error: Specify a fraction of unique words from 0 to 1"
+                << std::endl;
+      return false;
+    }
+    default:
+      return false;
+  }
+}
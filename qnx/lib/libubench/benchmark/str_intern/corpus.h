@@ -0,0 +1,127 @@
+#ifndef BENCHMARK_STRINTERN_CORPUS_H
+#define BENCHMARK_STRINTERN_CORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief The parameters of a generated corpus.
+struct corpus_params {
+  std::uint64_t seed{1};          //< The seed of the random numbers.
+  std::size_t words{1000000};     //< The number of words in the corpus.
+  std::size_t vocabulary{50000};  //< The number of different repeated words.
+  double zipf{1.0};               //< The skew of the word frequencies.
+  unsigned int min_length{1};     //< The shortest word.
+  unsigned int mean_length{5};    //< The mean length of a word.
+  unsigned int max_length{20};    //< The longest word.
+  double unique{0.0};             //< The fraction of words that never repeat.
+};
+
+/// @brief Generate the words of a corpus.
+///
+/// A vocabulary of different words of lowercase letters is made first. The
+/// lengths of the words follow a geometric distribution from min_length, with
+/// the mean given, up to max_length. Each word of the corpus is then either a
+/// word of the vocabulary, where the word of rank r is chosen with a
+/// probability proportional to 1 / r^zipf, or with the probability unique, a
+/// word that is used only once.
+///
+/// The random numbers and distributions are implemented here, not with
+/// <random>, whose distributions differ between standard libraries. The same
+/// parameters give the same corpus on the same host and C library. Elsewhere
+/// it may differ, as std::pow() and std::log() aren't correctly rounded by
+/// every C library.
+class corpus_generator {
+ public:
+  /// @brief Make the vocabulary.
+  ///
+  /// @param params the parameters of the corpus.
+  ///
+  /// @exception std::invalid_argument The parameters are out of range, or
+  /// there aren't enough different words of the lengths allowed for the
+  /// vocabulary.
+  explicit corpus_generator(const corpus_params& params);
+
+  /// @brief Get the next word.
+  ///
+  /// @return the word, which is valid until the next call, or nothing after
+  /// the last word.
+  [[nodiscard]] auto next() -> std::optional<std::string_view>;
+
+ private:
+  corpus_params params_;
+  std::uint64_t state_;
+  std::size_t count_{};
+  std::uint64_t unique_count_{};
+  std::vector<std::string> vocabulary_{};
+  std::vector<double> cdf_{};
+  std::string unique_{};
+
+  auto random() noexcept -> std::uint64_t;
+  auto random_double() noexcept -> double;
+  auto random_length() noexcept -> unsigned int;
+  auto random_letters(std::string& word, std::size_t length) -> void;
+};
+
+/// @brief A corpus held in memory.
+///
+/// The words are copied back to back, so that they are read from memory in
+/// the same order as from a file.
+class corpus {
+ public:
+  /// @brief Add a word to the end of the corpus.
+  ///
+  /// The tokens aren't valid until finish() is called.
+  ///
+  /// @param word the word to copy.
+  auto append(std::string_view word) -> void;
+
+  /// @brief Make the tokens, after the last word is appended.
+  auto finish() -> void;
+
+  /// @brief Every word of the corpus.
+  ///
+  /// @return the words, which point into the corpus, and remain valid if the
+  /// corpus is moved.
+  [[nodiscard]] auto tokens() const noexcept
+      -> const std::vector<std::string_view>& {
+    return tokens_;
+  }
+
+ private:
+  // A vector never moves its elements when it is moved, unlike the short
+  // string optimisation of std::string.
+  std::vector<char> data_{};
+  std::vector<std::size_t> lengths_{};
+  std::vector<std::string_view> tokens_{};
+};
+
+/// @brief Generate a corpus in memory.
+///
+/// @param params the parameters of the corpus.
+///
+/// @return the corpus.
+///
+/// @exception std::invalid_argument The parameters are invalid.
+auto generate_corpus(const corpus_params& params) -> corpus;
+
+/// @brief Parse an option of the corpus generator.
+///
+/// The options are -s<seed>, -n<words>, -v<vocabulary>, -z<skew>,
+/// -l<min>,<mean>,<max> and -u<unique>. An error is printed if the argument
+/// isn't valid.
+///
+/// @param opt the option.
+///
+/// @param arg the argument of the option.
+///
+/// @param params the parameters to update.
+///
+/// @return true if the argument is valid.
+auto parse_corpus_option(char opt, std::string_view arg, corpus_params& params)
+    -> bool;
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef BENCHMARK_STRINTERN_LATENCY_H
+#define BENCHMARK_STRINTERN_LATENCY_H
+
+#include <chrono>
+
+#include "ubench/measure/latency_histogram.h"
+
+using latency_histogram = ubench::measure::latency_histogram;
+
+/// @brief The latencies of calls to intern, timing every Nth call.
+///
+/// Hits, where the string was already interned, and misses, where it is
+/// copied, are counted in separate histograms, as a miss allocates and is
+/// usually much slower. The calls that caused the table to rehash are also
+/// counted on their own, as they are the longest.
+class latency_recorder {
+ public:
+  /// @brief Make a recorder.
+  ///
+  /// @param every time one call out of this many. Timing every call adds the
+  /// time to read the clock twice to each, and the cache misses of updating
+  /// the histogram.
+  explicit latency_recorder(unsigned int every = 1) noexcept
+      : every_{every}, countdown_{every} {}
+
+  /// @brief If the next call should be timed.
+  ///
+  /// @return true once every N calls.
+  [[nodiscard]] auto sample() noexcept -> bool {
+    if (--countdown_ != 0) return false;
+    countdown_ = every_;
+    return true;
+  }
+
+  /// @brief Count the latency of a call.
+  ///
+  /// @param latency the time taken by the call.
+  ///
+  /// @param miss if the string wasn't interned before the call.
+  ///
+  /// @param rehash if the call rehashed the table.
+  auto record(std::chrono::nanoseconds latency, bool miss, bool rehash) noexcept
+      -> void {
+    (miss ? misses_ : hits_).record(latency);
+    if (rehash) rehashes_.record(latency);
+  }
+
+  /// @brief Add all latencies counted by another recorder.
+  ///
+  /// @param other the recorder to add.
+  auto merge(const latency_recorder& other) noexcept -> void {
+    hits_.merge(other.hits_);
+    misses_.merge(other.misses_);
+    rehashes_.merge(other.rehashes_);
+  }
+
+  /// @brief The number of calls between each call timed.
+  [[nodiscard]] auto every() const noexcept -> unsigned int { return every_; }
+
+  /// @brief The latencies of calls that found the string.
+  [[nodiscard]] auto hits() const noexcept -> const latency_histogram& {
+    return hits_;
+  }
+
+  /// @brief The latencies of calls that copied the string.
+  [[nodiscard]] auto misses() const noexcept -> const latency_histogram& {
+    return misses_;
+  }
+
+  /// @brief The latencies of calls that rehashed the table, which are also
+  /// counted as hits or misses.
+  [[nodiscard]] auto rehashes() const noexcept -> const latency_histogram& {
+    return rehashes_;
+  }
+
+ private:
+  unsigned int every_;
+  unsigned int countdown_;
+  latency_histogram hits_{};
+  latency_histogram misses_{};
+  latency_histogram rehashes_{};
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef BENCHMARK_STRINTERN_MEMBUFF_H
+#define BENCHMARK_STRINTERN_MEMBUFF_H
+
+#include <string_view>
+#include <vector>
+
+#include "stdext/expected.h"
+
+/// @brief Read tokens that are already split in memory.
+///
+/// Used for generated words, so that the time to read and tokenize a file
+/// isn't measured.
+class membuff {
+ public:
+  /// @brief Tokens remain valid as long as the vector they're read from.
+  static constexpr bool stable_tokens = true;
+
+  /// @brief Read tokens from a vector.
+  ///
+  /// @param tokens the tokens, which must remain valid while reading.
+  explicit membuff(const std::vector<std::string_view>& tokens) noexcept
+      : it_{tokens.begin()}, end_{tokens.end()} {}
+
+  /// @brief Get the next token.
+  ///
+  /// @return The token, or zero after the last token.
+  [[nodiscard]] auto get_token() noexcept
+      -> stdext::expected<std::string_view, int> {
+    if (it_ == end_) return stdext::unexpected{0};
+    return *it_++;
+  }
+
+ private:
+  std::vector<std::string_view>::const_iterator it_;
+  std::vector<std::string_view>::const_iterator end_;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "mmapbuff.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <string_view>
+
+#include "stdext/expected.h"
+#include "ubench/file.h"
+#include "whitespace.h"
+
+mmapbuff::mmapbuff(const std::filesystem::path& path, tokenizer t)
+    : finder_{get_whitespace_finder(t)} {
+  ubench::file::fdesc file{path.string()};
+  if (!file) {
+    errno_ = errno;
+    return;
+  }
+
+  struct stat sb {};
+  if (fstat(file, &sb) < 0) {
+    errno_ = errno;
+    return;
+  }
+
+  // A file of zero bytes can't be mapped, and has no tokens.
+  length_ = static_cast<std::size_t>(sb.st_size);
+  if (length_ == 0) return;
+
+  // The mapping remains valid after the file is closed.
+  void* addr = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, file, 0);
+  if (addr == MAP_FAILED) {  // NOLINT(performance-no-int-to-ptr)
+    errno_ = errno;
+    length_ = 0;
+    return;
+  }
+  posix_madvise(addr, length_, POSIX_MADV_SEQUENTIAL);
+
+  addr_ = addr;
+  begin_ = static_cast<const char*>(addr);
+  pos_ = begin_;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  end_ = begin_ + length_;
+}
+
+mmapbuff::mmapbuff(std::string_view data, tokenizer t)
+    : length_{data.size()},
+      begin_{data.data()},
+      pos_{data.data()},
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      end_{data.data() + data.size()},
+      finder_{get_whitespace_finder(t)} {}
+
+mmapbuff::~mmapbuff() {
+  if (addr_) munmap(addr_, length_);
+}
+
+auto mmapbuff::get_token() -> stdext::expected<std::string_view, int> {
+  const char* p = finder_.find_word(pos_, end_);
+  if (p == end_) {
+    pos_ = end_;
+    return stdext::unexpected{errno_};
+  }
+
+  const char* q = finder_.find_space(p, end_);
+  // Start reading next time from one past the space.
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  pos_ = q == end_ ? end_ : q + 1;
+  return std::string_view(p, static_cast<std::size_t>(q - p));
+}
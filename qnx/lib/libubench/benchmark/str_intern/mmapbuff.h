@@ -0,0 +1,68 @@
+#ifndef BENCHMARK_STRINTERN_MMAPBUFF_H
+#define BENCHMARK_STRINTERN_MMAPBUFF_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+#include "stdext/expected.h"
+#include "whitespace.h"
+
+/// @brief Read tokens from a file mapped into memory.
+///
+/// The file is mapped once, and the tokens point into the mapping, so no data
+/// is copied. The kernel is told the file is read sequentially, so that it
+/// reads ahead.
+class mmapbuff {
+ public:
+  /// @brief Tokens remain valid until this object is destroyed.
+  static constexpr bool stable_tokens = true;
+
+  /// @brief Map the file.
+  ///
+  /// @param path the file to read.
+  ///
+  /// @param t the tokenizer to find whitespace with.
+  mmapbuff(const std::filesystem::path& path, tokenizer t);
+
+  /// @brief Read tokens from a buffer already in memory.
+  ///
+  /// @param data the buffer, which must remain valid while reading. It isn't
+  /// copied or unmapped.
+  ///
+  /// @param t the tokenizer to find whitespace with.
+  mmapbuff(std::string_view data, tokenizer t);
+  mmapbuff(const mmapbuff&) = delete;
+  auto operator=(const mmapbuff&) -> mmapbuff& = delete;
+  mmapbuff(mmapbuff&&) = delete;
+  auto operator=(mmapbuff&&) -> mmapbuff& = delete;
+  ~mmapbuff();
+
+  /// @brief Get the next token.
+  ///
+  /// @return The token, unless there is an error.
+  [[nodiscard]] auto get_token() -> stdext::expected<std::string_view, int>;
+
+  /// @brief The complete file, or buffer, being read.
+  ///
+  /// @return the data, which is empty if the file couldn't be mapped.
+  [[nodiscard]] auto data() const noexcept -> std::string_view {
+    return {begin_, length_};
+  }
+
+  /// @brief The error from opening or mapping the file.
+  ///
+  /// @return the errno, or 0 if the file was mapped.
+  [[nodiscard]] auto error() const noexcept -> int { return errno_; }
+
+ private:
+  void* addr_{};
+  std::size_t length_{};
+  const char* begin_{};
+  const char* pos_{};
+  const char* end_{};
+  whitespace_finder finder_{};
+  int errno_{};
+};
+
+#endif
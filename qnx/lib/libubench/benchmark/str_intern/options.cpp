@@ -1,22 +1,42 @@
 #include "options.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "stdext/expected.h"
 #include "ubench/options.h"
+#include "ubench/string.h"
+#include "ubench/thread.h"
 
 namespace {
 void print_help(std::string_view prog_name) {
-  std::cout << prog_name << " [-B<impl>] <file>" << std::endl;
+  std::cout << prog_name
+            << " [-B<impl>] [-t<threads>] [-L] [-S<every>] [-P] [-b<batch>]"
+            << std::endl;
+  std::cout << "    [-H<hash>] [-r<reader>] [-p<pipeline>] [-w<warmup>] "
+               "[-i<repeat>] <file>"
+            << std::endl;
+  std::cout << prog_name
+            << " -g [-s<seed>] [-n<words>] [-v<vocabulary>] [-z<skew>]"
+            << std::endl;
+  std::cout << "    [-l<min>,<mean>,<max>] [-u<unique>] [-B<impl>] "
+               "[-t<threads>] [-L] [-S<every>]"
+            << std::endl;
+  std::cout << "    [-P] [-b<batch>] [-H<hash>] [-w<warmup>] [-i<repeat>]"
+            << std::endl;
   std::cout << std::endl;
   std::cout
       << "Reads the file and interns all individual words for benchmark testing"
       << std::endl;
 }
 
-const std::unordered_map<std::string_view, strintern_impl> mode = {
+const std::vector<std::pair<std::string_view, strintern_impl>> mode = {
     {"none", strintern_impl::none},
     {"forward_list", strintern_impl::flist},
     {"set", strintern_impl::set},
@@ -28,26 +48,71 @@ const std::unordered_map<std::string_view, strintern_impl> mode = {
     {"var_set", strintern_impl::var_set},
     {"var_set_pmr", strintern_impl::var_set_pmr},
     {"ubench", strintern_impl::ubench},
+    {"ubench_flat", strintern_impl::ubench_flat},
+    {"ubench_arena", strintern_impl::ubench_arena},
+    {"ubench_incremental", strintern_impl::ubench_incremental},
+    {"ubench_flat_incremental", strintern_impl::ubench_flat_incremental},
+    {"ubench_concurrent", strintern_impl::ubench_concurrent},
+};
+
+const std::unordered_map<std::string_view, ubench::string::str_intern_hash>
+    hashes = {
+        {"std", ubench::string::str_intern_hash::standard},
+        {"fast", ubench::string::str_intern_hash::fast},
+        {"simd", ubench::string::str_intern_hash::simd},
+};
+
+const std::unordered_map<std::string_view, reader_impl> readers = {
+    {"read", reader_impl::read},
+    {"mmap", reader_impl::mmap},
+    {"mmap_scalar", reader_impl::mmap_scalar},
+};
+
+const std::unordered_map<std::string_view, pipeline_impl> pipelines = {
+    {"merge", pipeline_impl::merge},
+    {"shared", pipeline_impl::shared},
+};
+
+// The implementations using the tables of libubench, which have an
+// intern_batch() method and a choice of hash function.
+const std::unordered_set<strintern_impl> table_modes = {
+    strintern_impl::ubench,
+    strintern_impl::ubench_flat,
+    strintern_impl::ubench_arena,
+    strintern_impl::ubench_incremental,
+    strintern_impl::ubench_flat_incremental,
 };
 
 }  // namespace
 
+auto strintern_names()
+    -> const std::vector<std::pair<std::string_view, strintern_impl>>& {
+  return mode;
+}
+
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
 auto make_options(int argc, const char* const argv[]) noexcept
     -> stdext::expected<options, int> {
   bool help = false;
+  bool corpus_set = false;
+  bool warmup_set = false;
+  bool repeat_set = false;
   int err = 0;
 
   options o{};
-  ubench::options opts{argc, argv, "B:?"};
+  ubench::options opts{argc, argv, "B:t:LS:Pb:H:r:p:gs:n:v:z:l:u:w:i:?"};
   for (const auto& opt : opts) {
     if (opt) {
       switch (opt->get_option()) {
         case 'B': {
           // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
           auto arg = *opt->argument();
-          auto it = mode.find(arg);
-          if (it != mode.end()) {
+          auto it = std::find_if(mode.begin(), mode.end(),
+              [arg](const auto& m) { return m.first == arg; });
+          if (arg == "all") {
+            o.all_ = true;
+            o.mode_s_ = std::string{arg};
+          } else if (it != mode.end()) {
             o.mode_ = it->second;
             o.mode_s_ = std::string{arg};
           } else {
@@ -57,6 +122,136 @@ auto make_options(int argc, const char* const argv[]) noexcept
           }
           break;
         }
+        case 't': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto threads = ubench::string::parse_int<unsigned int>(arg);
+          if (threads && *threads >= 1 &&
+              *threads <= ubench::thread::thread_count()) {
+            o.threads_ = *threads;
+          } else {
+            err = 1;
+            std::cerr << "Error: Specify between 1 and "
+                      << ubench::thread::thread_count() << " threads"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'L':
+          o.latency_ = true;
+          break;
+        case 'P':
+          o.perf_ = true;
+          break;
+        case 'S': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto sample = ubench::string::parse_int<unsigned int>(arg);
+          if (sample && *sample >= 1) {
+            o.latency_ = true;
+            o.sample_ = *sample;
+          } else {
+            err = 1;
+            std::cerr << "Error: Specify a sample of 1 or more calls"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'b': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto batch = ubench::string::parse_int<unsigned int>(arg);
+          if (batch && *batch >= 1 && *batch <= 65536) {
+            o.batch_ = *batch;
+          } else {
+            err = 1;
+            std::cerr << "Error: Specify a batch between 1 and 65536 words"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'H': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto it = hashes.find(arg);
+          if (it != hashes.end()) {
+            o.hash_ = it->second;
+            o.hash_s_ = std::string{arg};
+          } else {
+            err = 1;
+            std::cerr << "Error: Unknown hash function: " << arg << std::endl;
+          }
+          break;
+        }
+        case 'r': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto it = readers.find(arg);
+          if (it != readers.end()) {
+            o.reader_ = it->second;
+          } else {
+            err = 1;
+            std::cerr << "Error: Unknown reader: " << arg << std::endl;
+          }
+          break;
+        }
+        case 'p': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto it = pipelines.find(arg);
+          if (it != pipelines.end()) {
+            o.pipeline_ = it->second;
+            o.pipeline_s_ = std::string{arg};
+          } else {
+            err = 1;
+            std::cerr << "Error: Unknown pipeline: " << arg << std::endl;
+          }
+          break;
+        }
+        case 'g':
+          o.generate_ = true;
+          break;
+        case 'w': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto warmup = ubench::string::parse_int<unsigned int>(arg);
+          if (warmup && *warmup <= 1000) {
+            o.warmup_ = *warmup;
+            warmup_set = true;
+          } else {
+            err = 1;
+            std::cerr << "Error: Specify between 0 and 1000 warm-up runs"
+                      << std::endl;
+          }
+          break;
+        }
+        case 'i': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto repeat = ubench::string::parse_int<unsigned int>(arg);
+          if (repeat && *repeat >= 1 && *repeat <= 1000) {
+            o.repeat_ = *repeat;
+            repeat_set = true;
+          } else {
+            err = 1;
+            std::cerr << "Error: Specify between 1 and 1000 measured runs"
+                      << std::endl;
+          }
+          break;
+        }
+        case 's':
+        case 'n':
+        case 'v':
+        case 'z':
+        case 'l':
+        case 'u':
+          corpus_set = true;
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          if (!parse_corpus_option(opt->get_option(), *opt->argument(),
+                  o.corpus_)) {
+            err = 1;
+          }
+          break;
         case '?':
           help = true;
           break;
@@ -71,12 +266,67 @@ auto make_options(int argc, const char* const argv[]) noexcept
     }
   }
 
-  if (opts.args().size() != 1) {
+  if (o.generate_) {
+    if (!opts.args().empty()) {
+      err = 1;
+      std::cerr << "Error: Can't read a file when generating the words"
+                << std::endl;
+    }
+    if (o.pipeline_ != pipeline_impl::none) {
+      err = 1;
+      std::cerr << "Error: The pipeline can't generate the words" << std::endl;
+    }
+    if (o.mode_s_.empty()) o.all_ = true;
+  } else {
+    if (corpus_set) {
+      err = 1;
+      std::cerr << "Error: The options of the generated words need -g"
+                << std::endl;
+    }
+    if (opts.args().size() != 1) {
+      err = 1;
+      std::cerr << "Error: Must provide exactly one single file to read"
+                << std::endl;
+    } else {
+      o.input_ = opts.args()[0];
+    }
+  }
+
+  // With every implementation, -b and -H apply to those that support them.
+  if (o.batch_ > 1 && o.pipeline_ == pipeline_impl::none) {
+    if (!o.all_ && table_modes.find(o.mode_) == table_modes.end()) {
+      err = 1;
+      std::cerr << "Error: The implementation can't intern in batches"
+                << std::endl;
+    } else if (o.latency_) {
+      err = 1;
+      std::cerr << "Error: The latency can't be measured in batches"
+                << std::endl;
+    }
+  }
+
+  if (o.pipeline_ != pipeline_impl::none) {
+    // The pipeline interns with ubench, or ubench_concurrent, itself.
+    if (!o.mode_s_.empty() || o.latency_ || o.perf_ || o.batch_ > 1) {
+      err = 1;
+      std::cerr << "Error: The pipeline can't be used with -B, -L, -P or -b"
+                << std::endl;
+    } else if (o.pipeline_ == pipeline_impl::shared &&
+               o.hash_ != ubench::string::str_intern_hash::standard) {
+      err = 1;
+      std::cerr << "Error: The shared pipeline can't use a different hash"
+                << std::endl;
+    }
+  } else if (!o.all_ && o.hash_ != ubench::string::str_intern_hash::standard &&
+             table_modes.find(o.mode_) == table_modes.end()) {
     err = 1;
-    std::cerr << "Error: Must provide exactly one single file to read"
+    std::cerr << "Error: The implementation can't use a different hash"
               << std::endl;
-  } else {
-    o.input_ = opts.args()[0];
+  }
+
+  if (o.all_) {
+    if (!warmup_set) o.warmup_ = 1;
+    if (!repeat_set) o.repeat_ = 3;
   }
 
   if (err || help) {
@@ -86,7 +336,7 @@ auto make_options(int argc, const char* const argv[]) noexcept
   }
 
   if (o.mode_s_.empty()) {
-    o.mode_s_ = std::string{"none"};
+    o.mode_s_ = std::string{o.all_ ? "all" : "none"};
   }
 
   return o;
@@ -1,22 +1,45 @@
 #ifndef BENCHMARK_STRINTERN_OPTIONS_H
 #define BENCHMARK_STRINTERN_OPTIONS_H
 
+#include <cstddef>
 #include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "stdext/expected.h"
+#include "ubench/str_intern.h"
+#include "corpus.h"
 
 enum class strintern_impl {
-  none,            //< No interning function.
-  flist,           //< Forward list.
-  set,             //< Use a set.
-  unordered_set,   //< Use an unordered set.
-  fixed_set_128k,  //< Custom fixed size set of 131072 buckets.
-  fixed_set_256k,  //< Custom fixed size set of 262144 buckets.
-  fixed_set_512k,  //< Custom fixed size set of 524288 buckets.
-  fixed_set_1m,    //< Custom fixed size set of 1048576 buckets.
-  var_set,         //< Custom variable bucket size.
-  var_set_pmr,     //< Custom variable bucket size with PMR.
-  ubench,          //< Use implementation in libubench.
+  none,                     //< No interning function.
+  flist,                    //< Forward list.
+  set,                      //< Use a set.
+  unordered_set,            //< Use an unordered set.
+  fixed_set_128k,           //< Custom fixed size set of 131072 buckets.
+  fixed_set_256k,           //< Custom fixed size set of 262144 buckets.
+  fixed_set_512k,           //< Custom fixed size set of 524288 buckets.
+  fixed_set_1m,             //< Custom fixed size set of 1048576 buckets.
+  var_set,                  //< Custom variable bucket size.
+  var_set_pmr,              //< Custom variable bucket size with PMR.
+  ubench,                   //< Use implementation in libubench.
+  ubench_flat,              //< Use libubench with open addressing.
+  ubench_arena,             //< Use libubench storing strings in an arena.
+  ubench_incremental,       //< Use libubench with an incremental rehash.
+  ubench_flat_incremental,  //< Use libubench open addressing, incremental.
+  ubench_concurrent,        //< Use the concurrent implementation.
+};
+
+enum class reader_impl {
+  read,         //< Copy the file through a buffer with read().
+  mmap,         //< Map the file, finding whitespace with SIMD instructions.
+  mmap_scalar,  //< Map the file, finding whitespace a character at a time.
+};
+
+enum class pipeline_impl {
+  none,    //< Every thread reads the complete file.
+  merge,   //< Intern chunks into a table per thread, merged at the end.
+  shared,  //< Intern chunks into one concurrent table.
 };
 
 /// @brief User options.
@@ -42,6 +65,46 @@ class options {
     return mode_s_;
   }
 
+  /// @brief If every implementation is tested, one after the other.
+  ///
+  /// Every implementation except forward_list, which is too slow for a large
+  /// vocabulary, is run on the same words. A file is read into memory first.
+  /// Given with '-B all', and the default when the words are generated and no
+  /// implementation is given.
+  ///
+  /// @return true if every implementation is tested.
+  [[nodiscard]] auto all() const noexcept -> bool { return all_; }
+
+  /// @brief The number of times each implementation is run before measuring.
+  ///
+  /// @return the number of runs that aren't measured. Default is 1 when
+  /// testing every implementation, else 0.
+  [[nodiscard]] auto warmup() const noexcept -> unsigned int {
+    return warmup_;
+  }
+
+  /// @brief The number of times each implementation is measured.
+  ///
+  /// The results of the run with the median elapsed time are printed.
+  ///
+  /// @return the number of runs that are measured. Default is 3 when testing
+  /// every implementation, else 1.
+  [[nodiscard]] auto repeat() const noexcept -> unsigned int {
+    return repeat_;
+  }
+
+  /// @brief If the words are generated in memory instead of read from a file.
+  ///
+  /// @return true if the words are generated with the parameters corpus().
+  [[nodiscard]] auto generate() const noexcept -> bool { return generate_; }
+
+  /// @brief The parameters of the words to generate.
+  ///
+  /// @return the parameters of the corpus.
+  [[nodiscard]] auto corpus() const noexcept -> const corpus_params& {
+    return corpus_;
+  }
+
   /// @brief The path of the file to read for testing.
   ///
   /// @return a file system path (relative to the current directory) to read and
@@ -50,6 +113,84 @@ class options {
     return input_;
   }
 
+  /// @brief The number of threads that intern at the same time.
+  ///
+  /// Each thread reads the complete file and interns every word into the same
+  /// interning object. Implementations that are not thread-safe are protected
+  /// by a mutex.
+  ///
+  /// @return the number of threads to run. Default is 1.
+  [[nodiscard]] auto threads() const noexcept -> unsigned int {
+    return threads_;
+  }
+
+  /// @brief If the latency of calls to intern should be measured.
+  ///
+  /// Measuring the latency adds the time to read the clock twice to each call
+  /// timed, so the total time is larger than without measuring.
+  ///
+  /// @return true if the latency should be measured and printed.
+  [[nodiscard]] auto latency() const noexcept -> bool { return latency_; }
+
+  /// @brief If the hardware events, such as the cycles and cache misses, should
+  /// be counted.
+  ///
+  /// @return true if the events should be counted and printed for each word.
+  [[nodiscard]] auto perf() const noexcept -> bool { return perf_; }
+
+  /// @brief The number of calls to intern for each call timed, when measuring
+  /// the latency.
+  ///
+  /// @return one call out of this many is timed. Default is 1, timing every
+  /// call.
+  [[nodiscard]] auto sample() const noexcept -> unsigned int {
+    return sample_;
+  }
+
+  /// @brief The number of words to intern with each call to intern_batch().
+  ///
+  /// Only the single threaded libubench implementations support interning in
+  /// batches. A batch of one interns every word with intern().
+  ///
+  /// @return the number of words in a batch. Default is 1.
+  [[nodiscard]] auto batch() const noexcept -> std::size_t { return batch_; }
+
+  /// @brief How the file is read and split into words.
+  ///
+  /// @return the reader. Default is to read through a buffer.
+  [[nodiscard]] auto reader() const noexcept -> reader_impl { return reader_; }
+
+  /// @brief If the file is split into chunks that are interned in parallel.
+  ///
+  /// The pipeline is run for every power of two threads up to threads(), and
+  /// for threads() itself, instead of the implementation given by strintern().
+  ///
+  /// @return the pipeline. Default is none, to run strintern().
+  [[nodiscard]] auto pipeline() const noexcept -> pipeline_impl {
+    return pipeline_;
+  }
+
+  /// @brief The printable name of the pipeline.
+  ///
+  /// @return the printable name of the pipeline.
+  [[nodiscard]] auto pipeline_s() const noexcept -> const std::string& {
+    return pipeline_s_;
+  }
+
+  /// @brief The hash function for the libubench implementations.
+  ///
+  /// @return the hash function. Default is the standard library.
+  [[nodiscard]] auto hash() const noexcept -> ubench::string::str_intern_hash {
+    return hash_;
+  }
+
+  /// @brief The printable name of the hash function.
+  ///
+  /// @return the printable name of the hash function.
+  [[nodiscard]] auto hash_s() const noexcept -> const std::string& {
+    return hash_s_;
+  }
+
  private:
   options() = default;
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -59,8 +200,30 @@ class options {
   strintern_impl mode_{strintern_impl::none};
   std::string mode_s_{};
   std::filesystem::path input_{};
+  bool all_{false};
+  unsigned int warmup_{0};
+  unsigned int repeat_{1};
+  bool generate_{false};
+  corpus_params corpus_{};
+  unsigned int threads_{1};
+  bool latency_{false};
+  bool perf_{false};
+  unsigned int sample_{1};
+  std::size_t batch_{1};
+  reader_impl reader_{reader_impl::read};
+  pipeline_impl pipeline_{pipeline_impl::none};
+  std::string pipeline_s_{};
+  ubench::string::str_intern_hash hash_{
+      ubench::string::str_intern_hash::standard};
+  std::string hash_s_{"std"};
 };
 
+/// @brief Every implementation, with its name, in the order of the help.
+///
+/// @return the implementations and their names.
+[[nodiscard]] auto strintern_names()
+    -> const std::vector<std::pair<std::string_view, strintern_impl>>&;
+
 /// @brief Get options.
 ///
 /// The command line options are parsed and the fields of this class are updated
@@ -0,0 +1,278 @@
+#include "pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ubench/measure/busy_measurement.h"
+#include "ubench/measure/print.h"
+#include "ubench/str_intern.h"
+#include "ubench/str_intern_concurrent.h"
+#include "allocator.h"
+#include "mmapbuff.h"
+#include "options.h"
+#include "whitespace.h"
+
+namespace {
+
+/// @brief The size of a chunk, before it is extended to the next whitespace.
+///
+/// Small enough that the threads finish at about the same time, and large
+/// enough that taking the next chunk is rare.
+constexpr std::size_t CHUNK_SIZE = 1 << 20;
+
+/// @brief The number of strings merged with each call to intern_batch().
+constexpr std::size_t MERGE_BATCH = 64;
+
+struct pipeline_result {
+  std::size_t words{};                  //< Words read by all threads.
+  std::size_t interned{};               //< Unique words after merging.
+  std::chrono::nanoseconds intern{};    //< Time to tokenize and intern.
+  std::chrono::nanoseconds merge{};     //< Time to merge the tables.
+  ubench::measure::busy_measurement busy{};  //< The complete run.
+  mem_metrics metrics{};                //< Allocations of the complete run.
+};
+
+/// @brief Split the data into chunks, each ending at whitespace.
+///
+/// No word is split over two chunks, so the chunks can be tokenized
+/// independently.
+auto split_chunks(std::string_view data, tokenizer t)
+    -> std::vector<std::string_view> {
+  auto finder = get_whitespace_finder(t);
+  std::vector<std::string_view> chunks{};
+  const char* p = data.data();
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const char* end = p + data.size();
+  while (p < end) {
+    const char* q = static_cast<std::size_t>(end - p) > CHUNK_SIZE
+                        ? finder.find_space(p + CHUNK_SIZE, end)
+                        : end;
+    chunks.emplace_back(p, static_cast<std::size_t>(q - p));
+    p = q;
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return chunks;
+}
+
+/// @brief The number of threads to run the pipeline with.
+///
+/// @return every power of two less than threads, and threads.
+auto thread_counts(unsigned int threads) -> std::vector<unsigned int> {
+  std::vector<unsigned int> counts{};
+  for (unsigned int t = 1; t < threads; t *= 2) {
+    counts.push_back(t);
+  }
+  counts.push_back(threads);
+  return counts;
+}
+
+/// @brief Run the workers until every chunk is interned.
+///
+/// @tparam F the function to intern a single word.
+///
+/// @param chunks the chunks of the file.
+///
+/// @param threads the number of threads.
+///
+/// @param t the tokenizer.
+///
+/// @param intern the function called for every word, with the index of the
+/// thread and the word.
+///
+/// @return the number of words read by all threads.
+template <typename F>
+auto run_workers(const std::vector<std::string_view>& chunks,
+    unsigned int threads, tokenizer t, F&& intern) -> std::size_t {
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> words{0};
+  auto worker = [&](unsigned int thread) {
+    std::size_t w = 0;
+    while (true) {
+      std::size_t c = next.fetch_add(1, std::memory_order_relaxed);
+      if (c >= chunks.size()) break;
+      mmapbuff buff{chunks[c], t};
+      while (true) {
+        auto token = buff.get_token();
+        if (!token) break;
+        w++;
+        intern(thread, *token);
+      }
+    }
+    words += w;
+  };
+
+  std::vector<std::thread> workers{};
+  for (unsigned int thread = 1; thread < threads; thread++) {
+    workers.emplace_back(worker, thread);
+  }
+  worker(0);
+  for (auto& w : workers) {
+    w.join();
+  }
+  return words;
+}
+
+/// @brief Intern into a table for each thread, then merge into the first.
+auto run_merge(const options& options,
+    const std::vector<std::string_view>& chunks, unsigned int threads,
+    tokenizer t) -> pipeline_result {
+  pipeline_result result{};
+  ubench::measure::busy_stop_watch stopwatch{};
+  reset_alloc();
+
+  std::vector<ubench::string::str_intern> tables{};
+  tables.reserve(threads);
+  for (unsigned int thread = 0; thread < threads; thread++) {
+    tables.emplace_back(4096, 1 << 20,
+        ubench::string::str_intern_backend::chained,
+        ubench::string::str_intern_rehash::full, options.hash());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  result.words = run_workers(
+      chunks, threads, t, [&tables](unsigned int thread, std::string_view str) {
+        tables[thread].intern(str);
+      });
+  auto interned = std::chrono::steady_clock::now();
+
+  // The strings of the other tables remain valid while they are merged, so
+  // are interned without copying.
+  auto& merged = tables[0];
+  std::vector<std::string_view> strs(MERGE_BATCH);
+  std::vector<const std::string*> out(MERGE_BATCH);
+  for (unsigned int thread = 1; thread < threads; thread++) {
+    const auto& table = tables[thread];
+    std::uint32_t size = table.size();
+    for (std::uint32_t id = 0; id < size; id += MERGE_BATCH) {
+      std::size_t n = std::min<std::size_t>(MERGE_BATCH, size - id);
+      for (std::size_t i = 0; i < n; i++) {
+        strs[i] = table.lookup(id + static_cast<std::uint32_t>(i));
+      }
+      merged.intern_batch(strs.data(), n, out.data());
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  result.interned = merged.size();
+  result.intern = interned - start;
+  result.merge = end - interned;
+  result.metrics = get_stats();
+  result.busy = stopwatch.measure();
+  return result;
+}
+
+/// @brief Intern into one concurrent table shared by all threads.
+auto run_shared(const std::vector<std::string_view>& chunks,
+    unsigned int threads, tokenizer t) -> pipeline_result {
+  pipeline_result result{};
+  ubench::measure::busy_stop_watch stopwatch{};
+  reset_alloc();
+
+  // 8 million buckets over 64 shards.
+  ubench::string::str_intern_concurrent table{64, 4096, 1 << 23};
+  auto start = std::chrono::steady_clock::now();
+  result.words = run_workers(chunks, threads, t,
+      [&table](unsigned int, std::string_view str) { table.intern(str); });
+  auto end = std::chrono::steady_clock::now();
+
+  result.interned = table.size();
+  result.intern = end - start;
+  result.metrics = get_stats();
+  result.busy = stopwatch.measure();
+  return result;
+}
+
+auto to_ms(std::chrono::nanoseconds t) -> std::string {
+  return std::to_string(
+      std::chrono::duration_cast<std::chrono::milliseconds>(t).count());
+}
+
+}  // namespace
+
+auto run_pipeline(const options& options) -> int {
+  tokenizer t = options.reader() == reader_impl::mmap_scalar
+                    ? tokenizer::scalar
+                    : best_tokenizer();
+  mmapbuff file{options.path(), t};
+  if (file.error() != 0) {
+    std::cerr << "Error: Couldn't read " << options.path().string() << " - "
+              << std::strerror(file.error()) << std::endl;
+    return 1;
+  }
+  auto chunks = split_chunks(file.data(), t);
+
+  std::vector<pipeline_result> results{};
+  auto counts = thread_counts(options.threads());
+  for (unsigned int threads : counts) {
+    if (options.pipeline() == pipeline_impl::merge) {
+      results.push_back(run_merge(options, chunks, threads, t));
+    } else {
+      results.push_back(run_shared(chunks, threads, t));
+    }
+  }
+
+  ubench::measure::table table{};
+  table.add_column("Threads");
+  for (unsigned int threads : counts) {
+    table.add_column(
+        std::to_string(threads), ubench::measure::alignment::right);
+  }
+
+  auto add_row = [&](const std::string& name, auto&& get) {
+    std::vector<std::string> line{name};
+    for (const auto& result : results) {
+      line.push_back(get(result));
+    }
+    table.add_line(std::move(line));
+  };
+  add_row("Pipeline", [&](const pipeline_result&) {
+    return options.pipeline_s();
+  });
+  add_row("Tokenizer", [&](const pipeline_result&) {
+    return std::string{tokenizer_name(t)};
+  });
+  add_row("Hash", [&](const pipeline_result&) { return options.hash_s(); });
+  add_row("Chunks", [&](const pipeline_result&) {
+    return std::to_string(chunks.size());
+  });
+  add_row("Words", [](const pipeline_result& r) {
+    return std::to_string(r.words);
+  });
+  add_row("Interned Words", [](const pipeline_result& r) {
+    return std::to_string(r.interned);
+  });
+  add_row("Max Allocated Mem (bytes)", [](const pipeline_result& r) {
+    return std::to_string(r.metrics.max_alloc);
+  });
+  add_row("Intern Time (ms)", [](const pipeline_result& r) {
+    return to_ms(r.intern);
+  });
+  add_row("Merge Time (ms)", [](const pipeline_result& r) {
+    return to_ms(r.merge);
+  });
+  add_row("Process Time (ms)", [](const pipeline_result& r) {
+    return std::to_string(r.busy.cpu_time.count());
+  });
+  add_row("Elapsed Time (ms)", [](const pipeline_result& r) {
+    return std::to_string(r.busy.run_time.count());
+  });
+  add_row("Throughput (words/s)", [](const pipeline_result& r) {
+    std::chrono::duration<double> elapsed = r.intern + r.merge;
+    if (elapsed.count() <= 0) return std::string{"-"};
+    return std::to_string(
+        static_cast<std::uint64_t>(static_cast<double>(r.words) /
+                                   elapsed.count()));
+  });
+  std::cout << table << std::endl;
+  return 0;
+}
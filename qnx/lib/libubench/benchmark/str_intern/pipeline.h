@@ -0,0 +1,20 @@
+#ifndef BENCHMARK_STRINTERN_PIPELINE_H
+#define BENCHMARK_STRINTERN_PIPELINE_H
+
+#include "options.h"
+
+/// @brief Intern the file in parallel chunks, and print the results.
+///
+/// The file is mapped into memory and split into chunks that end at
+/// whitespace. Worker threads take the next chunk, tokenize it and intern the
+/// words, either into a table for each thread that are merged at the end, or
+/// into a single concurrent table. This is repeated for every power of two
+/// threads up to the number the user gives, and each is a column of the table.
+///
+/// @param options the user options, giving the file, the pipeline and the
+/// maximum number of threads.
+///
+/// @return the exit code, which is non-zero if the file couldn't be read.
+auto run_pipeline(const options& options) -> int;
+
+#endif
@@ -9,6 +9,10 @@
 
 class readbuff {
  public:
+  /// @brief Tokens are only valid until the next call to get_token(), as the
+  /// buffer is reused.
+  static constexpr bool stable_tokens = false;
+
   readbuff(std::filesystem::path path);
   readbuff(const readbuff&) = delete;
   auto operator=(const readbuff&) -> readbuff& = delete;
@@ -1,53 +1,574 @@
 #include "str_intern.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "ubench/clock.h"
 #include "ubench/measure/busy_measurement.h"
+#include "ubench/measure/perf_counters.h"
 #include "ubench/measure/print.h"
 #include "ubench/str_intern.h"
+#include "ubench/str_intern_arena.h"
+#include "ubench/str_intern_concurrent.h"
 #include "allocator.h"
+#include "corpus.h"
+#include "latency.h"
+#include "membuff.h"
+#include "mmapbuff.h"
 #include "options.h"
+#include "pipeline.h"
 #include "readbuff.h"
+#include "whitespace.h"
 
-auto print_stats(const options& options, const mem_metrics& metrics,
+/// @brief The number of rows of the chain length histogram to print. Longer
+/// chains are added together in the last row.
+constexpr std::size_t CHAIN_ROWS = 8;
+
+/// @brief The results of one implementation, as the name and value of each
+/// row, in the order printed.
+using result_rows = std::vector<std::pair<std::string, std::string>>;
+
+/// @brief The results of one run of an implementation.
+struct run_result {
+  result_rows rows;                  //< The results to print.
+  std::chrono::nanoseconds elapsed;  //< The time, to compare repetitions.
+};
+
+/// @brief Add the statistics of the libubench implementations to the rows.
+auto add_intern_stats(result_rows& rows,
+    const ubench::string::str_intern_stats& stats, std::size_t buckets)
+    -> void {
+  rows.emplace_back("Buckets", std::to_string(buckets));
+  for (std::size_t n = 0; n < stats.chain_lengths.size(); n++) {
+    if (n == CHAIN_ROWS) {
+      std::size_t longer = 0;
+      for (std::size_t m = n; m < stats.chain_lengths.size(); m++) {
+        longer += stats.chain_lengths[m];
+      }
+      rows.emplace_back("Chain Length " + std::to_string(n) + "+",
+          std::to_string(longer));
+      break;
+    }
+    rows.emplace_back("Chain Length " + std::to_string(n),
+        std::to_string(stats.chain_lengths[n]));
+  }
+  rows.emplace_back("Longest Probe", std::to_string(stats.longest_probe));
+  rows.emplace_back(
+      "String Memory (bytes)", std::to_string(stats.string_bytes));
+  rows.emplace_back("Table Memory (bytes)", std::to_string(stats.table_bytes));
+  rows.emplace_back("Rehashes", std::to_string(stats.rehashes));
+  if (stats.counters) {
+    rows.emplace_back("Rehash Time (us)",
+        std::to_string(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                stats.rehash_time)
+                .count()));
+    rows.emplace_back("Hits", std::to_string(stats.hits));
+    rows.emplace_back("Misses", std::to_string(stats.misses));
+  }
+}
+
+/// @brief The printable name of the reader, with the tokenizer it uses.
+auto reader_name(reader_impl reader) -> std::string {
+  switch (reader) {
+    case reader_impl::mmap:
+      return "mmap (" + std::string{tokenizer_name(best_tokenizer())} + ")";
+    case reader_impl::mmap_scalar:
+      return "mmap (scalar)";
+    case reader_impl::read:
+    default:
+      return "read";
+  }
+}
+
+/// @brief The results common to every implementation.
+///
+/// @param batch the number of words interned with each call, which is one if
+/// the implementation has no intern_batch().
+///
+/// @param hash the name of the hash function the implementation uses.
+auto make_rows(const options& options, const mem_metrics& metrics,
     const ubench::measure::busy_measurement& end, std::size_t words,
-    std::size_t interned) -> void {
-  ubench::measure::table table{};
+    std::size_t interned, std::size_t batch, const std::string& hash)
+    -> result_rows {
+  result_rows rows{};
+  rows.emplace_back("Threads", std::to_string(options.threads()));
+  rows.emplace_back("Batch", std::to_string(batch));
+  rows.emplace_back("Hash", hash);
+  rows.emplace_back("Reader", options.generate() || options.all()
+                                  ? std::string{"memory"}
+                                  : reader_name(options.reader()));
+  rows.emplace_back("Words", std::to_string(words));
+  rows.emplace_back("Interned Words", std::to_string(interned));
+  rows.emplace_back(
+      "Currently Allocated (bytes)", std::to_string(metrics.current_alloc));
+  rows.emplace_back(
+      "Max Allocated Mem (bytes)", std::to_string(metrics.max_alloc));
+  rows.emplace_back(
+      "Total Allocated Mem (bytes)", std::to_string(metrics.total_alloc));
+  rows.emplace_back(
+      "Total Freed Mem (bytes)", std::to_string(metrics.total_free));
+  rows.emplace_back("Allocation Count", std::to_string(metrics.allocs));
+  rows.emplace_back("Free Count", std::to_string(metrics.frees));
+  rows.emplace_back("Process Time (ms)", std::to_string(end.cpu_time.count()));
+  rows.emplace_back("System Time (ms)", std::to_string(end.busy_time.count()));
+  rows.emplace_back("Elapsed Time (ms)", std::to_string(end.run_time.count()));
+  return rows;
+}
 
+/// @brief Add the percentiles of a histogram to the rows.
+///
+/// @param prefix the start of the name of each row.
+///
+/// @param percentiles the percentiles to add, before the maximum.
+auto add_percentiles(result_rows& rows, const std::string& prefix,
+    const latency_histogram& latency, std::initializer_list<double> percentiles)
+    -> void {
+  for (double p : percentiles) {
+    std::ostringstream name{};
+    name << prefix << " p" << p << " (ns)";
+    rows.emplace_back(
+        name.str(), std::to_string(latency.percentile(p).count()));
+  }
+  rows.emplace_back(
+      prefix + " max (ns)", std::to_string(latency.max().count()));
+}
+
+/// @brief Add the latencies of the calls timed to the rows.
+///
+/// @param rehashes if the implementation can tell when it rehashed.
+auto add_latency_rows(
+    result_rows& rows, const latency_recorder& latency, bool rehashes) -> void {
+  latency_histogram total{latency.hits()};
+  total.merge(latency.misses());
+  rows.emplace_back("Latency Sample (1 in)", std::to_string(latency.every()));
+  add_percentiles(rows, "Latency", total, {50.0, 90.0, 99.0, 99.9, 99.99});
+  rows.emplace_back("Hit Calls", std::to_string(latency.hits().count()));
+  add_percentiles(
+      rows, "Hit Latency", latency.hits(), {50.0, 90.0, 99.0, 99.9});
+  rows.emplace_back("Miss Calls", std::to_string(latency.misses().count()));
+  add_percentiles(
+      rows, "Miss Latency", latency.misses(), {50.0, 90.0, 99.0, 99.9});
+  if (rehashes) {
+    rows.emplace_back(
+        "Rehash Calls", std::to_string(latency.rehashes().count()));
+    rows.emplace_back("Rehash Latency max (ns)",
+        std::to_string(latency.rehashes().max().count()));
+  }
+}
+
+/// @brief Add the hardware events counted to the rows, for each word.
+///
+/// An event that couldn't be counted is left out.
+auto add_perf_rows(result_rows& rows,
+    const ubench::measure::perf_sample& sample, std::size_t words) -> void {
+  auto per_word = [words](std::uint64_t value) {
+    std::ostringstream str{};
+    str << std::fixed << std::setprecision(2)
+        << (words ? static_cast<double>(value) / static_cast<double>(words)
+                  : 0.0);
+    return str.str();
+  };
+  for (std::size_t e = 0; e < ubench::measure::perf_event_count; e++) {
+    if (!sample.values[e]) continue;
+    rows.emplace_back(
+        std::string{ubench::measure::perf_event_name(
+            static_cast<ubench::measure::perf_event>(e))} +
+            "/Word",
+        per_word(*sample.values[e]));
+  }
+
+  auto cycles = sample.get(ubench::measure::perf_event::cycles);
+  auto instructions = sample.get(ubench::measure::perf_event::instructions);
+  if (cycles && instructions && *cycles > 0) {
+    std::ostringstream ipc{};
+    ipc << std::fixed << std::setprecision(2)
+        << static_cast<double>(*instructions) / static_cast<double>(*cycles);
+    rows.emplace_back("IPC", ipc.str());
+  }
+  if (sample.scaled) rows.emplace_back("Perf Scaled", "yes");
+}
+
+/// @brief Print the results of the implementations, a column for each.
+///
+/// A row that only some implementations have, such as the statistics of
+/// libubench, is put after the row before it, and the other implementations
+/// print a dash.
+///
+/// @param names the name of each implementation.
+///
+/// @param results the results of each implementation.
+auto print_results(const std::vector<std::string>& names,
+    const std::vector<result_rows>& results) -> void {
+  std::vector<std::string> row_names{};
+  for (const auto& rows : results) {
+    auto pos = row_names.begin();
+    for (const auto& row : rows) {
+      auto it = std::find(row_names.begin(), row_names.end(), row.first);
+      if (it == row_names.end()) it = row_names.insert(pos, row.first);
+      pos = it + 1;
+    }
+  }
+
+  ubench::measure::table table{};
   table.add_column("Metric");
-  table.add_column(options.strintern_s(), ubench::measure::alignment::right);
-
-  table.add_line({"Words", std::to_string(words)});
-  table.add_line({"Interned Words", std::to_string(interned)});
-  table.add_line(
-      {"Currently Allocated (bytes)", std::to_string(metrics.current_alloc)});
-  table.add_line(
-      {"Max Allocated Mem (bytes)", std::to_string(metrics.max_alloc)});
-  table.add_line(
-      {"Total Allocated Mem (bytes)", std::to_string(metrics.total_alloc)});
-  table.add_line(
-      {"Total Freed Mem (bytes)", std::to_string(metrics.total_free)});
-  table.add_line({"Allocation Count", std::to_string(metrics.allocs)});
-  table.add_line({"Free Count", std::to_string(metrics.frees)});
-  table.add_line({"Process Time (ms)", std::to_string(end.cpu_time.count())});
-  table.add_line({"System Time (ms)", std::to_string(end.busy_time.count())});
-  table.add_line({"Elapsed Time (ms)", std::to_string(end.run_time.count())});
+  for (const auto& name : names) {
+    table.add_column(name, ubench::measure::alignment::right);
+  }
+  for (const auto& row_name : row_names) {
+    std::vector<std::string> line{row_name};
+    for (const auto& rows : results) {
+      auto it = std::find_if(rows.begin(), rows.end(),
+          [&row_name](const auto& row) { return row.first == row_name; });
+      line.push_back(it == rows.end() ? std::string{"-"} : it->second);
+    }
+    table.add_line(std::move(line));
+  }
   std::cout << table << std::endl;
 }
 
-auto main(int argc, char* argv[]) -> int {
-  auto options = make_options(argc, argv);
-  if (!options) return options.error();
+/// @brief Open the file with the reader the user chose.
+///
+/// @tparam F the function to read the file.
+///
+/// @param options the user options, giving the file and the reader.
+///
+/// @param input the generated words to read instead of the file, or nullptr.
+///
+/// @param run the function called with the reader. It returns the number of
+/// words read.
+///
+/// @return the number of words read.
+template <typename F>
+auto with_reader(const options& options, const corpus* input, F&& run)
+    -> std::size_t {
+  if (input) {
+    membuff buff{input->tokens()};
+    return run(buff);
+  }
+
+  switch (options.reader()) {
+    case reader_impl::mmap: {
+      mmapbuff buff{options.path(), best_tokenizer()};
+      return run(buff);
+    }
+    case reader_impl::mmap_scalar: {
+      mmapbuff buff{options.path(), tokenizer::scalar};
+      return run(buff);
+    }
+    case reader_impl::read:
+    default: {
+      readbuff buff{options.path()};
+      return run(buff);
+    }
+  }
+}
+
+/// @brief Read the file and intern every word.
+///
+/// @tparam R the reader, readbuff, mmapbuff or membuff.
+///
+/// @tparam F the function to intern a single word.
+///
+/// @param buff the reader of the file.
+///
+/// @param intern the function called for every word.
+///
+/// @return the number of words read.
+template <typename R, typename F>
+auto intern_file(R& buff, F&& intern) -> std::size_t {
+  std::size_t w = 0;
+  while (true) {
+    auto token = buff.get_token();
+    if (!token) break;
+    w++;
+    intern(*token);
+  }
+  return w;
+}
+
+/// @brief Read the file and intern the words in batches.
+///
+/// If the reader reuses its buffer, the words of a batch are copied, as the
+/// buffer would be overwritten before the batch is complete.
+///
+/// @tparam R the reader, readbuff, mmapbuff or membuff.
+///
+/// @tparam F the function to intern a batch of words.
+///
+/// @param buff the reader of the file.
+///
+/// @param batch the number of words in a batch.
+///
+/// @param intern the function called with a pointer to the words of every
+/// batch and the number of words, which is less than batch for the last one.
+///
+/// @return the number of words read.
+template <typename R, typename F>
+auto intern_file_batch(R& buff, std::size_t batch, F&& intern)
+    -> std::size_t {
+  std::vector<std::string> tokens(R::stable_tokens ? 0 : batch);
+  std::vector<std::string_view> views(batch);
+  std::size_t w = 0;
+  std::size_t n = 0;
+  while (true) {
+    auto token = buff.get_token();
+    if (!token) break;
+    w++;
+    if constexpr (R::stable_tokens) {
+      views[n] = *token;
+    } else {
+      tokens[n].assign(*token);
+      views[n] = tokens[n];
+    }
+    n++;
+    if (n == batch) {
+      intern(views.data(), n);
+      n = 0;
+    }
+  }
+  if (n > 0) intern(views.data(), n);
+  return w;
+}
+
+/// @brief Run a function on every thread at the same time.
+///
+/// With one thread, the function is run on the current thread.
+///
+/// @tparam F the function that reads and interns the file.
+///
+/// @param options the user options, giving the number of threads.
+///
+/// @param run the function called on every thread, with the index of the
+/// thread. It returns the number of words read.
+///
+/// @return the number of words read by all threads.
+template <typename F>
+auto run_threads(const options& options, F&& run) -> std::size_t {
+  if (options.threads() == 1) return run(0);
+
+  std::atomic<std::size_t> words{0};
+  std::vector<std::thread> workers{};
+  for (unsigned int t = 0; t < options.threads(); t++) {
+    workers.emplace_back([&run, &words, t]() { words += run(t); });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return words;
+}
+
+/// @brief Read and intern the file on every thread at the same time.
+///
+/// @tparam F the function to intern a single word. It must be thread-safe.
+///
+/// @param options the user options, giving the file and the number of threads.
+///
+/// @param input the generated words to read instead of the file, or nullptr.
+///
+/// @param intern the function called for every word, with the index of the
+/// thread and the word.
+///
+/// @return the number of words read by all threads.
+template <typename F>
+auto intern_threads(const options& options, const corpus* input, F&& intern)
+    -> std::size_t {
+  return run_threads(options, [&options, input, &intern](unsigned int t) {
+    return with_reader(options, input, [&intern, t](auto& buff) {
+      return intern_file(
+          buff, [&intern, t](std::string_view token) { intern(t, token); });
+    });
+  });
+}
+
+/// @brief The type an implementation returns from intern_batch(), if it has
+/// one.
+template <typename T, typename Out>
+auto batch_out(void (T::*)(const std::string_view*, std::size_t, Out*))
+    -> Out;
+
+template <typename T, typename = void>
+struct has_stats : std::false_type {};
+
+template <typename T>
+struct has_stats<T, std::void_t<decltype(std::declval<const T&>().stats())>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct has_bucket_count : std::false_type {};
+
+template <typename T>
+struct has_bucket_count<T,
+    std::void_t<decltype(std::declval<const T&>().bucket_count())>>
+    : std::true_type {};
 
-  readbuff buff{options->path()};
+template <typename T, typename = void>
+struct has_intern_batch : std::false_type {};
+
+template <typename T>
+struct has_intern_batch<T, std::void_t<decltype(batch_out(&T::intern_batch))>>
+    : std::true_type {};
+
+/// @brief Intern the file on all threads, and return the results.
+///
+/// @tparam T the interning implementation, which has the methods intern() and
+/// size(). If it has intern_batch(), that is used when the user asks for a
+/// batch larger than one.
+///
+/// @param options the user options.
+///
+/// @param input the generated words to intern instead of the file, or nullptr.
+///
+/// @param stopwatch measures from the start of the test.
+///
+/// @param perf counts the hardware events from the start of the test, if the
+/// user asked for them.
+///
+/// @param intern the object to intern the strings with.
+///
+/// @param thread_safe if the object may be used by more than one thread at the
+/// same time. If not, a mutex is used when running with more than one thread.
+///
+/// @return the results of the run.
+template <typename T>
+auto run_intern(const options& options, const corpus* input,
+    ubench::measure::busy_stop_watch& stopwatch,
+    std::optional<ubench::measure::perf_counters>& perf, T& intern,
+    bool thread_safe) -> run_result {
+  std::mutex intern_mutex{};
+  bool serialise = !thread_safe && options.threads() > 1;
+  auto intern_token = [&](std::string_view token) {
+    if (serialise) {
+      std::lock_guard<std::mutex> lock{intern_mutex};
+      intern.intern(token);
+    } else {
+      intern.intern(token);
+    }
+  };
+
+  // Time a call, and find if it was a miss or rehashed the table. The table
+  // is read under the lock, so that other threads don't change it in between,
+  // except for a table that is thread safe.
+  auto intern_timed = [&](latency_recorder& latency, std::string_view token) {
+    std::unique_lock<std::mutex> lock{intern_mutex, std::defer_lock};
+    if (serialise) lock.lock();
+    auto size = intern.size();
+    std::size_t buckets = 0;
+    if constexpr (has_bucket_count<T>::value) buckets = intern.bucket_count();
+    auto start = ubench::chrono::cycle_clock::ticks();
+    intern.intern(token);
+    auto ticks = ubench::chrono::cycle_clock::ticks() - start;
+    bool rehash = false;
+    if constexpr (has_bucket_count<T>::value) {
+      rehash = intern.bucket_count() != buckets;
+    }
+    latency.record(ubench::chrono::cycle_clock::to_duration(ticks),
+        intern.size() != size, rehash);
+  };
+
+  // One recorder for each thread, so that they don't share cache lines.
+  std::vector<latency_recorder> latency(
+      options.latency() ? options.threads() : 0,
+      latency_recorder{options.sample()});
+
+  std::size_t w = 0;
+  bool batched = false;
+  std::string hash{"std"};
+  if constexpr (has_intern_batch<T>::value) {
+    batched = options.batch() > 1;
+    hash = options.hash_s();
+  }
+  if (batched) {
+    if constexpr (has_intern_batch<T>::value) {
+      using out_t = decltype(batch_out(&T::intern_batch));
+      w = run_threads(options, [&](unsigned int) {
+        std::vector<out_t> out(options.batch());
+        return with_reader(options, input, [&](auto& buff) {
+          return intern_file_batch(buff, options.batch(),
+              [&](const std::string_view* tokens, std::size_t n) {
+                if (serialise) {
+                  std::lock_guard<std::mutex> lock{intern_mutex};
+                  intern.intern_batch(tokens, n, out.data());
+                } else {
+                  intern.intern_batch(tokens, n, out.data());
+                }
+              });
+        });
+      });
+    }
+  } else {
+    w = intern_threads(
+        options, input, [&](unsigned int t, std::string_view token) {
+          if (latency.empty() || !latency[t].sample()) {
+            intern_token(token);
+          } else {
+            intern_timed(latency[t], token);
+          }
+        });
+  }
+  if (perf) perf->stop();
+  auto metrics = get_stats();
+  auto end = stopwatch.measure();
+  auto elapsed =
+      std::chrono::high_resolution_clock::now() - stopwatch.start_time();
+
+  auto rows = make_rows(options, metrics, end, w, intern.size(),
+      batched ? options.batch() : 1, hash);
+  if (!latency.empty()) {
+    latency_recorder total{options.sample()};
+    for (const auto& l : latency) {
+      total.merge(l);
+    }
+    add_latency_rows(rows, total, has_bucket_count<T>::value);
+  }
+  if (perf) add_perf_rows(rows, perf->read(), w);
+  if constexpr (has_stats<T>::value) {
+    add_intern_stats(rows, intern.stats(), intern.bucket_count());
+  }
+  return {std::move(rows), elapsed};
+}
+
+/// @brief Construct an implementation and intern the words with it.
+///
+/// The memory allocated and the time taken are measured from before the
+/// implementation is constructed.
+///
+/// @param options the user options.
+///
+/// @param impl the implementation to test.
+///
+/// @param input the generated words to intern instead of the file, or nullptr.
+///
+/// @return the results of the run, or nothing if the implementation is
+/// unknown.
+auto run_impl(const options& options, strintern_impl impl, const corpus* input)
+    -> std::optional<run_result> {
+  std::optional<ubench::measure::perf_counters> perf{};
+  if (options.perf()) perf.emplace();
   ubench::measure::busy_stop_watch stopwatch{};
   reset_alloc();
+  if (perf) perf->start();
 
   std::unique_ptr<str_intern> intern{};
-  switch (options->strintern()) {
+  switch (impl) {
     case strintern_impl::none:
       intern = std::make_unique<intern_none>();
       break;
@@ -81,37 +602,195 @@ auto main(int argc, char* argv[]) -> int {
       intern = std::make_unique<intern_var_set_pmr>(4096, 1 << 23);
       break;
     case strintern_impl::ubench:
+    case strintern_impl::ubench_flat:
+    case strintern_impl::ubench_arena:
+    case strintern_impl::ubench_incremental:
+    case strintern_impl::ubench_flat_incremental:
+    case strintern_impl::ubench_concurrent:
       break;
     default:
-      std::cerr << "Unknown intern implementation to test with." << std::endl;
-      return 2;
+      return std::nullopt;
   }
 
-  std::size_t w = 0;
   if (intern) {
-    while (true) {
-      auto token = buff.get_token();
-      if (!token) break;
-      w++;
-      intern->intern(*token);
+    return run_intern(options, input, stopwatch, perf, *intern, false);
+  }
+
+  // the library doesn't implement the abstract class, which was intended for
+  // testing only.
+  switch (impl) {
+    case strintern_impl::ubench: {
+      ubench::string::str_intern uintern{4096, 1 << 20,
+          ubench::string::str_intern_backend::chained,
+          ubench::string::str_intern_rehash::full, options.hash()};
+      return run_intern(options, input, stopwatch, perf, uintern, false);
     }
-    auto metrics = get_stats();
-    auto end = stopwatch.measure();
-    print_stats(*options, metrics, end, w, intern->size());
-  } else {
-    // the library doesn't implement the abstract class, which was intended for
-    // testing only.
-    ubench::string::str_intern uintern{};
+    case strintern_impl::ubench_flat: {
+      ubench::string::str_intern uintern{4096, 1 << 20,
+          ubench::string::str_intern_backend::open_addressing,
+          ubench::string::str_intern_rehash::full, options.hash()};
+      return run_intern(options, input, stopwatch, perf, uintern, false);
+    }
+    case strintern_impl::ubench_incremental: {
+      ubench::string::str_intern uintern{4096, 1 << 20,
+          ubench::string::str_intern_backend::chained,
+          ubench::string::str_intern_rehash::incremental, options.hash()};
+      return run_intern(options, input, stopwatch, perf, uintern, false);
+    }
+    case strintern_impl::ubench_flat_incremental: {
+      ubench::string::str_intern uintern{4096, 1 << 20,
+          ubench::string::str_intern_backend::open_addressing,
+          ubench::string::str_intern_rehash::incremental, options.hash()};
+      return run_intern(options, input, stopwatch, perf, uintern, false);
+    }
+    case strintern_impl::ubench_arena: {
+      ubench::string::str_intern_arena uintern{4096, 1 << 20,
+          ubench::string::str_intern_backend::chained,
+          ubench::string::str_intern_rehash::full, options.hash()};
+      return run_intern(options, input, stopwatch, perf, uintern, false);
+    }
+    case strintern_impl::ubench_concurrent: {
+      // 8 million buckets over 64 shards.
+      ubench::string::str_intern_concurrent uintern{64, 4096, 1 << 23};
+      return run_intern(options, input, stopwatch, perf, uintern, true);
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+/// @brief Run an implementation with warm-up runs and repetitions.
+///
+/// The results of the repetition with the median elapsed time are returned.
+/// With more than one repetition, the minimum, median and maximum elapsed
+/// times are added after the elapsed time.
+///
+/// @param options the user options, giving the number of runs.
+///
+/// @param impl the implementation to test.
+///
+/// @param input the words to intern instead of the file, or nullptr.
+///
+/// @return the results to print, or nothing if the implementation is unknown.
+auto run_repeated(const options& options, strintern_impl impl,
+    const corpus* input) -> std::optional<result_rows> {
+  for (unsigned int w = 0; w < options.warmup(); w++) {
+    if (!run_impl(options, impl, input)) return std::nullopt;
+  }
+
+  std::vector<run_result> runs{};
+  for (unsigned int r = 0; r < options.repeat(); r++) {
+    auto result = run_impl(options, impl, input);
+    if (!result) return std::nullopt;
+    runs.push_back(std::move(*result));
+  }
+  std::sort(runs.begin(), runs.end(),
+      [](const run_result& a, const run_result& b) {
+        return a.elapsed < b.elapsed;
+      });
+
+  auto rows = std::move(runs[runs.size() / 2].rows);
+  if (runs.size() > 1) {
+    auto us = [](std::chrono::nanoseconds t) {
+      return std::to_string(
+          std::chrono::duration_cast<std::chrono::microseconds>(t).count());
+    };
+    auto it = std::find_if(rows.begin(), rows.end(),
+        [](const auto& row) { return row.first == "Elapsed Time (ms)"; });
+    if (it != rows.end()) it++;
+    rows.insert(it,
+        {{"Repetitions", std::to_string(runs.size())},
+            {"Elapsed Min (us)", us(runs.front().elapsed)},
+            {"Elapsed Median (us)", us(runs[runs.size() / 2].elapsed)},
+            {"Elapsed Max (us)", us(runs.back().elapsed)}});
+  }
+  return rows;
+}
+
+/// @brief Read every word of the file into memory.
+///
+/// @param options the user options, giving the file and the reader.
+///
+/// @return the words of the file.
+auto load_corpus(const options& options) -> corpus {
+  corpus input{};
+  with_reader(options, nullptr, [&input](auto& buff) {
+    std::size_t w = 0;
     while (true) {
       auto token = buff.get_token();
       if (!token) break;
+      input.append(*token);
       w++;
-      uintern.intern(*token);
     }
-    auto metrics = get_stats();
-    auto end = stopwatch.measure();
-    print_stats(*options, metrics, end, w, uintern.size());
+    return w;
+  });
+  input.finish();
+  return input;
+}
+
+auto main(int argc, char* argv[]) -> int {
+  auto options = make_options(argc, argv);
+  if (!options) return options.error();
+
+  if (options->pipeline() != pipeline_impl::none) {
+    return run_pipeline(*options);
+  }
+
+  // The clock used for the latency is measured once, before the first run is
+  // timed.
+  if (options->latency()) {
+    static_cast<void>(ubench::chrono::cycle_clock::ns_per_tick());
+    if (!ubench::chrono::cycle_clock::is_invariant()) {
+      std::cerr << "Warning: The cycle counter may not run at a constant "
+                   "rate, the latencies may be wrong"
+                << std::endl;
+    }
+  }
+
+  if (options->perf()) {
+    ubench::measure::perf_counters perf{};
+    if (!perf.is_available()) {
+      std::cerr << "Warning: Hardware performance counters aren't available - "
+                << std::strerror(perf.error()) << std::endl;
+    }
+  }
+
+  // The words are generated, or the file read for every implementation, before
+  // any measurement, so that every implementation interns the same words
+  // without the time to read the file.
+  corpus input{};
+  if (options->generate()) {
+    try {
+      input = generate_corpus(options->corpus());
+    } catch (const std::invalid_argument& e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      return 1;
+    }
+  } else if (options->all()) {
+    input = load_corpus(*options);
   }
+  const corpus* words =
+      options->generate() || options->all() ? &input : nullptr;
 
+  std::vector<std::string> names{};
+  std::vector<result_rows> results{};
+  if (options->all()) {
+    for (const auto& [name, impl] : strintern_names()) {
+      if (impl == strintern_impl::flist) continue;
+      auto rows = run_repeated(*options, impl, words);
+      if (!rows) continue;
+      names.emplace_back(name);
+      results.push_back(std::move(*rows));
+    }
+  } else {
+    auto rows = run_repeated(*options, options->strintern(), words);
+    if (!rows) {
+      std::cerr << "Unknown intern implementation to test with." << std::endl;
+      return 2;
+    }
+    names.push_back(options->strintern_s());
+    results.push_back(std::move(*rows));
+  }
+  print_results(names, results);
   return 0;
 }
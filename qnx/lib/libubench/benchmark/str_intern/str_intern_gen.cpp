@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "ubench/options.h"
+#include "corpus.h"
+
+namespace {
+
+void print_help(std::string_view prog_name) {
+  std::cout << prog_name
+            << " [-s<seed>] [-n<words>] [-v<vocabulary>] [-z<skew>] "
+               "[-l<min>,<mean>,<max>] [-u<unique>] <file>"
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "Writes a corpus of random words for the str_intern benchmark"
+            << std::endl;
+}
+
+/// @brief The number of words on each line of the file.
+constexpr std::size_t WORDS_PER_LINE = 12;
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  bool help = false;
+  int err = 0;
+
+  corpus_params params{};
+  ubench::options opts{argc, argv, "s:n:v:z:l:u:?"};
+  for (const auto& opt : opts) {
+    if (opt) {
+      if (opt->get_option() == '?') {
+        help = true;
+        continue;
+      }
+      // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+      auto arg = *opt->argument();
+      if (!parse_corpus_option(opt->get_option(), arg, params)) err = 1;
+    } else {
+      err = 1;
+      ubench::options::print_error(opt.error());
+    }
+  }
+
+  if (opts.args().size() != 1) {
+    err = 1;
+    std::cerr << "Error: Must provide exactly one file to write" << std::endl;
+  }
+
+  if (err || help) {
+    if (err) std::cerr << std::endl;
+    print_help(opts.prog_name());
+    return err;
+  }
+
+  std::string path{opts.args()[0]};
+  std::ofstream file{path, std::ios::out | std::ios::trunc | std::ios::binary};
+  if (!file) {
+    std::cerr << "Error: Couldn't create " << path << std::endl;
+    return 1;
+  }
+
+  try {
+    corpus_generator gen{params};
+    std::size_t w = 0;
+    while (auto word = gen.next()) {
+      if (w > 0) file << (w % WORDS_PER_LINE == 0 ? '\n' : ' ');
+      file << *word;
+      w++;
+    }
+    if (w > 0) file << '\n';
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  file.close();
+  if (!file) {
+    std::cerr << "Error: Couldn't write " << path << std::endl;
+    return 1;
+  }
+  return 0;
+}
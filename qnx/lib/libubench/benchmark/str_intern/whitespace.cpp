@@ -0,0 +1,172 @@
+#include "whitespace.h"
+
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define WHITESPACE_SSE2 1
+#endif
+#if defined(__GNUC__)
+// AVX2 is compiled with the target attribute, and used only if the processor
+// has it.
+#include <immintrin.h>
+#define WHITESPACE_AVX2 1
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define WHITESPACE_NEON 1
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+
+namespace {
+
+/// @brief If the character is whitespace in the "C" locale.
+///
+/// The characters '\t' to '\r' are consecutive, so are found with a single
+/// unsigned compare.
+constexpr auto is_space(char c) noexcept -> bool {
+  auto u = static_cast<unsigned char>(c);
+  return u == ' ' || static_cast<unsigned char>(u - '\t') <= '\r' - '\t';
+}
+
+/// @brief Find the first character that is (or isn't) whitespace.
+///
+/// @tparam Space true to find whitespace, false to find anything else.
+template <bool Space>
+auto find_scalar(const char* p, const char* end) noexcept -> const char* {
+  while (p < end && is_space(*p) != Space) p++;
+  return p;
+}
+
+#if WHITESPACE_SSE2
+/// @brief A bit for each of the 16 characters that is whitespace.
+auto space_mask_sse2(__m128i v) noexcept -> unsigned int {
+  __m128i ctl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+  ctl = _mm_cmpeq_epi8(_mm_min_epu8(ctl, _mm_set1_epi8('\r' - '\t')), ctl);
+  __m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+  return static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(ctl, sp)));
+}
+
+template <bool Space>
+auto find_sse2(const char* p, const char* end) noexcept -> const char* {
+  while (end - p >= 16) {
+    unsigned int m =
+        space_mask_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    if constexpr (!Space) m = ~m & 0xffffU;
+    if (m) return p + __builtin_ctz(m);
+    p += 16;
+  }
+  return find_scalar<Space>(p, end);
+}
+#endif
+
+#if WHITESPACE_AVX2
+/// @brief A bit for each of the 32 characters that is whitespace.
+__attribute__((target("avx2"))) auto space_mask_avx2(__m256i v) noexcept
+    -> std::uint32_t {
+  __m256i ctl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+  ctl = _mm256_cmpeq_epi8(
+      _mm256_min_epu8(ctl, _mm256_set1_epi8('\r' - '\t')), ctl);
+  __m256i sp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+  return static_cast<std::uint32_t>(
+      _mm256_movemask_epi8(_mm256_or_si256(ctl, sp)));
+}
+
+template <bool Space>
+__attribute__((target("avx2"))) auto find_avx2(
+    const char* p, const char* end) noexcept -> const char* {
+  while (end - p >= 32) {
+    std::uint32_t m = space_mask_avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    if constexpr (!Space) m = ~m;
+    if (m) return p + __builtin_ctz(m);
+    p += 32;
+  }
+  return find_scalar<Space>(p, end);
+}
+#endif
+
+#if WHITESPACE_NEON
+/// @brief Four bits for each of the 16 characters that is whitespace.
+///
+/// NEON has no move mask instruction. Shifting each 16-bit lane right by four
+/// and narrowing leaves four bits of each compare result in a 64-bit value.
+auto space_mask_neon(uint8x16_t v) noexcept -> std::uint64_t {
+  uint8x16_t ctl =
+      vcleq_u8(vsubq_u8(v, vdupq_n_u8('\t')), vdupq_n_u8('\r' - '\t'));
+  uint8x16_t sp = vceqq_u8(v, vdupq_n_u8(' '));
+  uint8x8_t nibbles =
+      vshrn_n_u16(vreinterpretq_u16_u8(vorrq_u8(ctl, sp)), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+
+template <bool Space>
+auto find_neon(const char* p, const char* end) noexcept -> const char* {
+  while (end - p >= 16) {
+    std::uint64_t m = space_mask_neon(
+        vld1q_u8(reinterpret_cast<const std::uint8_t*>(p)));
+    if constexpr (!Space) m = ~m;
+    if (m) return p + __builtin_ctzll(m) / 4;
+    p += 16;
+  }
+  return find_scalar<Space>(p, end);
+}
+#endif
+
+}  // namespace
+
+auto best_tokenizer() noexcept -> tokenizer {
+#if WHITESPACE_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return tokenizer::avx2;
+#endif
+#if WHITESPACE_SSE2
+  return tokenizer::sse2;
+#elif WHITESPACE_NEON
+  return tokenizer::neon;
+#else
+  return tokenizer::scalar;
+#endif
+}
+
+auto get_whitespace_finder(tokenizer t) noexcept -> whitespace_finder {
+  switch (t) {
+#if WHITESPACE_SSE2
+    case tokenizer::sse2:
+      return {&find_sse2<true>, &find_sse2<false>};
+#endif
+#if WHITESPACE_AVX2
+    case tokenizer::avx2:
+      if (best_tokenizer() != tokenizer::avx2) break;
+      return {&find_avx2<true>, &find_avx2<false>};
+#endif
+#if WHITESPACE_NEON
+    case tokenizer::neon:
+      return {&find_neon<true>, &find_neon<false>};
+#endif
+    default:
+      break;
+  }
+  return {&find_scalar<true>, &find_scalar<false>};
+}
+
+auto tokenizer_name(tokenizer t) noexcept -> std::string_view {
+  switch (t) {
+    case tokenizer::scalar:
+      return "scalar";
+    case tokenizer::sse2:
+      return "sse2";
+    case tokenizer::avx2:
+      return "avx2";
+    case tokenizer::neon:
+      return "neon";
+  }
+  return "unknown";
+}
+
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -0,0 +1,50 @@
+#ifndef BENCHMARK_STRINTERN_WHITESPACE_H
+#define BENCHMARK_STRINTERN_WHITESPACE_H
+
+#include <string_view>
+
+/// @brief The instructions used to find whitespace.
+enum class tokenizer {
+  scalar,  //< One character at a time.
+  sse2,    //< 16 characters at a time with SSE2.
+  avx2,    //< 32 characters at a time with AVX2.
+  neon,    //< 16 characters at a time with NEON.
+};
+
+/// @brief Functions to find whitespace in a buffer.
+///
+/// Whitespace is the same as isspace() in the "C" locale: space, tab, line
+/// feed, vertical tab, form feed and carriage return. The functions never read
+/// past the end of the buffer, so can be used on a memory mapped file.
+struct whitespace_finder {
+  /// @brief Find the first whitespace character from p up to end, or end if
+  /// there is none.
+  auto (*find_space)(const char* p, const char* end) noexcept -> const char*;
+
+  /// @brief Find the first character that isn't whitespace from p up to end,
+  /// or end if there is none.
+  auto (*find_word)(const char* p, const char* end) noexcept -> const char*;
+};
+
+/// @brief The fastest tokenizer that this processor supports.
+///
+/// @return the tokenizer to use.
+[[nodiscard]] auto best_tokenizer() noexcept -> tokenizer;
+
+/// @brief Get the functions for a tokenizer.
+///
+/// @param t the tokenizer. If the processor doesn't support it, the scalar
+/// functions are returned.
+///
+/// @return the functions to find whitespace.
+[[nodiscard]] auto get_whitespace_finder(tokenizer t) noexcept
+    -> whitespace_finder;
+
+/// @brief The printable name of a tokenizer.
+///
+/// @param t the tokenizer.
+///
+/// @return the name of the tokenizer.
+[[nodiscard]] auto tokenizer_name(tokenizer t) noexcept -> std::string_view;
+
+#endif
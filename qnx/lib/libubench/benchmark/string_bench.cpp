@@ -2,6 +2,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include "ubench/measure/perf_benchmark.h"
 #include "ubench/string.h"
 
 static const std::string byte_string{"12"};
@@ -56,6 +57,7 @@ static __attribute__((noinline)) auto test_from_chars(const std::string& str)
 // NOLINTBEGIN
 
 static void BM_StrToL_byte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtol(byte_string);
     benchmark::DoNotOptimize(result);
@@ -63,6 +65,7 @@ static void BM_StrToL_byte(benchmark::State& state) {
 }
 
 static void BM_StrToL_short(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtol(short_string);
     benchmark::DoNotOptimize(result);
@@ -70,6 +73,7 @@ static void BM_StrToL_short(benchmark::State& state) {
 }
 
 static void BM_StrToL_long(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtol(long_string);
     benchmark::DoNotOptimize(result);
@@ -77,6 +81,7 @@ static void BM_StrToL_long(benchmark::State& state) {
 }
 
 static void BM_StrToL_llong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtol(llong_string);
     benchmark::DoNotOptimize(result);
@@ -84,6 +89,7 @@ static void BM_StrToL_llong(benchmark::State& state) {
 }
 
 static void BM_StrToL_xlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtol(xlong_string);
     benchmark::DoNotOptimize(result);
@@ -97,6 +103,7 @@ BENCHMARK(BM_StrToL_llong);
 BENCHMARK(BM_StrToL_xlong);
 
 static void BM_StrToLL_byte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoll(byte_string);
     benchmark::DoNotOptimize(result);
@@ -104,6 +111,7 @@ static void BM_StrToLL_byte(benchmark::State& state) {
 }
 
 static void BM_StrToLL_short(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoll(short_string);
     benchmark::DoNotOptimize(result);
@@ -111,6 +119,7 @@ static void BM_StrToLL_short(benchmark::State& state) {
 }
 
 static void BM_StrToLL_long(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoll(long_string);
     benchmark::DoNotOptimize(result);
@@ -118,6 +127,7 @@ static void BM_StrToLL_long(benchmark::State& state) {
 }
 
 static void BM_StrToLL_llong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoll(llong_string);
     benchmark::DoNotOptimize(result);
@@ -125,6 +135,7 @@ static void BM_StrToLL_llong(benchmark::State& state) {
 }
 
 static void BM_StrToLL_xlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoll(xlong_string);
     benchmark::DoNotOptimize(result);
@@ -138,6 +149,7 @@ BENCHMARK(BM_StrToLL_llong);
 BENCHMARK(BM_StrToLL_xlong);
 
 static void BM_StrToUL_byte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoul(byte_string);
     benchmark::DoNotOptimize(result);
@@ -145,6 +157,7 @@ static void BM_StrToUL_byte(benchmark::State& state) {
 }
 
 static void BM_StrToUL_short(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoul(short_string);
     benchmark::DoNotOptimize(result);
@@ -152,6 +165,7 @@ static void BM_StrToUL_short(benchmark::State& state) {
 }
 
 static void BM_StrToUL_long(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoul(long_string);
     benchmark::DoNotOptimize(result);
@@ -159,6 +173,7 @@ static void BM_StrToUL_long(benchmark::State& state) {
 }
 
 static void BM_StrToUL_llong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoul(llong_string);
     benchmark::DoNotOptimize(result);
@@ -166,6 +181,7 @@ static void BM_StrToUL_llong(benchmark::State& state) {
 }
 
 static void BM_StrToUL_xlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoul(xlong_string);
     benchmark::DoNotOptimize(result);
@@ -179,6 +195,7 @@ BENCHMARK(BM_StrToUL_llong);
 BENCHMARK(BM_StrToUL_xlong);
 
 static void BM_StrToULL_byte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoull(byte_string);
     benchmark::DoNotOptimize(result);
@@ -186,6 +203,7 @@ static void BM_StrToULL_byte(benchmark::State& state) {
 }
 
 static void BM_StrToULL_short(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoull(short_string);
     benchmark::DoNotOptimize(result);
@@ -193,6 +211,7 @@ static void BM_StrToULL_short(benchmark::State& state) {
 }
 
 static void BM_StrToULL_long(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoull(long_string);
     benchmark::DoNotOptimize(result);
@@ -200,6 +219,7 @@ static void BM_StrToULL_long(benchmark::State& state) {
 }
 
 static void BM_StrToULL_llong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoull(llong_string);
     benchmark::DoNotOptimize(result);
@@ -207,6 +227,7 @@ static void BM_StrToULL_llong(benchmark::State& state) {
 }
 
 static void BM_StrToULL_xlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_strtoull(xlong_string);
     benchmark::DoNotOptimize(result);
@@ -220,6 +241,7 @@ BENCHMARK(BM_StrToULL_llong);
 BENCHMARK(BM_StrToULL_xlong);
 
 static void BM_FromChars_byte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars(byte_string);
     benchmark::DoNotOptimize(result);
@@ -227,6 +249,7 @@ static void BM_FromChars_byte(benchmark::State& state) {
 }
 
 static void BM_FromChars_short(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars(short_string);
     benchmark::DoNotOptimize(result);
@@ -234,6 +257,7 @@ static void BM_FromChars_short(benchmark::State& state) {
 }
 
 static void BM_FromChars_long(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars(long_string);
     benchmark::DoNotOptimize(result);
@@ -241,6 +265,7 @@ static void BM_FromChars_long(benchmark::State& state) {
 }
 
 static void BM_FromChars_llong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars(llong_string);
     benchmark::DoNotOptimize(result);
@@ -248,6 +273,7 @@ static void BM_FromChars_llong(benchmark::State& state) {
 }
 
 static void BM_FromChars_xlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars(xlong_string);
     benchmark::DoNotOptimize(result);
@@ -261,6 +287,7 @@ BENCHMARK(BM_FromChars_llong);
 BENCHMARK(BM_FromChars_xlong);
 
 static void BM_FromCharsHex_ubyte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::uint8_t>(byte_string);
     benchmark::DoNotOptimize(result);
@@ -268,6 +295,7 @@ static void BM_FromCharsHex_ubyte(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_ushort(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::uint16_t>(short_string);
     benchmark::DoNotOptimize(result);
@@ -275,6 +303,7 @@ static void BM_FromCharsHex_ushort(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_ulong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::uint32_t>(long_string);
     benchmark::DoNotOptimize(result);
@@ -282,6 +311,7 @@ static void BM_FromCharsHex_ulong(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_ullong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::uint64_t>(llong_string);
     benchmark::DoNotOptimize(result);
@@ -289,6 +319,7 @@ static void BM_FromCharsHex_ullong(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_uxlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::uint64_t>(xlong_string);
     benchmark::DoNotOptimize(result);
@@ -302,6 +333,7 @@ BENCHMARK(BM_FromCharsHex_ullong);
 BENCHMARK(BM_FromCharsHex_uxlong);
 
 static void BM_FromCharsHex_byte(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::int8_t>(byte_string);
     benchmark::DoNotOptimize(result);
@@ -309,6 +341,7 @@ static void BM_FromCharsHex_byte(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_short(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::int16_t>(short_string);
     benchmark::DoNotOptimize(result);
@@ -316,6 +349,7 @@ static void BM_FromCharsHex_short(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_long(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::int32_t>(long_string);
     benchmark::DoNotOptimize(result);
@@ -323,6 +357,7 @@ static void BM_FromCharsHex_long(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_llong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::int64_t>(llong_string);
     benchmark::DoNotOptimize(result);
@@ -330,6 +365,7 @@ static void BM_FromCharsHex_llong(benchmark::State& state) {
 }
 
 static void BM_FromCharsHex_xlong(benchmark::State& state) {
+  ubench::measure::perf_benchmark perf{state};
   for (auto _ : state) {
     auto result = test_from_chars_hex<std::int64_t>(xlong_string);
     benchmark::DoNotOptimize(result);
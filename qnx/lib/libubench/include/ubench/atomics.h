@@ -1 +1,5 @@
 #include "ubench/atomics/rcu.h"
+#include "ubench/atomics/rcu_epoch.h"
+#include "ubench/atomics/rcu_sharded.h"
+#include "ubench/atomics/rcu_map.h"
+#include "ubench/atomics/seqlock.h"
@@ -0,0 +1,428 @@
+#ifndef UBENCH_ATOMICS_RCU_EPOCH_H
+#define UBENCH_ATOMICS_RCU_EPOCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Epoch based reclamation. Every thread that reads has its own record, in a
+// cache line of its own, with the epoch it saw when it started reading, or
+// zero when it isn't reading. A reader only writes to its own record, so the
+// readers never share a cache line that is written, and the read throughput
+// scales with the number of cores.
+//
+// A writer replaces the object, then advances the global epoch. The old object
+// is retired with the epoch before the advance. A reader that starts after the
+// advance can only see the new object, so once every record is either not
+// reading, or has an epoch later than that of the retired object, the object
+// can be freed.
+class rcu_epoch_domain {
+ public:
+  // Each thread has one record, which is reused by a new thread after the
+  // thread exits. The records are never freed, so a writer can scan them
+  // without a lock.
+  class alignas(64) record {
+   public:
+    std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<bool> in_use_{true};
+    record *next_{nullptr};
+    std::uint32_t nesting_{0};
+  };
+
+  rcu_epoch_domain(const rcu_epoch_domain &) = delete;
+  auto operator=(const rcu_epoch_domain &) -> rcu_epoch_domain & = delete;
+  rcu_epoch_domain(rcu_epoch_domain &&) = delete;
+  auto operator=(rcu_epoch_domain &&) -> rcu_epoch_domain & = delete;
+  ~rcu_epoch_domain() = delete;
+
+  // There is one domain for the process. It is never destroyed, as threads
+  // may release their record after the static objects are destroyed.
+  [[nodiscard]] static auto global() -> rcu_epoch_domain & {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    static rcu_epoch_domain *domain = new rcu_epoch_domain{};
+    return *domain;
+  }
+
+  // The record of the calling thread.
+  [[nodiscard]] auto local() -> record & {
+    thread_local local_record local{*this};
+    return *local.record_;
+  }
+
+  // Start a read section on this thread. Read sections may be nested.
+  auto enter(record &r) noexcept -> void {
+    if (r.nesting_++ == 0) {
+      // The store must be visible before the pointer is loaded, so that a
+      // writer either sees this thread reading, or this thread sees the new
+      // pointer. The epoch is loaded with acquire, so that a reader that sees
+      // the epoch advanced after a pointer was replaced also sees the new
+      // pointer, and not the old one retired with an older epoch.
+      r.epoch_.store(epoch_.load(std::memory_order_acquire));
+    }
+  }
+
+  // End a read section on this thread.
+  auto exit(record &r) noexcept -> void {
+    if (--r.nesting_ == 0) {
+      r.epoch_.store(0, std::memory_order_release);
+    }
+  }
+
+  // Advance the epoch after unlinking an object, and return the epoch to
+  // retire it with.
+  auto advance() noexcept -> std::uint64_t { return epoch_.fetch_add(1); }
+
+  // Wait for a grace period: every read section that started before the call
+  // has ended. An object unlinked before the call can then be freed. It must
+  // not be called in a read section, which would wait for itself.
+  auto synchronize() -> void {
+#if !defined(NDEBUG)
+    if (local().nesting_ != 0) {
+      std::cout << "Abort due to synchronize() in a read section" << std::endl;
+      std::abort();
+    }
+#endif
+    std::uint64_t epoch = advance();
+    while (safe_epoch() <= epoch) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Objects retired with an epoch less than this may be freed, as no reader
+  // can still see them.
+  [[nodiscard]] auto safe_epoch() const noexcept -> std::uint64_t {
+    std::uint64_t safe = epoch_.load();
+    for (record *r = head_.load(); r; r = r->next_) {
+      std::uint64_t e = r->epoch_.load();
+      if (e != 0 && e < safe) safe = e;
+    }
+    return safe;
+  }
+
+ private:
+  // Releases the record of a thread when the thread exits.
+  class local_record {
+   public:
+    explicit local_record(rcu_epoch_domain &domain)
+        : record_{domain.acquire()} {}
+    local_record(const local_record &) = delete;
+    auto operator=(const local_record &) -> local_record & = delete;
+    local_record(local_record &&) = delete;
+    auto operator=(local_record &&) -> local_record & = delete;
+    ~local_record() {
+      record_->nesting_ = 0;
+      record_->epoch_.store(0, std::memory_order_release);
+      record_->in_use_.store(false, std::memory_order_release);
+    }
+
+    record *record_;
+  };
+
+  // The epoch starts at one, as zero in a record means it isn't reading.
+  std::atomic<std::uint64_t> epoch_{1};
+  std::atomic<record *> head_{nullptr};
+
+  rcu_epoch_domain() = default;
+
+  auto acquire() -> record * {
+    for (record *r = head_.load(); r; r = r->next_) {
+      bool in_use = false;
+      if (!r->in_use_.load(std::memory_order_relaxed) &&
+          r->in_use_.compare_exchange_strong(in_use, true)) {
+        return r;
+      }
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto *r = new record{};
+    record *head = head_.load();
+    do {
+      r->next_ = head;
+    } while (!head_.compare_exchange_weak(head, r));
+    return r;
+  }
+};
+
+// A reference to the object read from a `rcu_epoch`. The thread is in a read
+// section until the reference is destroyed, which must be on the same thread
+// that read it. It can't be copied, only moved on the same thread.
+template <class T>
+class rcu_epoch_ptr {
+ public:
+  rcu_epoch_ptr() = default;
+  rcu_epoch_ptr(const rcu_epoch_ptr &) = delete;
+  auto operator=(const rcu_epoch_ptr &) -> rcu_epoch_ptr & = delete;
+
+  rcu_epoch_ptr(rcu_epoch_ptr &&rval) noexcept
+      : ptr_{std::exchange(rval.ptr_, nullptr)},
+        record_{std::exchange(rval.record_, nullptr)} {}
+
+  auto operator=(rcu_epoch_ptr &&rval) noexcept -> rcu_epoch_ptr & {
+    rcu_epoch_ptr{std::move(rval)}.swap(*this);
+    return *this;
+  }
+
+  auto swap(rcu_epoch_ptr &other) noexcept -> void {
+    std::swap(ptr_, other.ptr_);
+    std::swap(record_, other.record_);
+  }
+
+  [[nodiscard]] auto get() const -> const T * { return ptr_; }
+
+  auto operator->() const -> const T * { return ptr_; }
+
+  auto operator*() const -> const T & { return *ptr_; }
+
+  explicit operator bool() const { return ptr_ != nullptr; }
+
+  auto reset() -> void { free(); }
+
+  ~rcu_epoch_ptr() { free(); }
+
+ private:
+  template <class UT, class UDeleter>
+  friend class rcu_epoch;
+
+  template <class K, class V, class Hash, class KeyEqual>
+  friend class rcu_map;
+
+  const T *ptr_{nullptr};
+  rcu_epoch_domain::record *record_{nullptr};
+
+  rcu_epoch_ptr(const T *ptr, rcu_epoch_domain::record *r)
+      : ptr_{ptr}, record_{r} {}
+
+  auto free() -> void {
+    if (!record_) return;
+    rcu_epoch_domain::global().exit(*record_);
+    record_ = nullptr;
+    ptr_ = nullptr;
+  }
+};
+
+// The statistics of a `rcu_reclaimer`.
+struct rcu_reclaimer_stats {
+  std::size_t pending{};            // Callbacks waiting for a grace period.
+  std::size_t pending_bytes{};      // The memory they free.
+  std::size_t max_pending{};        // The most callbacks waiting at once.
+  std::size_t max_pending_bytes{};  // The most memory waiting at once.
+  std::uint64_t reclaimed{};        // Callbacks run.
+  std::uint64_t batches{};          // Grace periods waited for.
+};
+
+// A queue of callbacks that are run after a grace period, as `call_rcu()` in
+// the Linux kernel. A background thread takes all callbacks queued, waits for
+// one grace period with `synchronize()`, then runs them. A writer that queues
+// the free of an old object never waits for the readers, and the frees are
+// done in batches away from the writer.
+class rcu_reclaimer {
+ public:
+  // The background thread checks for new callbacks at least every period.
+  explicit rcu_reclaimer(
+      std::chrono::microseconds period = std::chrono::milliseconds{1})
+      : period_{period}, thread_{[this]() { run(); }} {}
+
+  rcu_reclaimer(const rcu_reclaimer &) = delete;
+  auto operator=(const rcu_reclaimer &) -> rcu_reclaimer & = delete;
+  rcu_reclaimer(rcu_reclaimer &&) = delete;
+  auto operator=(rcu_reclaimer &&) -> rcu_reclaimer & = delete;
+
+  // Runs all callbacks still queued, after a grace period.
+  ~rcu_reclaimer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    queued_cv_.notify_one();
+    thread_.join();
+  }
+
+  // Run the callback after a grace period, which starts after this call. The
+  // bytes are the memory it frees, for the statistics.
+  auto call(std::function<void()> callback, std::size_t bytes = 0) -> void {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back({std::move(callback), bytes});
+      queued_++;
+      stats_.pending++;
+      stats_.pending_bytes += bytes;
+      stats_.max_pending = std::max(stats_.max_pending, stats_.pending);
+      stats_.max_pending_bytes =
+          std::max(stats_.max_pending_bytes, stats_.pending_bytes);
+    }
+    queued_cv_.notify_one();
+  }
+
+  // Wait until every callback queued before this call has run, as
+  // `rcu_barrier()`.
+  auto barrier() -> void {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::uint64_t target = queued_;
+    queued_cv_.notify_one();
+    done_cv_.wait(lock, [&]() { return done_ >= target; });
+  }
+
+  [[nodiscard]] auto stats() const -> rcu_reclaimer_stats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  struct callback {
+    std::function<void()> fn;
+    std::size_t bytes;
+  };
+
+  std::chrono::microseconds period_;
+  mutable std::mutex mutex_{};
+  std::condition_variable queued_cv_{};
+  std::condition_variable done_cv_{};
+  std::vector<callback> queue_{};
+  std::uint64_t queued_{};
+  std::uint64_t done_{};
+  bool stop_{false};
+  rcu_reclaimer_stats stats_{};
+  std::thread thread_;
+
+  auto run() -> void {
+    std::vector<callback> batch{};
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      queued_cv_.wait_for(
+          lock, period_, [&]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        if (stop_) return;
+        continue;
+      }
+
+      // Every callback in the batch was queued after its object was
+      // unlinked, so one grace period from now covers all of them.
+      batch.swap(queue_);
+      std::uint64_t target = queued_;
+      lock.unlock();
+
+      rcu_epoch_domain::global().synchronize();
+      std::size_t bytes = 0;
+      for (auto &cb : batch) {
+        cb.fn();
+        bytes += cb.bytes;
+      }
+
+      lock.lock();
+      stats_.pending -= batch.size();
+      stats_.pending_bytes -= bytes;
+      stats_.reclaimed += batch.size();
+      stats_.batches++;
+      done_ = target;
+      batch.clear();
+      done_cv_.notify_all();
+    }
+  }
+};
+
+// The same interface as `rcu`, reclaiming with epochs instead of reference
+// counts. An update never fails: the old object is kept in a limbo list until
+// no reader can see it, and is freed by a later update, `reclaim()`, or the
+// destructor. If constructed with a `rcu_reclaimer`, the old object is given
+// to it instead, so an update never frees memory itself.
+template <class T, class Deleter = std::default_delete<T>>
+class rcu_epoch {
+  using pointer_type = T *;
+  using deleter_type = Deleter;
+
+ public:
+  rcu_epoch() = delete;
+
+  rcu_epoch(const rcu_epoch &rhs) = delete;
+  auto operator=(const rcu_epoch &rhs) -> rcu_epoch & = delete;
+  rcu_epoch(rcu_epoch &&) = delete;
+  auto operator=(rcu_epoch &&) -> rcu_epoch & = delete;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
+  rcu_epoch(std::unique_ptr<T, Deleter> &&ptr) {
+    if (!ptr) std::abort();
+    ptr_.store(ptr.release());
+  }
+
+  // The reclaimer must outlive this object.
+  //
+  // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
+  rcu_epoch(std::unique_ptr<T, Deleter> &&ptr, rcu_reclaimer &reclaimer)
+      : reclaimer_{&reclaimer} {
+    if (!ptr) std::abort();
+    ptr_.store(ptr.release());
+  }
+
+  [[nodiscard]] auto read() -> rcu_epoch_ptr<T> {
+    rcu_epoch_domain &domain = rcu_epoch_domain::global();
+    rcu_epoch_domain::record &r = domain.local();
+    domain.enter(r);
+    return rcu_epoch_ptr<T>(ptr_.load(), &r);
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
+  auto update(std::unique_ptr<T, Deleter> &&update) -> bool {
+    // Don't allow updates to `nullptr`.
+    if (!update) return false;
+
+    if (reclaimer_) {
+      pointer_type old = ptr_.exchange(update.release());
+      reclaimer_->call([old]() { deleter_type{}(old); }, sizeof(T));
+      return true;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    pointer_type old = ptr_.exchange(update.release());
+    limbo_.emplace_back(rcu_epoch_domain::global().advance(), old);
+    reclaim_locked();
+    return true;
+  }
+
+  // Free the retired objects that no reader can see, and return the number
+  // still waiting for readers.
+  auto reclaim() -> std::size_t {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    reclaim_locked();
+    return limbo_.size();
+  }
+
+  ~rcu_epoch() {
+    // As for `rcu`, no `rcu_epoch_ptr` may outlive this object, so every
+    // object can be freed.
+    for (auto &retired : limbo_) {
+      deleter_type{}(retired.second);
+    }
+    deleter_type{}(ptr_.load());
+  }
+
+ private:
+  std::mutex write_mutex_;
+  std::atomic<pointer_type> ptr_{nullptr};
+  rcu_reclaimer *reclaimer_{nullptr};
+
+  // The retired objects, with the epoch they were retired in, oldest first.
+  std::vector<std::pair<std::uint64_t, pointer_type>> limbo_{};
+
+  auto reclaim_locked() -> void {
+    std::uint64_t safe = rcu_epoch_domain::global().safe_epoch();
+    auto it = limbo_.begin();
+    while (it != limbo_.end() && it->first < safe) {
+      deleter_type{}(it->second);
+      ++it;
+    }
+    limbo_.erase(limbo_.begin(), it);
+  }
+};
+
+#endif  // UBENCH_ATOMICS_RCU_EPOCH_H
@@ -0,0 +1,254 @@
+#ifndef UBENCH_ATOMICS_RCU_MAP_H
+#define UBENCH_ATOMICS_RCU_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ubench/atomics/rcu_epoch.h"
+
+// A hash map for data that is read often and changed rarely, such as
+// configuration. Lookups never lock and never write to shared memory, they
+// only enter a read section of the `rcu_epoch_domain`, and follow the chain of
+// a bucket. A lookup finishes in a bounded number of steps, whatever the
+// writers do.
+//
+// Writers are serialised by a mutex. The key and value of a node are never
+// changed once it is linked. Assigning a new value links a copy of the node in
+// its place, and erasing unlinks the node, with the next pointer of the old
+// node left as it was, so a reader on it still finds the rest of the chain.
+// When the map grows, every node is copied to a new bucket array, and the new
+// array is published with a single store. The replaced nodes and arrays are
+// freed after a grace period, in the same way as `rcu_epoch`.
+template <class K, class V, class Hash = std::hash<K>,
+    class KeyEqual = std::equal_to<K>>
+class rcu_map {
+ public:
+  rcu_map() : rcu_map(16) {}
+
+  // The number of buckets is rounded up to a power of two.
+  explicit rcu_map(std::size_t buckets) {
+    std::size_t size = 1;
+    while (size < buckets) size <<= 1;
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    table_.store(new table{size});
+  }
+
+  rcu_map(const rcu_map &rhs) = delete;
+  auto operator=(const rcu_map &rhs) -> rcu_map & = delete;
+  rcu_map(rcu_map &&) = delete;
+  auto operator=(rcu_map &&) -> rcu_map & = delete;
+
+  ~rcu_map() {
+    // As for `rcu_epoch`, no `rcu_epoch_ptr` may outlive the map.
+    table *t = table_.load();
+    for (std::size_t b = 0; b <= t->mask_; b++) {
+      free_chain(t->heads_[b].load());
+    }
+    delete t;  // NOLINT(cppcoreguidelines-owning-memory)
+    for (auto &retired : limbo_nodes_) {
+      delete retired.second;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    for (auto &retired : limbo_tables_) {
+      delete retired.second;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+  }
+
+  // Find the value of a key. The value remains valid, and unchanged, until
+  // the returned reference is destroyed, even if the key is assigned or
+  // erased. The reference is empty if the key isn't in the map.
+  [[nodiscard]] auto find(const K &key) const -> rcu_epoch_ptr<V> {
+    rcu_epoch_domain &domain = rcu_epoch_domain::global();
+    rcu_epoch_domain::record &r = domain.local();
+    domain.enter(r);
+    const node *n = find_node(key);
+    if (!n) {
+      domain.exit(r);
+      return {};
+    }
+    return rcu_epoch_ptr<V>(&n->value_, &r);
+  }
+
+  // Get a copy of the value of a key, if it is in the map.
+  [[nodiscard]] auto get(const K &key) const -> std::optional<V> {
+    rcu_epoch_ptr<V> value = find(key);
+    if (!value) return std::nullopt;
+    return *value;
+  }
+
+  [[nodiscard]] auto contains(const K &key) const -> bool {
+    return static_cast<bool>(find(key));
+  }
+
+  // Add the key, or replace its value. Returns true if the key was added.
+  auto insert_or_assign(const K &key, V value) -> bool {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    table *t = table_.load(std::memory_order_relaxed);
+    std::atomic<node *> &head = t->heads_[hash_(key) & t->mask_];
+
+    std::atomic<node *> *link = &head;
+    for (node *n = link->load(std::memory_order_relaxed); n;
+         n = link->load(std::memory_order_relaxed)) {
+      if (equal_(n->key_, key)) {
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        link->store(new node{n->key_, std::move(value),
+            n->next_.load(std::memory_order_relaxed)});
+        limbo_nodes_.emplace_back(rcu_epoch_domain::global().advance(), n);
+        reclaim_locked();
+        return false;
+      }
+      link = &n->next_;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    head.store(new node{key, std::move(value),
+        head.load(std::memory_order_relaxed)});
+    std::size_t size = size_.load(std::memory_order_relaxed) + 1;
+    size_.store(size, std::memory_order_relaxed);
+    if (size > t->mask_ + 1) grow(t);
+    reclaim_locked();
+    return true;
+  }
+
+  // Remove the key. Returns true if the key was in the map.
+  auto erase(const K &key) -> bool {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    table *t = table_.load(std::memory_order_relaxed);
+
+    std::atomic<node *> *link = &t->heads_[hash_(key) & t->mask_];
+    for (node *n = link->load(std::memory_order_relaxed); n;
+         n = link->load(std::memory_order_relaxed)) {
+      if (equal_(n->key_, key)) {
+        link->store(n->next_.load(std::memory_order_relaxed));
+        limbo_nodes_.emplace_back(rcu_epoch_domain::global().advance(), n);
+        size_.store(size_.load(std::memory_order_relaxed) - 1,
+            std::memory_order_relaxed);
+        reclaim_locked();
+        return true;
+      }
+      link = &n->next_;
+    }
+    return false;
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto bucket_count() const -> std::size_t {
+    return table_.load()->mask_ + 1;
+  }
+
+  // Free the replaced nodes and bucket arrays that no reader can see, and
+  // return the number still waiting for readers.
+  auto reclaim() -> std::size_t {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    reclaim_locked();
+    return limbo_nodes_.size() + limbo_tables_.size();
+  }
+
+ private:
+  class node {
+   public:
+    node(K key, V value, node *next)
+        : key_{std::move(key)}, value_{std::move(value)}, next_{next} {}
+
+    const K key_;
+    const V value_;
+    std::atomic<node *> next_;
+  };
+
+  class table {
+   public:
+    explicit table(std::size_t buckets)
+        : mask_{buckets - 1},
+          heads_{std::make_unique<std::atomic<node *>[]>(buckets)} {}
+
+    std::size_t mask_;
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+    std::unique_ptr<std::atomic<node *>[]> heads_;
+  };
+
+  std::mutex write_mutex_;
+  std::atomic<table *> table_{nullptr};
+  std::atomic<std::size_t> size_{0};
+  Hash hash_{};
+  KeyEqual equal_{};
+
+  // The replaced nodes and bucket arrays, with the epoch they were retired
+  // in, oldest first.
+  std::vector<std::pair<std::uint64_t, node *>> limbo_nodes_{};
+  std::vector<std::pair<std::uint64_t, table *>> limbo_tables_{};
+
+  // The loads are sequentially consistent, as for the pointer of `rcu_epoch`,
+  // so that a writer that saw this thread not reading has already unlinked
+  // what it frees.
+  [[nodiscard]] auto find_node(const K &key) const -> const node * {
+    const table *t = table_.load();
+    for (const node *n = t->heads_[hash_(key) & t->mask_].load(); n;
+         n = n->next_.load()) {
+      if (equal_(n->key_, key)) return n;
+    }
+    return nullptr;
+  }
+
+  // Copy every node into a table with twice the buckets. The nodes can't be
+  // moved, as readers may be following their next pointers in the old table.
+  auto grow(table *t) -> void {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto *nt = new table{(t->mask_ + 1) * 2};
+    for (std::size_t b = 0; b <= t->mask_; b++) {
+      for (node *n = t->heads_[b].load(std::memory_order_relaxed); n;
+           n = n->next_.load(std::memory_order_relaxed)) {
+        std::atomic<node *> &head = nt->heads_[hash_(n->key_) & nt->mask_];
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        head.store(new node{n->key_, n->value_,
+                       head.load(std::memory_order_relaxed)},
+            std::memory_order_relaxed);
+      }
+    }
+    table_.store(nt);
+
+    std::uint64_t epoch = rcu_epoch_domain::global().advance();
+    for (std::size_t b = 0; b <= t->mask_; b++) {
+      for (node *n = t->heads_[b].load(std::memory_order_relaxed); n;
+           n = n->next_.load(std::memory_order_relaxed)) {
+        limbo_nodes_.emplace_back(epoch, n);
+      }
+    }
+    limbo_tables_.emplace_back(epoch, t);
+  }
+
+  auto reclaim_locked() -> void {
+    std::uint64_t safe = rcu_epoch_domain::global().safe_epoch();
+    free_limbo(limbo_nodes_, safe);
+    free_limbo(limbo_tables_, safe);
+  }
+
+  template <class P>
+  static auto free_limbo(std::vector<std::pair<std::uint64_t, P *>> &limbo,
+      std::uint64_t safe) -> void {
+    auto it = limbo.begin();
+    while (it != limbo.end() && it->first < safe) {
+      delete it->second;  // NOLINT(cppcoreguidelines-owning-memory)
+      ++it;
+    }
+    limbo.erase(limbo.begin(), it);
+  }
+
+  static auto free_chain(node *n) -> void {
+    while (n) {
+      node *next = n->next_.load(std::memory_order_relaxed);
+      delete n;  // NOLINT(cppcoreguidelines-owning-memory)
+      n = next;
+    }
+  }
+};
+
+#endif  // UBENCH_ATOMICS_RCU_MAP_H
@@ -0,0 +1,222 @@
+#ifndef UBENCH_ATOMICS_RCU_SHARDED_H
+#define UBENCH_ATOMICS_RCU_SHARDED_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// The shard of the reference counts that the calling thread uses. Threads are
+// given shards in turn, so that up to the number of shards, every thread has a
+// cache line of its own.
+inline auto rcu_shard_index() noexcept -> std::uint32_t {
+  static std::atomic<std::uint32_t> next{0};
+  thread_local std::uint32_t index =
+      next.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+template <class T, class Deleter, std::size_t N, std::size_t Shards>
+class rcu_sharded;
+
+// A reference to the object read from a `rcu_sharded`. It holds one count in
+// the shard of the thread that read it. Unlike `rcu_ptr`, releasing the last
+// reference never frees the object, that is done by the writer.
+template <class T>
+class rcu_sharded_ptr {
+ public:
+  rcu_sharded_ptr() = default;
+
+  rcu_sharded_ptr(const rcu_sharded_ptr &obj)
+      : ptr_{obj.ptr_}, refcount_{obj.refcount_} {
+    if (refcount_) refcount_->fetch_add(1, std::memory_order_relaxed);
+  }
+
+  auto operator=(const rcu_sharded_ptr &obj) -> rcu_sharded_ptr & {
+    rcu_sharded_ptr{obj}.swap(*this);
+    return *this;
+  }
+
+  rcu_sharded_ptr(rcu_sharded_ptr &&rval) noexcept
+      : ptr_{std::exchange(rval.ptr_, nullptr)},
+        refcount_{std::exchange(rval.refcount_, nullptr)} {}
+
+  auto operator=(rcu_sharded_ptr &&rval) noexcept -> rcu_sharded_ptr & {
+    rcu_sharded_ptr{std::move(rval)}.swap(*this);
+    return *this;
+  }
+
+  auto swap(rcu_sharded_ptr &other) noexcept -> void {
+    std::swap(ptr_, other.ptr_);
+    std::swap(refcount_, other.refcount_);
+  }
+
+  [[nodiscard]] auto get() const -> const T * { return ptr_; }
+
+  auto operator->() const -> const T * { return ptr_; }
+
+  auto operator*() const -> const T & { return *ptr_; }
+
+  explicit operator bool() const { return ptr_ != nullptr; }
+
+  auto reset() -> void { free(); }
+
+  ~rcu_sharded_ptr() { free(); }
+
+ private:
+  template <class UT, class UDeleter, std::size_t N, std::size_t Shards>
+  friend class rcu_sharded;
+
+  const T *ptr_{nullptr};
+  std::atomic<std::uint32_t> *refcount_{nullptr};
+
+  rcu_sharded_ptr(const T *ptr, std::atomic<std::uint32_t> *ref)
+      : ptr_{ptr}, refcount_{ref} {}
+
+  auto free() -> void {
+    if (!refcount_) return;
+    refcount_->fetch_sub(1, std::memory_order_release);
+    refcount_ = nullptr;
+    ptr_ = nullptr;
+  }
+};
+
+// The same interface as `rcu`, with the reference count of each slot split
+// over `Shards` cache lines. A reader increments the count in the shard of its
+// thread, instead of a compare and exchange loop on a count shared with all
+// other readers.
+//
+// As the count of a slot is the sum of all shards, a reader can't tell if it
+// released the last reference. The writer frees a replaced slot when its sum
+// is zero, on a later `update()`, `reclaim()` or the destructor. As for `rcu`,
+// an update fails if all `N` slots are still referenced.
+template <class T, class Deleter = std::default_delete<T>, std::size_t N = 10,
+    std::size_t Shards = 64>
+class rcu_sharded {
+  using pointer_type = T *;
+  using deleter_type = Deleter;
+
+ public:
+  rcu_sharded() = delete;
+
+  rcu_sharded(const rcu_sharded &rhs) = delete;
+  auto operator=(const rcu_sharded &rhs) -> rcu_sharded & = delete;
+  rcu_sharded(rcu_sharded &&) = delete;
+  auto operator=(rcu_sharded &&) -> rcu_sharded & = delete;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
+  rcu_sharded(std::unique_ptr<T, Deleter> &&ptr) {
+    if (!ptr) std::abort();
+
+    index_.store(0);
+    slot_[0] = ptr.release();
+  }
+
+  [[nodiscard]] auto read() -> rcu_sharded_ptr<T> {
+    auto &counts = shard_[rcu_shard_index() % Shards].refcount_;
+
+    // Count the reference in the slot of the index, then check the index
+    // again. If it is the same, the writer hadn't replaced the slot before
+    // the count, so it will see the count before it frees the slot. Else the
+    // slot may already be freed, so undo the count and try again.
+    std::uint32_t i{};
+    while (true) {
+      i = index_.load();
+      counts[i].fetch_add(1);
+      if (index_.load() == i) break;
+      counts[i].fetch_sub(1, std::memory_order_release);
+    }
+    return rcu_sharded_ptr<T>(slot_[i], &counts[i]);
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
+  auto update(std::unique_ptr<T, Deleter> &&update) -> bool {
+    // Don't allow updates to `nullptr`.
+    if (!update) return false;
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    reclaim_locked();
+
+    // A free slot has no object. Readers that still count a reference in it
+    // read the index before it was replaced, and will see that it changed.
+    std::uint32_t i_start = index_.load();
+    std::uint32_t i = i_start;
+    do {
+      i = (i + 1) % N;
+      if (i == i_start) return false;
+    } while (slot_[i]);
+
+    slot_[i] = update.release();
+    index_.store(i);
+    reclaim_locked();
+    return true;
+  }
+
+  // Free the replaced objects that have no references, and return the number
+  // that are still referenced.
+  auto reclaim() -> std::size_t {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return reclaim_locked();
+  }
+
+  ~rcu_sharded() {
+    // No `rcu_sharded_ptr` may outlive this object, as it points to the
+    // counts in the shards.
+    for (std::uint32_t i = 0; i < N; i++) {
+      if (refcount(i) != 0) {
+#if !defined(NDEBUG)
+        std::cout << "Abort due to not final free, dangling reference of an "
+                     "`rcu_sharded_ptr`"
+                  << std::endl;
+#endif
+        std::abort();
+      }
+      if (slot_[i]) deleter_type{}(slot_[i]);
+    }
+  }
+
+ private:
+  std::mutex write_mutex_;
+
+  // The sum of the counts of a slot in all shards. Each count is only
+  // decremented by the reference that incremented it, so no count is ever
+  // negative, and a sum of zero means there are no references.
+  [[nodiscard]] auto refcount(std::uint32_t index) const -> std::uint32_t {
+    std::uint32_t count = 0;
+    for (const auto &s : shard_) {
+      count += s.refcount_[index].load();
+    }
+    return count;
+  }
+
+  auto reclaim_locked() -> std::size_t {
+    std::size_t held = 0;
+    std::uint32_t active = index_.load();
+    for (std::uint32_t i = 0; i < N; i++) {
+      if (i == active || !slot_[i]) continue;
+      if (refcount(i) == 0) {
+        deleter_type{}(slot_[i]);
+        slot_[i] = nullptr;
+      } else {
+        held++;
+      }
+    }
+    return held;
+  }
+
+  // The counts of one shard for every slot, in its own cache lines.
+  class alignas(64) shard {
+   public:
+    std::array<std::atomic<std::uint32_t>, N> refcount_{};
+  };
+
+  std::atomic<std::uint32_t> index_{0};
+  std::array<pointer_type, N> slot_{};
+  std::array<shard, Shards> shard_{};
+};
+
+#endif  // UBENCH_ATOMICS_RCU_SHARDED_H
@@ -0,0 +1,133 @@
+#ifndef UBENCH_ATOMICS_SEQLOCK_H
+#define UBENCH_ATOMICS_SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+// A mutex that does nothing, for a `seqlock` that only one thread writes.
+class seqlock_no_mutex {
+ public:
+  auto lock() noexcept -> void {}
+  auto unlock() noexcept -> void {}
+};
+
+// A sequence lock, for small objects that are read often, such as a timestamp
+// or a few counters. The object is copied in and out, so there is no
+// allocation on an update and no reference count on a read.
+//
+// A writer makes the sequence odd, writes the object, then makes the sequence
+// even again. A reader copies the object between two reads of the sequence,
+// and retries if the sequence was odd or changed. A read never writes to
+// shared memory, but may retry while a write is in progress, so a writer that
+// writes continuously can stall the readers.
+//
+// The object is held as atomic words, so that a reader copying it while it is
+// written isn't a data race. The copy it reads then is discarded.
+//
+// Writers are serialised by the `Mutex`. Use `seqlock_no_mutex` if only one
+// thread ever writes.
+template <class T, class Mutex = std::mutex>
+class seqlock {
+  static_assert(std::is_trivially_copyable_v<T>,
+      "seqlock copies the object, so it must be trivially copyable");
+  static_assert(std::is_default_constructible_v<T>,
+      "seqlock returns a copy, so it must be default constructible");
+
+ public:
+  seqlock() : seqlock(T{}) {}
+
+  explicit seqlock(const T &value) noexcept {
+    std::array<word, words> copy{};
+    std::memcpy(copy.data(), &value, sizeof(T));
+    for (std::size_t i = 0; i < words; i++) {
+      data_[i].store(copy[i], std::memory_order_relaxed);
+    }
+  }
+
+  seqlock(const seqlock &) = delete;
+  auto operator=(const seqlock &) -> seqlock & = delete;
+  seqlock(seqlock &&) = delete;
+  auto operator=(seqlock &&) -> seqlock & = delete;
+  ~seqlock() = default;
+
+  // Get a copy of the object, as it was after a complete write.
+  [[nodiscard]] auto load() const noexcept -> T {
+    std::array<word, words> copy{};
+    std::uint32_t seq1{};
+    std::uint32_t seq2{};
+    do {
+      seq1 = seq_.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < words; i++) {
+        copy[i] = data_[i].load(std::memory_order_relaxed);
+      }
+      // The copy must be complete before the sequence is read again.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      seq2 = seq_.load(std::memory_order_relaxed);
+    } while ((seq1 & 1) != 0 || seq1 != seq2);
+    return from_words(copy);
+  }
+
+  // Replace the object.
+  auto store(const T &value) -> void {
+    std::lock_guard<Mutex> lock(write_mutex_);
+    write(value);
+  }
+
+  // Change the object in place, with a function given a reference to a copy
+  // of it. The other writers are blocked until it returns, so a change such
+  // as an increment isn't lost.
+  template <class Fn>
+  auto update(Fn &&fn) -> void {
+    std::lock_guard<Mutex> lock(write_mutex_);
+    std::array<word, words> copy{};
+    for (std::size_t i = 0; i < words; i++) {
+      copy[i] = data_[i].load(std::memory_order_relaxed);
+    }
+    T value = from_words(copy);
+    fn(value);
+    write(value);
+  }
+
+  // Twice the number of writes, plus one while a write is in progress.
+  [[nodiscard]] auto sequence() const noexcept -> std::uint32_t {
+    return seq_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  using word = std::uintptr_t;
+  static constexpr std::size_t words = (sizeof(T) + sizeof(word) - 1) /
+                                       sizeof(word);
+
+  Mutex write_mutex_{};
+  std::atomic<std::uint32_t> seq_{0};
+  std::array<std::atomic<word>, words> data_{};
+
+  [[nodiscard]] static auto from_words(const std::array<word, words> &copy)
+      -> T {
+    T value{};
+    // The object is trivially copyable, if not trivial.
+    std::memcpy(static_cast<void *>(&value), copy.data(), sizeof(T));
+    return value;
+  }
+
+  auto write(const T &value) noexcept -> void {
+    std::array<word, words> copy{};
+    std::memcpy(copy.data(), &value, sizeof(T));
+
+    std::uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    // The odd sequence must be visible before any word of the object.
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < words; i++) {
+      data_[i].store(copy[i], std::memory_order_relaxed);
+    }
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+};
+
+#endif  // UBENCH_ATOMICS_SEQLOCK_H
@@ -4,7 +4,9 @@
 #include <sys/time.h>
 
 #include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <vector>
 
 namespace ubench::chrono {
 
@@ -65,6 +67,134 @@ struct process_clock {
   static auto is_available() noexcept -> bool;
 };
 
+/// @brief The time a CPU spent in each state since the system started.
+///
+/// Times that the Operating System doesn't count are zero. QNX only counts the
+/// idle time.
+struct cpu_times {
+  std::chrono::nanoseconds user{};     ///< Running user code, including nice.
+  std::chrono::nanoseconds system{};   ///< Running kernel code.
+  std::chrono::nanoseconds irq{};      ///< Handling interrupts.
+  std::chrono::nanoseconds softirq{};  ///< Handling deferred interrupt work.
+  std::chrono::nanoseconds steal{};    ///< Running other guests of the host.
+  std::chrono::nanoseconds iowait{};   ///< Idle, while waiting for I/O.
+  std::chrono::nanoseconds idle{};     ///< Idle.
+};
+
+/// @brief The times spent by each CPU in each state, so that a single busy
+/// CPU can be seen, which the total of the idle_clock hides.
+struct cpu_clock {
+  /// @brief Get the times of each CPU at the time of invocation.
+  ///
+  /// @param cpus the times, indexed by the CPU number. It is resized to the
+  /// number of CPUs, so that once it has the size, it doesn't allocate.
+  ///
+  /// @return true if the times were read; false if not available, and the
+  /// cpus is then empty.
+  static auto now(std::vector<cpu_times>& cpus) -> bool;
+
+  /// @brief Test if the implementation provides meaningful results.
+  ///
+  /// @return true if implemented and can be used.
+  static auto is_available() noexcept -> bool;
+};
+
+/// @brief Provides the counter used by the cycle_clock.
+enum class cycle_clock_type {
+  steady,  ///< Clock uses std::chrono::steady_clock.
+  tsc,     ///< Clock uses the x86 time stamp counter (RDTSC).
+  cntvct,  ///< Clock uses the AArch64 virtual counter (CNTVCT_EL0).
+};
+
+/// @brief A TrivialClock that is cheap to read, for timing short loops.
+///
+/// On x86 this reads the time stamp counter, and on AArch64 the virtual
+/// counter, which take a few nanoseconds and don't enter the kernel. Other
+/// processors use std::chrono::steady_clock. The ticks are converted to
+/// nanoseconds with a rate measured against the steady clock on first use,
+/// which takes about 10ms.
+///
+/// The counter must run at a constant rate, independent of the frequency of
+/// the core, and be synchronised between the cores, which is_invariant()
+/// tests. A thread that migrates between cores may otherwise see the clock
+/// jump.
+///
+/// For the shortest loops, read ticks() and convert the difference with
+/// to_duration() after, so that the conversion isn't timed.
+struct cycle_clock {
+  using duration = std::chrono::nanoseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<cycle_clock, duration>;
+  static constexpr const bool is_steady = true;
+
+  /// @brief The counter used by this clock.
+  ///
+  /// @return The clock type.
+  static constexpr auto type() noexcept -> cycle_clock_type {
+#if defined(__x86_64__) || defined(__i386__)
+    return cycle_clock_type::tsc;
+#elif defined(__aarch64__)
+    return cycle_clock_type::cntvct;
+#else
+    return cycle_clock_type::steady;
+#endif
+  }
+
+  /// @brief Read the counter.
+  ///
+  /// @return the ticks of the counter, which only have a meaning relative to
+  /// other ticks.
+  static auto ticks() noexcept -> std::uint64_t {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t t{};
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  /// @brief The length of a tick.
+  ///
+  /// The rate is measured on the first call. Call it before timing, so that
+  /// the first sample doesn't include the calibration.
+  ///
+  /// @return the nanoseconds of one tick.
+  static auto ns_per_tick() noexcept -> double;
+
+  /// @brief Convert a number of ticks to a duration.
+  ///
+  /// @param ticks the difference of two calls to ticks().
+  ///
+  /// @return the duration of the ticks.
+  static auto to_duration(std::uint64_t ticks) noexcept -> duration {
+    return duration{
+        static_cast<rep>(static_cast<double>(ticks) * ns_per_tick())};
+  }
+
+  /// @brief Get the time now.
+  ///
+  /// @return A time_point that can be used for comparison with other
+  /// invocations of now().
+  static auto now() noexcept -> time_point {
+    return time_point{to_duration(ticks())};
+  }
+
+  /// @brief Test if the counter runs at a constant rate on all cores.
+  ///
+  /// On x86, this is the invariant TSC flag of CPUID leaf 0x80000007, which a
+  /// virtual machine may hide. The AArch64 generic timer always runs at a
+  /// constant rate.
+  ///
+  /// @return true if the counter is invariant; false if it may change rate,
+  /// or stop when the core is idle.
+  static auto is_invariant() noexcept -> bool;
+};
+
 /// @brief Convert a nano-seconds value to a timespec.
 ///
 /// The function converts a duration of nanoseconds into a timespec. This
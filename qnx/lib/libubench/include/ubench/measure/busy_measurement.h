@@ -2,11 +2,28 @@
 #define UBENCH_MEASUREMENT_BUSY_MEASUREMENT_H
 
 #include <chrono>
+#include <vector>
 
 #include "ubench/clock.h"
+#include "ubench/measure/print.h"
 
 namespace ubench::measure {
 
+/// @brief A measurement of the clocks of a single CPU.
+///
+/// Times that the Operating System doesn't count are zero (see
+/// ubench::chrono::cpu_times).
+struct cpu_measurement {
+  std::chrono::milliseconds user;     //< Running user code.
+  std::chrono::milliseconds system;   //< Running kernel code.
+  std::chrono::milliseconds irq;      //< Handling interrupts.
+  std::chrono::milliseconds softirq;  //< Handling deferred interrupt work.
+  std::chrono::milliseconds steal;    //< Running other guests of the host.
+  std::chrono::milliseconds iowait;   //< Idle, while waiting for I/O.
+  std::chrono::milliseconds idle;     //< Idle.
+  std::chrono::milliseconds busy;     //< Not idle, waiting or stolen.
+};
+
 /// @brief A measurement of CPU clocks.
 struct busy_measurement {
   std::chrono::milliseconds idle_time;  //< Idle time summed over all CPUs.
@@ -15,8 +32,20 @@ struct busy_measurement {
   std::chrono::milliseconds
       cpu_time;  //< Process CPU usage time summed over all CPUs.
   std::chrono::milliseconds run_time;  //< Wall-clock time
+  std::vector<cpu_measurement> cpus;   //< Per CPU, empty if not available.
 };
 
+/// @brief Make a table of the time each CPU spent in each state.
+///
+/// A single CPU saturated by interrupts is hidden in the total busy time of a
+/// system with many CPUs, but shows here.
+///
+/// @param measurement the measurement to print.
+///
+/// @return a table with a line per CPU, in percent of the run time. It is empty
+/// if the measurement has no CPUs.
+auto make_cpu_table(const busy_measurement& measurement) -> table;
+
 /// @brief A stop watch for busy measurements.
 ///
 /// Construct the option which defines the start point when timing begins. Use
@@ -24,7 +53,7 @@ struct busy_measurement {
 class busy_stop_watch {
  public:
   /// @brief Initiate the watchdog by capturing time stamps.
-  explicit busy_stop_watch() noexcept;
+  explicit busy_stop_watch();
 
   /// @brief Reset the timestamps as if the object were constructed.
   auto reset() -> void;
@@ -48,12 +77,14 @@ class busy_stop_watch {
 
   /// @brief Make a time difference measurement.
   ///
-  /// @return a structure giving the idle, cpu and elapsed time since reset.
-  [[nodiscard]] auto measure() const noexcept -> busy_measurement;
+  /// @return a structure giving the idle, cpu and elapsed time since reset,
+  /// and the same for each CPU if available.
+  [[nodiscard]] auto measure() const -> busy_measurement;
 
  private:
   ubench::chrono::idle_clock::time_point start_idle_{};
   ubench::chrono::process_clock::time_point start_proc_{};
+  std::vector<ubench::chrono::cpu_times> start_cpus_{};
   std::chrono::high_resolution_clock::time_point start_time_{};
 };
 
@@ -0,0 +1,75 @@
+#ifndef UBENCH_MEASUREMENT_LATENCY_HISTOGRAM_H
+#define UBENCH_MEASUREMENT_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ubench::measure {
+
+/// @brief A histogram of latencies with a fixed relative precision.
+///
+/// Latencies are counted in buckets that are logarithmic (a power of 2), and
+/// each power of 2 is split linearly into 32 sub-buckets. The error of a value
+/// reported is then less than 1/32 (about 3%), independent of its magnitude,
+/// with a small fixed memory size. This is the same idea as the HDR
+/// histogram.
+class latency_histogram {
+ public:
+  latency_histogram() = default;
+  latency_histogram(const latency_histogram&) = default;
+  auto operator=(const latency_histogram&) -> latency_histogram& = default;
+  latency_histogram(latency_histogram&&) = default;
+  auto operator=(latency_histogram&&) -> latency_histogram& = default;
+  ~latency_histogram() = default;
+
+  /// @brief Count a single latency.
+  ///
+  /// @param latency the latency to add.
+  auto record(std::chrono::nanoseconds latency) noexcept -> void;
+
+  /// @brief Add all latencies counted by another histogram.
+  ///
+  /// @param other the histogram to add.
+  auto merge(const latency_histogram& other) noexcept -> void;
+
+  /// @brief The number of latencies counted.
+  ///
+  /// @return the number of latencies counted.
+  [[nodiscard]] auto count() const noexcept -> std::uint64_t { return count_; }
+
+  /// @brief Get the latency that a percentage of all latencies are less than
+  /// or equal to.
+  ///
+  /// @param percentile the percentage, between 0.0 and 100.0.
+  ///
+  /// @return the latency, being the highest value of the bucket it is in. If
+  /// no latencies were counted, zero is returned.
+  [[nodiscard]] auto percentile(double percentile) const noexcept
+      -> std::chrono::nanoseconds;
+
+  /// @brief The largest latency counted.
+  ///
+  /// @return the exact largest latency counted.
+  [[nodiscard]] auto max() const noexcept -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds{
+        static_cast<std::chrono::nanoseconds::rep>(max_)};
+  }
+
+ private:
+  static constexpr unsigned int SUB_BITS = 5;
+  static constexpr unsigned int SUB_BUCKETS = 1 << SUB_BITS;
+  static constexpr unsigned int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+  std::array<std::uint64_t, BUCKETS> counts_{};
+  std::uint64_t count_{};
+  std::uint64_t max_{};
+
+  [[nodiscard]] static auto index(std::uint64_t value) noexcept -> unsigned int;
+  [[nodiscard]] static auto highest(unsigned int index) noexcept
+      -> std::uint64_t;
+};
+
+}  // namespace ubench::measure
+
+#endif
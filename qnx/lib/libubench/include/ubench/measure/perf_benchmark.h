@@ -0,0 +1,60 @@
+#ifndef UBENCH_MEASUREMENT_PERF_BENCHMARK_H
+#define UBENCH_MEASUREMENT_PERF_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include "ubench/measure/perf_counters.h"
+
+namespace ubench::measure {
+
+/// @brief Count the hardware events of a Google Benchmark.
+///
+/// Construct it at the start of the benchmark function. When the function
+/// returns, the counts are added to the state as counters, averaged over the
+/// iterations, with the instructions per cycle. If the counters aren't
+/// available, nothing is added.
+///
+/// The counts include the setup of the benchmark before the loop, and the
+/// code when the timing is paused, which adds little when averaged over many
+/// iterations.
+///
+/// This header is only for programs built with Google Benchmark.
+class perf_benchmark {
+ public:
+  explicit perf_benchmark(benchmark::State& state) : state_{state} {
+    counters_.start();
+  }
+
+  perf_benchmark(const perf_benchmark&) = delete;
+  auto operator=(const perf_benchmark&) -> perf_benchmark& = delete;
+  perf_benchmark(perf_benchmark&&) = delete;
+  auto operator=(perf_benchmark&&) -> perf_benchmark& = delete;
+
+  ~perf_benchmark() {
+    counters_.stop();
+    if (!counters_.is_available()) return;
+
+    auto sample = counters_.read();
+    for (std::size_t e = 0; e < perf_event_count; e++) {
+      if (!sample.values[e]) continue;
+      state_.counters[perf_event_name(static_cast<perf_event>(e))] =
+          benchmark::Counter(static_cast<double>(*sample.values[e]),
+              benchmark::Counter::kAvgIterations);
+    }
+
+    auto cycles = sample.get(perf_event::cycles);
+    auto instructions = sample.get(perf_event::instructions);
+    if (cycles && instructions && *cycles > 0) {
+      state_.counters["IPC"] = static_cast<double>(*instructions) /
+                               static_cast<double>(*cycles);
+    }
+  }
+
+ private:
+  benchmark::State& state_;
+  perf_counters counters_{};
+};
+
+}  // namespace ubench::measure
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef UBENCH_MEASUREMENT_PERF_COUNTERS_H
+#define UBENCH_MEASUREMENT_PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace ubench::measure {
+
+/// @brief The hardware events counted by perf_counters.
+enum class perf_event : unsigned int {
+  cycles,         //< CPU cycles.
+  instructions,   //< Instructions retired.
+  cache_misses,   //< Last level cache misses.
+  l1d_misses,     //< Level 1 data cache read misses.
+  branch_misses,  //< Branches mispredicted.
+};
+
+/// @brief The number of events in perf_event.
+constexpr std::size_t perf_event_count = 5;
+
+/// @brief Get the printable name of an event.
+///
+/// @param event the event.
+///
+/// @return the name of the event, such as "Cycles".
+[[nodiscard]] auto perf_event_name(perf_event event) noexcept -> const char*;
+
+/// @brief The values of the counters when read.
+struct perf_sample {
+  /// @brief The value of each event, or nothing if it couldn't be counted.
+  std::array<std::optional<std::uint64_t>, perf_event_count> values{};
+
+  /// @brief If the kernel shared the counters with other events, so that the
+  /// values are estimated from the time they were counting.
+  bool scaled{false};
+
+  /// @brief Get the value of an event.
+  ///
+  /// @param event the event.
+  ///
+  /// @return the value, or nothing if the event couldn't be counted.
+  [[nodiscard]] auto get(perf_event event) const noexcept
+      -> std::optional<std::uint64_t> {
+    return values[static_cast<std::size_t>(event)];
+  }
+};
+
+/// @brief A group of hardware performance counters.
+///
+/// The counters are opened when constructed, and closed when destroyed. They
+/// count the user space of the thread that constructed the object, and of the
+/// threads it creates after, from start() to stop(). The counts of a thread
+/// it creates are added when the thread exits.
+///
+/// Counting may not be allowed, such as in a virtual machine or a container,
+/// or if the kernel restricts it (on Linux, see
+/// /proc/sys/kernel/perf_event_paranoid). Then is_available() is false and
+/// reading gives no values, so that a benchmark can run without them. An event
+/// that the CPU doesn't have is left out, and the others are still counted.
+///
+/// This class can be moved, but should not be copied.
+class perf_counters {
+ public:
+  /// @brief Open the counters for the current thread, stopped.
+  perf_counters();
+  perf_counters(const perf_counters&) = delete;
+  auto operator=(const perf_counters&) -> perf_counters& = delete;
+  perf_counters(perf_counters&&) noexcept;
+  auto operator=(perf_counters&&) noexcept -> perf_counters&;
+  ~perf_counters();
+
+  /// @brief Test if any counter could be opened.
+  ///
+  /// @return true if counting, false if no event can be counted.
+  [[nodiscard]] auto is_available() const noexcept -> bool;
+
+  /// @brief If no counter could be opened, the reason why.
+  ///
+  /// @return the errno value from opening the first counter, or zero.
+  [[nodiscard]] auto error() const noexcept -> int;
+
+  /// @brief Reset the counters to zero, and start counting.
+  auto start() noexcept -> void;
+
+  /// @brief Stop counting, keeping the values.
+  auto stop() noexcept -> void;
+
+  /// @brief Read the counters.
+  ///
+  /// @return the values counted between start() and stop(), or until now if
+  /// not stopped.
+  [[nodiscard]] auto read() const noexcept -> perf_sample;
+
+ private:
+  class perf_counters_impl;
+  std::unique_ptr<perf_counters_impl> impl_;
+};
+
+}  // namespace ubench::measure
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef UBENCH_MEASUREMENT_PRINT_H
 #define UBENCH_MEASUREMENT_PRINT_H
 
+#include <chrono>
 #include <initializer_list>
 #include <ostream>
 #include <string>
@@ -35,9 +36,9 @@ namespace ubench::measure {
 /// The table is a matrix of strings. Program the headers by calling
 /// add_column() first. Then write each row.
 ///
-/// Using the stream operator, the table will be written. The current
-/// implementation provides a mark-down like format. It might be in the future
-/// that other formats can be added (e.g. JSON, MyST list tables, etc.).
+/// Using the stream operator, the table will be written in a mark-down like
+/// format. The write_json() function writes the same table as JSON, for tools
+/// that plot the results.
 class table {
  public:
   table() = default;
@@ -68,11 +69,31 @@ class table {
   /// @return true if the row was added.
   auto add_line(std::initializer_list<std::string> line) -> bool;
 
+  /// @brief Add a new row to the table, with cells built at runtime.
+  ///
+  /// Once adding a line, it is no longer possible to add rows.
+  ///
+  /// @param line the cells to add to the line. The number of cells must match
+  /// the number of columns.
+  ///
+  /// @return true if the row was added.
+  auto add_line(std::vector<std::string> line) -> bool;
+
   /// @brief The number of rows added to the table.
   ///
   /// @return the number of rows added to the table.
   [[nodiscard]] auto size() const -> unsigned long { return table_.size(); }
 
+  /// @brief Write the table as JSON.
+  ///
+  /// The table is written as an array with an object for each row, with the
+  /// column names as the keys. Cells that are numbers are written as JSON
+  /// numbers, all other cells as strings. If there are no columns, each row is
+  /// written as an array.
+  ///
+  /// @param os the stream to write to.
+  auto write_json(std::ostream& os) const -> void;
+
  private:
   std::vector<std::string> hdr_{};
   std::vector<std::vector<std::string>> table_{};
@@ -92,6 +113,17 @@ class table {
       -> std::ostream&;
 };
 
+/// @brief Format a time in percent of another, for a cell of a table.
+///
+/// @param time the time to format.
+///
+/// @param total the time that is 100%.
+///
+/// @return the percent to 0.01%, such as "12.50", or "-" if the total is zero.
+[[nodiscard]] auto percent(
+    std::chrono::nanoseconds time, std::chrono::nanoseconds total)
+    -> std::string;
+
 }  // namespace ubench::measure
 
 #endif
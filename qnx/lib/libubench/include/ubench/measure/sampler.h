@@ -0,0 +1,159 @@
+#ifndef UBENCH_MEASUREMENT_SAMPLER_H
+#define UBENCH_MEASUREMENT_SAMPLER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ubench/clock.h"
+#include "ubench/measure/print.h"
+
+namespace ubench::measure {
+
+/// @brief The change of the clocks between two samples of a sampler.
+struct sample_interval {
+  std::chrono::nanoseconds time;     //< The end of the interval, from start.
+  std::chrono::nanoseconds length;   //< The length of the interval.
+  std::chrono::nanoseconds late;     //< How late the sampler woke at the end.
+  std::chrono::nanoseconds idle;     //< Idle time summed over all CPUs.
+  std::chrono::nanoseconds busy;     //< Busy time summed over all CPUs.
+  std::chrono::nanoseconds process;  //< Process time summed over all CPUs.
+  std::vector<std::chrono::nanoseconds> cpu_busy;  //< Busy time of each CPU.
+  std::vector<std::uint64_t> counters;  //< Increment of each counter.
+};
+
+/// @brief Sample the clocks periodically in the background.
+///
+/// A busy_stop_watch measures the clocks at the start and the end, so the load
+/// is averaged over the test. The sampler reads the idle, process and per-CPU
+/// clocks every period on its own thread, so that a change of the load during
+/// the test can be seen. How late the thread wakes is recorded with each
+/// sample, which shows the scheduling jitter of the system.
+///
+/// The samples are written into a ring buffer allocated when started, so
+/// that the sampler doesn't allocate while the test runs. If the test runs
+/// longer than the capacity, the oldest samples are overwritten.
+///
+/// The clocks have the resolution of the Operating System. On Linux, this is a
+/// scheduler tick (usually 10ms), so a shorter period gives noisy results.
+class sampler {
+ public:
+  /// @brief Prepare the sampler, without starting it.
+  ///
+  /// @param period the time between samples.
+  ///
+  /// @param capacity the number of samples kept. At least two are kept.
+  ///
+  /// @param core the core to pin the sampling thread to. If not given, the
+  /// thread isn't pinned.
+  sampler(std::chrono::microseconds period, std::size_t capacity,
+      std::optional<unsigned int> core = std::nullopt);
+  sampler(const sampler&) = delete;
+  auto operator=(const sampler&) -> sampler& = delete;
+  sampler(sampler&&) = delete;
+  auto operator=(sampler&&) -> sampler& = delete;
+  ~sampler();
+
+  /// @brief Sample a counter that the test increments.
+  ///
+  /// The counter is read with each sample, so that the progress of the test
+  /// can be compared with the load. It must outlive the sampler.
+  ///
+  /// @param name the name of the counter.
+  ///
+  /// @param counter the counter to read.
+  ///
+  /// @return true if the counter was added, false if the sampler was started.
+  auto add_counter(std::string name, const std::atomic<std::uint64_t>& counter)
+      -> bool;
+
+  /// @brief Take the first sample and start the sampling thread.
+  ///
+  /// @return true if started, false if the sampler was started before.
+  auto start() -> bool;
+
+  /// @brief Take a final sample and stop the sampling thread.
+  auto stop() -> void;
+
+  /// @brief Get the time since the sampler was started.
+  ///
+  /// @return the time since the sampler was started, or zero if not started.
+  [[nodiscard]] auto elapsed() const -> std::chrono::nanoseconds;
+
+  /// @brief Test if the sampling thread could be pinned. Only valid after
+  /// stop().
+  ///
+  /// @return false if a core was given and the thread couldn't be pinned.
+  [[nodiscard]] auto pinned() const -> bool { return pinned_; }
+
+  /// @brief Get the number of samples that were overwritten, as there were
+  /// more samples than the capacity. Only valid after stop().
+  ///
+  /// @return the number of samples lost.
+  [[nodiscard]] auto overwritten() const -> std::size_t;
+
+  /// @brief Get the change of the clocks between each pair of samples. Only
+  /// valid after stop().
+  ///
+  /// @return the intervals, oldest first.
+  [[nodiscard]] auto series() const -> std::vector<sample_interval>;
+
+  /// @brief Make a table of the intervals. Only valid after stop().
+  ///
+  /// The loads are in percent of the interval length, so the total is up to
+  /// 100% times the number of CPUs, as for a busy_measurement. The counters
+  /// are given per second.
+  ///
+  /// @return a table with a line per interval.
+  [[nodiscard]] auto make_table() const -> table;
+
+ private:
+  struct reading {
+    std::chrono::steady_clock::time_point time;
+    std::chrono::nanoseconds late;
+    ubench::chrono::idle_clock::time_point idle;
+    ubench::chrono::process_clock::time_point process;
+  };
+
+  struct counter {
+    std::string name;
+    const std::atomic<std::uint64_t>* value;
+  };
+
+  std::chrono::microseconds period_;
+  std::optional<unsigned int> core_;
+  std::size_t capacity_;
+  std::size_t cpus_{0};
+  std::vector<counter> counters_{};
+
+  // The ring buffer, as a reading, then the times of each CPU and the value of
+  // each counter, in the same slot.
+  std::vector<reading> readings_{};
+  std::vector<ubench::chrono::cpu_times> cpu_readings_{};
+  std::vector<std::uint64_t> counter_readings_{};
+  std::size_t count_{0};
+
+  std::chrono::steady_clock::time_point start_{};
+  bool pinned_{true};
+  bool started_{false};
+
+  std::mutex mutex_{};
+  std::condition_variable cv_{};
+  bool stop_{false};
+  std::thread thread_{};
+
+  auto run(std::vector<ubench::chrono::cpu_times>& cpus) -> void;
+  auto take(std::chrono::nanoseconds late,
+      std::vector<ubench::chrono::cpu_times>& cpus) -> void;
+};
+
+}  // namespace ubench::measure
+
+#endif
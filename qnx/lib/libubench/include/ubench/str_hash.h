@@ -0,0 +1,68 @@
+#ifndef UBENCH_STR_HASH_H
+#define UBENCH_STR_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ubench::string {
+
+/// @brief A fast 64-bit hash of a string.
+///
+/// The hash is in the style of wyhash. Strings up to 16 bytes are read with
+/// two to four overlapping loads, without a loop. Longer strings are read 32
+/// bytes per step in two independent lanes, each mixed with a 64x64 to 128-bit
+/// multiply.
+///
+/// The result depends on the byte order of the host, and must not be stored
+/// for use on another host.
+///
+/// @param str the string to hash.
+///
+/// @param seed a value to change the hash with.
+///
+/// @return the hash of the string.
+auto hash64(std::string_view str, std::uint64_t seed = 0) noexcept
+    -> std::uint64_t;
+
+/// @brief A fast 64-bit hash of a string, using SIMD instructions if the
+/// processor has them.
+///
+/// On x86 processors with AES-NI, the string is read 16 bytes at a time and
+/// mixed with the AES round instructions. Otherwise, this is the same as
+/// hash64(). The implementation is chosen on the first call, so the result is
+/// the same for the lifetime of the process, but may change on a different
+/// processor.
+///
+/// @param str the string to hash.
+///
+/// @param seed a value to change the hash with.
+///
+/// @return the hash of the string.
+auto hash64_simd(std::string_view str, std::uint64_t seed = 0) noexcept
+    -> std::uint64_t;
+
+/// @brief If hash64_simd() uses SIMD instructions on this processor.
+///
+/// @return true if SIMD instructions are used, false if it is the same as
+/// hash64().
+auto hash64_simd_enabled() noexcept -> bool;
+
+/// @brief A hash function object using hash64(), for unordered containers.
+struct fast_hash {
+  auto operator()(std::string_view str) const noexcept -> std::size_t {
+    return static_cast<std::size_t>(hash64(str));
+  }
+};
+
+/// @brief A hash function object using hash64_simd(), for unordered
+/// containers.
+struct simd_hash {
+  auto operator()(std::string_view str) const noexcept -> std::size_t {
+    return static_cast<std::size_t>(hash64_simd(str));
+  }
+};
+
+}  // namespace ubench::string
+
+#endif
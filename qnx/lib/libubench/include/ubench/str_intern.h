@@ -1,17 +1,108 @@
 #ifndef UBENCH_STR_INTERN_H
 #define UBENCH_STR_INTERN_H
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace ubench::string {
 
+/// @brief The hash table used to store the interned strings.
+enum class str_intern_backend {
+  /// @brief Each bucket is a list of strings with the same index (separate
+  /// chaining). Lookups must follow a pointer to the list node.
+  chained,
+
+  /// @brief A single contiguous array of slots holding the hash and a pointer
+  /// to the string (open addressing with Robin Hood linear probing). Collisions
+  /// are stored in the next free slot, so that a lookup usually reads a single
+  /// cache line before comparing the string.
+  open_addressing,
+};
+
+/// @brief How the strings are moved to the new buckets when growing.
+enum class str_intern_rehash {
+  /// @brief All strings are moved to the new buckets at once, in the call that
+  /// needs more buckets. That call takes longer the more strings are interned.
+  full,
+
+  /// @brief The old and the new buckets are used together, and every call
+  /// moves a small number of the old buckets to the new ones, until all are
+  /// moved. This bounds the time of moving the strings, at the cost of
+  /// looking in both while moving. The new buckets are still allocated and
+  /// cleared in the call that needs them, which for a large table takes
+  /// milliseconds.
+  incremental,
+};
+
+/// @brief The hash function used to find the bucket of a string.
+enum class str_intern_hash {
+  /// @brief std::hash<std::string_view> of the standard library. The speed and
+  /// the quality depend on the standard library.
+  standard,
+
+  /// @brief ubench::string::hash64(), reading up to 32 bytes per step.
+  fast,
+
+  /// @brief ubench::string::hash64_simd(), using AES instructions if the
+  /// processor has them, and the same as fast otherwise.
+  simd,
+};
+
+/// @brief Statistics of the interned strings, to choose the number of buckets
+/// and the load factor.
+///
+/// While an incremental rehash is in progress, the chain lengths are of the new
+/// buckets only, and the table bytes include the old buckets.
+struct str_intern_stats {
+  /// @brief Element zero is the number of empty buckets. For the chained
+  /// backend, element n is the number of buckets with n strings. For the
+  /// open_addressing backend, element n is the number of strings found after
+  /// reading n slots.
+  std::vector<std::size_t> chain_lengths{};
+
+  /// @brief The most strings compared to find a string, which is the index of
+  /// the last element of chain_lengths.
+  std::size_t longest_probe{};
+
+  /// @brief The bytes of memory obtained to store the strings.
+  std::size_t string_bytes{};
+
+  /// @brief The bytes of memory obtained for the buckets, the list nodes of the
+  /// chained backend, and the table of identifiers.
+  std::size_t table_bytes{};
+
+  /// @brief The number of times the buckets have grown.
+  std::size_t rehashes{};
+
+  /// @brief The total time spent moving strings to new buckets. Zero if the
+  /// counters are off, as reading the clock costs every call while rehashing
+  /// incrementally.
+  std::chrono::nanoseconds rehash_time{};
+
+  /// @brief If hits, misses and the rehash time are counted. They are not
+  /// counted if the library is built with UBENCH_STR_INTERN_COUNTERS off.
+  bool counters{};
+
+  /// @brief The number of calls to intern a string that was already interned.
+  std::uint64_t hits{};
+
+  /// @brief The number of calls to intern a new string.
+  std::uint64_t misses{};
+};
+
 /// @brief A fixed set is a custom implementation implementing a set of a
 /// dynamic number of buckets.
 class str_intern {
  public:
   str_intern() : str_intern(4096) {}
+  explicit str_intern(str_intern_backend backend)
+      : str_intern(4096, 1 << 20, backend) {}
   str_intern(const str_intern&) = delete;
   auto operator=(const str_intern&) -> str_intern& = delete;
   str_intern(str_intern&&) noexcept;
@@ -24,9 +115,18 @@ class str_intern {
   ///
   /// @param max_buckets Maximum number of buckets to use.
   ///
+  /// @param backend The hash table implementation to use.
+  ///
+  /// @param rehash How strings are moved when the buckets grow.
+  ///
+  /// @param hash The hash function for the strings.
+  ///
   /// @exception std::invalid_argument The parameter buckets or max_buckets is
   /// not a power of 2. The parameter max_buckets is less than buckets.
-  str_intern(std::size_t buckets, std::size_t max_buckets = 1 << 20);
+  str_intern(std::size_t buckets, std::size_t max_buckets = 1 << 20,
+      str_intern_backend backend = str_intern_backend::chained,
+      str_intern_rehash rehash = str_intern_rehash::full,
+      str_intern_hash hash = str_intern_hash::standard);
 
   /// @brief intern a given string and return the interned string.
   ///
@@ -34,8 +134,66 @@ class str_intern {
   ///
   /// @return the view of the interned string. It is one that either exists, or
   /// is copied and the copy is returned. This string is nul-terminated.
+  ///
+  /// @exception std::length_error The backend is open_addressing, and every
+  /// one of the max_buckets is already used, or there are no more identifiers.
   auto intern(std::string_view str) -> const std::string&;
 
+  /// @brief intern many strings at once.
+  ///
+  /// The result is the same as calling intern() for every string in order,
+  /// but the lookups of a group of strings are started together. On tables
+  /// much larger than the cache, the memory latency of the lookups then
+  /// overlaps, instead of being waited for one at a time.
+  ///
+  /// @param strs the strings to intern.
+  ///
+  /// @param count the number of strings in strs.
+  ///
+  /// @param out receives a pointer to the interned string for each of the
+  /// strings, and must have space for count pointers.
+  ///
+  /// @exception std::length_error See intern(). The strings before the one
+  /// that failed are interned.
+  auto intern_batch(const std::string_view* strs, std::size_t count,
+      const std::string** out) -> void;
+
+  /// @brief intern a given string and return its identifier.
+  ///
+  /// Identifiers are dense. The first string interned is given the identifier
+  /// zero, the next one, and so on, up to size() - 1. Strings interned with
+  /// intern() are also given an identifier.
+  ///
+  /// @param str the string to intern.
+  ///
+  /// @return the identifier of the interned string, which can be converted
+  /// back to the string with lookup().
+  ///
+  /// @exception std::length_error The backend is open_addressing, and every
+  /// one of the max_buckets is already used, or there are no more identifiers.
+  auto intern_id(std::string_view str) -> std::uint32_t;
+
+  /// @brief get the interned string for an identifier.
+  ///
+  /// @param id the identifier returned by intern_id().
+  ///
+  /// @return the view of the interned string, which is nul-terminated. The
+  /// view is valid for the lifetime of this object.
+  ///
+  /// @exception std::out_of_range The identifier was not given out.
+  [[nodiscard]] auto lookup(std::uint32_t id) const -> std::string_view;
+
+  /// @brief write a snapshot of the interned strings to a file.
+  ///
+  /// The snapshot contains the strings and a hash index over them, so that it
+  /// can be mapped into memory by str_intern_arena::map() without parsing.
+  /// Identifiers are kept.
+  ///
+  /// @param path the file to write. An existing file is replaced.
+  ///
+  /// @exception std::system_error The file couldn't be written.
+  auto save(const std::filesystem::path& path) const -> void;
+
   /// @brief get the number of strings interned.
   ///
   /// @return the number of strings interned.
@@ -60,14 +218,42 @@ class str_intern {
   /// so that less buckets are needed (e.g. the value increases), then the
   /// number of buckets remains as it was.
   ///
+  /// The open_addressing backend stores only one string per bucket, so the
+  /// load factor used is limited to 0.875, even if a larger value is set.
+  ///
   /// @param ml the new max load factor.
   auto max_load_factor(float ml) -> void;
 
   /// @brief Returns the number of buckets used for interning.
   ///
+  /// While an incremental rehash is in progress, this is the number of the new
+  /// buckets.
+  ///
   /// @return the number of buckets allocated.
   [[nodiscard]] auto bucket_count() const -> std::size_t;
 
+  /// @brief Returns the hash table implementation used.
+  ///
+  /// @return the backend given when constructed.
+  [[nodiscard]] auto backend() const -> str_intern_backend;
+
+  /// @brief Returns how strings are moved when the buckets grow.
+  ///
+  /// @return the rehash mode given when constructed.
+  [[nodiscard]] auto rehash_mode() const -> str_intern_rehash;
+
+  /// @brief Returns the hash function used.
+  ///
+  /// @return the hash function given when constructed.
+  [[nodiscard]] auto hash_function() const -> str_intern_hash;
+
+  /// @brief Returns statistics of the interned strings.
+  ///
+  /// This visits every bucket, so takes longer the more buckets there are.
+  ///
+  /// @return the statistics.
+  [[nodiscard]] auto stats() const -> str_intern_stats;
+
  private:
   class interned;
   std::unique_ptr<interned> interned_;
@@ -0,0 +1,183 @@
+#ifndef UBENCH_STR_INTERN_ARENA_H
+#define UBENCH_STR_INTERN_ARENA_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "ubench/str_intern.h"
+
+namespace ubench::string {
+
+/// @brief A set of interned strings, stored back to back in large blocks of
+/// memory.
+///
+/// This is the same as str_intern, but instead of a std::string for every
+/// interned string, the length, the bytes and a nul-terminator are copied
+/// into a memory arena. This saves the std::string object and the list node
+/// for every string, and strings that are interned one after the other are
+/// usually next to each other in memory. Strings are returned as a
+/// std::string_view.
+///
+/// The strings can be saved to a snapshot file, which is later mapped into
+/// memory with map(). Strings in the snapshot are returned from the mapping
+/// without copying, and new strings are interned into the buckets after it.
+class str_intern_arena {
+ public:
+  str_intern_arena() : str_intern_arena(4096) {}
+  explicit str_intern_arena(str_intern_backend backend)
+      : str_intern_arena(4096, 1 << 20, backend) {}
+  str_intern_arena(const str_intern_arena&) = delete;
+  auto operator=(const str_intern_arena&) -> str_intern_arena& = delete;
+  str_intern_arena(str_intern_arena&&) noexcept;
+  auto operator=(str_intern_arena&&) noexcept -> str_intern_arena&;
+  ~str_intern_arena();
+
+  /// @brief instantiate with a fixed number of buckets.
+  ///
+  /// @param buckets Number of buckets to use initially.
+  ///
+  /// @param max_buckets Maximum number of buckets to use.
+  ///
+  /// @param backend The hash table implementation to use.
+  ///
+  /// @param rehash How strings are moved when the buckets grow.
+  ///
+  /// @param hash The hash function for the strings.
+  ///
+  /// @exception std::invalid_argument The parameter buckets or max_buckets is
+  /// not a power of 2. The parameter max_buckets is less than buckets.
+  str_intern_arena(std::size_t buckets, std::size_t max_buckets = 1 << 20,
+      str_intern_backend backend = str_intern_backend::chained,
+      str_intern_rehash rehash = str_intern_rehash::full,
+      str_intern_hash hash = str_intern_hash::standard);
+
+  /// @brief map a snapshot into memory, to intern on top of it.
+  ///
+  /// The snapshot is written by save() or str_intern::save(). Strings from the
+  /// snapshot keep their identifiers, and are returned as views into the
+  /// mapping. New strings are given identifiers after the snapshot, and are
+  /// kept in buckets as for the default constructor. The bucket_count(),
+  /// max_load_factor(), backend(), rehash_mode(), hash_function() and stats()
+  /// apply to the new strings only.
+  ///
+  /// @param path the snapshot file.
+  ///
+  /// @return the interned strings, backed by the snapshot.
+  ///
+  /// @exception std::system_error The file couldn't be opened or mapped.
+  ///
+  /// @exception std::runtime_error The file is not a valid snapshot.
+  static auto map(const std::filesystem::path& path) -> str_intern_arena;
+
+  /// @brief intern a given string and return the interned string.
+  ///
+  /// @param str the string to intern.
+  ///
+  /// @return the view of the interned string. It is one that either exists, or
+  /// is copied and the copy is returned. This string is nul-terminated. The
+  /// view is valid for the lifetime of this object.
+  ///
+  /// @exception std::length_error The string is longer than 4GB. The backend
+  /// is open_addressing, and every one of the max_buckets is already used, or
+  /// there are no more identifiers.
+  auto intern(std::string_view str) -> std::string_view;
+
+  /// @brief intern many strings at once.
+  ///
+  /// See str_intern::intern_batch().
+  ///
+  /// @param strs the strings to intern.
+  ///
+  /// @param count the number of strings in strs.
+  ///
+  /// @param out receives the view of the interned string for each of the
+  /// strings, and must have space for count views.
+  ///
+  /// @exception std::length_error See intern().
+  auto intern_batch(const std::string_view* strs, std::size_t count,
+      std::string_view* out) -> void;
+
+  /// @brief intern a given string and return its identifier.
+  ///
+  /// See str_intern::intern_id().
+  ///
+  /// @param str the string to intern.
+  ///
+  /// @return the identifier of the interned string.
+  ///
+  /// @exception std::length_error See intern().
+  auto intern_id(std::string_view str) -> std::uint32_t;
+
+  /// @brief get the interned string for an identifier.
+  ///
+  /// @param id the identifier returned by intern_id().
+  ///
+  /// @return the view of the interned string, which is nul-terminated.
+  ///
+  /// @exception std::out_of_range The identifier was not given out.
+  [[nodiscard]] auto lookup(std::uint32_t id) const -> std::string_view;
+
+  /// @brief write a snapshot of the interned strings to a file.
+  ///
+  /// See str_intern::save(). The snapshot includes the strings of a snapshot
+  /// this was mapped from, and the file being mapped can be replaced.
+  ///
+  /// @param path the file to write. An existing file is replaced.
+  ///
+  /// @exception std::system_error The file couldn't be written.
+  auto save(const std::filesystem::path& path) const -> void;
+
+  /// @brief get the number of strings interned.
+  ///
+  /// @return the number of strings interned.
+  [[nodiscard]] auto size() const -> unsigned int;
+
+  /// @brief get the maximum load factor when rehashing.
+  ///
+  /// @return Returns current maximum load factor.
+  [[nodiscard]] auto max_load_factor() const -> float;
+
+  /// @brief set the maximum load factor when rehashing.
+  ///
+  /// See str_intern::max_load_factor(float).
+  ///
+  /// @param ml the new max load factor.
+  auto max_load_factor(float ml) -> void;
+
+  /// @brief Returns the number of buckets used for interning.
+  ///
+  /// @return the number of buckets allocated.
+  [[nodiscard]] auto bucket_count() const -> std::size_t;
+
+  /// @brief Returns the hash table implementation used.
+  ///
+  /// @return the backend given when constructed.
+  [[nodiscard]] auto backend() const -> str_intern_backend;
+
+  /// @brief Returns how strings are moved when the buckets grow.
+  ///
+  /// @return the rehash mode given when constructed.
+  [[nodiscard]] auto rehash_mode() const -> str_intern_rehash;
+
+  /// @brief Returns the hash function used.
+  ///
+  /// @return the hash function given when constructed.
+  [[nodiscard]] auto hash_function() const -> str_intern_hash;
+
+  /// @brief Returns statistics of the interned strings.
+  ///
+  /// See str_intern::stats().
+  ///
+  /// @return the statistics.
+  [[nodiscard]] auto stats() const -> str_intern_stats;
+
+ private:
+  class interned;
+  std::unique_ptr<interned> interned_;
+};
+
+}  // namespace ubench::string
+
+#endif
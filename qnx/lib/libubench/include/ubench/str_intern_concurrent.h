@@ -0,0 +1,104 @@
+#ifndef UBENCH_STR_INTERN_CONCURRENT_H
+#define UBENCH_STR_INTERN_CONCURRENT_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ubench::string {
+
+/// @brief A string interning set that may be used by multiple threads at the
+/// same time.
+///
+/// The set is split into shards, selected by the upper bits of the hash. Each
+/// shard has its own buckets, memory and lock. Looking up a string that is
+/// already interned doesn't take any lock. Only inserting a new string locks
+/// the shard it belongs to, and when the shard needs to grow, only that shard
+/// is rehashed.
+///
+/// A rehash doesn't free the buckets being replaced, as other threads may still
+/// be reading them. They're freed when this object is destroyed. As the number
+/// of buckets doubles on each rehash, the memory held is less than that of the
+/// final number of buckets.
+///
+/// For the same reason, a rehash copies the chain node of every string in the
+/// shard instead of moving it, and the old nodes are also kept until this
+/// object is destroyed. As each rehash happens when the strings have doubled,
+/// the nodes held approach twice the number of strings.
+class str_intern_concurrent {
+ public:
+  str_intern_concurrent() : str_intern_concurrent(16, 4096) {}
+  str_intern_concurrent(const str_intern_concurrent&) = delete;
+  auto operator=(const str_intern_concurrent&)
+      -> str_intern_concurrent& = delete;
+  str_intern_concurrent(str_intern_concurrent&&) noexcept;
+  auto operator=(str_intern_concurrent&&) noexcept -> str_intern_concurrent&;
+  ~str_intern_concurrent();
+
+  /// @brief instantiate with a number of shards and buckets.
+  ///
+  /// The buckets are divided evenly over all the shards.
+  ///
+  /// @param shards Number of shards to split the set into.
+  ///
+  /// @param buckets Number of buckets to use initially over all shards.
+  ///
+  /// @param max_buckets Maximum number of buckets to use over all shards.
+  ///
+  /// @exception std::invalid_argument The parameter shards, buckets or
+  /// max_buckets is not a power of 2. The parameter buckets is less than
+  /// shards. The parameter max_buckets is less than buckets.
+  str_intern_concurrent(std::size_t shards, std::size_t buckets,
+      std::size_t max_buckets = 1 << 20);
+
+  /// @brief intern a given string and return the interned string.
+  ///
+  /// This method is thread-safe.
+  ///
+  /// @param str the string to intern.
+  ///
+  /// @return the view of the interned string. It is one that either exists, or
+  /// is copied and the copy is returned. This string is nul-terminated. The
+  /// reference is valid for the lifetime of this object.
+  auto intern(std::string_view str) -> const std::string&;
+
+  /// @brief get the number of strings interned.
+  ///
+  /// When called while other threads are interning, the result is a snapshot
+  /// which may already be out of date.
+  ///
+  /// @return the number of strings interned.
+  [[nodiscard]] auto size() const -> unsigned int;
+
+  /// @brief get the maximum load factor when rehashing.
+  ///
+  /// @return Returns current maximum load factor.
+  [[nodiscard]] auto max_load_factor() const -> float;
+
+  /// @brief set the maximum load factor when rehashing.
+  ///
+  /// The max load factor applies to each shard individually. See
+  /// str_intern::max_load_factor(float) for details. This method is
+  /// thread-safe.
+  ///
+  /// @param ml the new max load factor.
+  auto max_load_factor(float ml) -> void;
+
+  /// @brief Returns the number of buckets used for interning over all shards.
+  ///
+  /// @return the number of buckets allocated.
+  [[nodiscard]] auto bucket_count() const -> std::size_t;
+
+  /// @brief Returns the number of shards.
+  ///
+  /// @return the number of shards.
+  [[nodiscard]] auto shard_count() const -> std::size_t;
+
+ private:
+  class interned;
+  std::unique_ptr<interned> interned_;
+};
+
+}  // namespace ubench::string
+
+#endif
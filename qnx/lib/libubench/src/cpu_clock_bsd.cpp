@@ -0,0 +1,115 @@
+#include <sys/types.h>
+#include <sys/proc.h>
+#include <sys/sched.h>
+#include <sys/sysctl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "ubench/clock.h"
+
+namespace ubench::chrono {
+
+namespace {
+
+class cp_times_cpu_clock {
+ public:
+  cp_times_cpu_clock() noexcept { init_cpu_clock(); }
+  cp_times_cpu_clock(const cp_times_cpu_clock& other) = delete;
+  auto operator=(const cp_times_cpu_clock& other)
+      -> cp_times_cpu_clock& = delete;
+  cp_times_cpu_clock(cp_times_cpu_clock&& other) = delete;
+  auto operator=(cp_times_cpu_clock&& other) -> cp_times_cpu_clock& = delete;
+  ~cp_times_cpu_clock() = default;
+
+  [[nodiscard]] auto is_enabled() const noexcept -> bool {
+    return (clock_ticks_per_sec_ != 0);
+  }
+
+  auto get_cpu_times(std::vector<cpu_times>& cpus) -> bool {
+    cpus.clear();
+    if (clock_ticks_per_sec_ == 0) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t size = sizeof(decltype(times_)::value_type) * CPUSTATES * ncpu_;
+    if (sysctl(mib_cp_times_.data(), mib_cp_times_.size(), times_.data(), &size,
+            nullptr, 0) < 0)
+      return false;
+
+    // BSD doesn't separate soft interrupts, steal or I/O wait time. Each is
+    // sampled on the clock tick, the same as for the idle_clock.
+    auto ns = [&](std::uint64_t ticks) {
+      return std::chrono::nanoseconds(
+          1000000000 / clock_ticks_per_sec_ * ticks);
+    };
+    cpus.resize(ncpu_);
+    for (std::size_t cpu = 0; cpu < ncpu_; cpu++) {
+      const std::uint64_t* t = &times_[cpu * CPUSTATES];
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      cpus[cpu].user = ns(t[CP_USER] + t[CP_NICE]);
+      cpus[cpu].system = ns(t[CP_SYS]);
+      cpus[cpu].irq = ns(t[CP_INTR]);
+      cpus[cpu].idle = ns(t[CP_IDLE]);
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return true;
+  }
+
+ private:
+  long clock_ticks_per_sec_{};
+  unsigned int ncpu_{};
+  std::mutex mutex_{};
+  std::vector<std::uint64_t> times_{};
+  std::array<int, 2> mib_cp_times_{};
+
+  // As for the idle_clock in idle_clock_bsd.cpp.
+  auto init_cpu_clock() noexcept -> void {
+    std::array<int, 2> mib{};
+    mib[0] = CTL_HW;
+    mib[1] = HW_NCPU;
+    std::size_t size = sizeof(ncpu_);
+    if (sysctl(mib.data(), 2, &ncpu_, &size, nullptr, 0) < 0) return;
+    if (ncpu_ > 0xFFFF) return;
+
+    clock_ticks_per_sec_ = sysconf(_SC_CLK_TCK);
+    if (clock_ticks_per_sec_ <= 0) {
+      clock_ticks_per_sec_ = 0;
+      return;
+    }
+
+    // NOLINTNEXTLINE(bugprone-implicit-widening-of-multiplication-result)
+    times_.resize(ncpu_ * CPUSTATES);
+
+#if __NetBSD__
+    mib_cp_times_[0] = CTL_KERN;
+    mib_cp_times_[1] = KERN_CP_TIME;
+#elif __FreeBSD__
+    size_t len = mib_cp_times_.size();
+    if (sysctlnametomib("kern.cp_times", mib_cp_times_.data(), &len) == -1) {
+      clock_ticks_per_sec_ = 0;
+    }
+#else
+    clock_ticks_per_sec_ = 0;
+#endif
+  }
+};
+
+auto bsd_cpu_clock() -> cp_times_cpu_clock& {
+  static cp_times_cpu_clock clock{};
+  return clock;
+}
+
+}  // namespace
+
+auto cpu_clock::now(std::vector<cpu_times>& cpus) -> bool {
+  return bsd_cpu_clock().get_cpu_times(cpus);
+}
+
+auto cpu_clock::is_available() noexcept -> bool {
+  return bsd_cpu_clock().is_enabled();
+}
+
+}  // namespace ubench::chrono
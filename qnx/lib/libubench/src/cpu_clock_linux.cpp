@@ -0,0 +1,121 @@
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "ubench/clock.h"
+#include "ubench/file.h"
+#include "proc_stat.h"
+
+namespace ubench::chrono {
+
+namespace {
+
+class proc_cpu_clock {
+ public:
+  proc_cpu_clock() noexcept
+      : cpu_stats_{open_proc_stat(clock_ticks_per_sec_)} {}
+  proc_cpu_clock(const proc_cpu_clock& other) = delete;
+  auto operator=(const proc_cpu_clock& other) -> proc_cpu_clock& = delete;
+  proc_cpu_clock(proc_cpu_clock&& other) = delete;
+  auto operator=(proc_cpu_clock&& other) -> proc_cpu_clock& = delete;
+  ~proc_cpu_clock() = default;
+
+  [[nodiscard]] auto is_enabled() const noexcept -> bool { return cpu_stats_; }
+
+  auto get_cpu_times(std::vector<cpu_times>& cpus) -> bool {
+    cpus.clear();
+    if (!cpu_stats_) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!read_file()) return false;
+
+    // The "cpuN" lines follow the total "cpu" line, each with the fields
+    // user nice system idle iowait irq softirq steal, in jiffies.
+    const char* p = buf_.data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const char* end = p + len_;
+    while (p != end) {
+      const char* eol =
+          static_cast<const char*>(std::memchr(p, '\n', end - p));
+      if (!eol) eol = end;
+      if (eol - p > 3 && std::memcmp(p, "cpu", 3) == 0 && p[3] != ' ') {
+        p += 3;
+        std::uint64_t cpu = 0;
+        std::array<std::uint64_t, 8> fields{};
+        if (parse_uint(p, eol, cpu)) {
+          // Older kernels don't have all fields, which remain zero.
+          for (auto& field : fields) {
+            if (!parse_uint(p, eol, field)) break;
+          }
+          if (cpu >= cpus.size()) cpus.resize(cpu + 1);
+          cpus[cpu] = to_times(fields);
+        }
+      } else if (std::memcmp(p, "cpu", 3) != 0 && !cpus.empty()) {
+        // The CPU lines are all at the start of the file.
+        break;
+      }
+      p = eol == end ? end : eol + 1;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return !cpus.empty();
+  }
+
+ private:
+  long clock_ticks_per_sec_{0};
+  ubench::file::fdesc cpu_stats_{};
+  std::mutex mutex_{};
+  std::vector<char> buf_ = std::vector<char>(4096);
+  std::size_t len_{0};
+
+  // Read the file into the buffer, from the start. The buffer grows until the
+  // file fits, so later calls don't allocate.
+  auto read_file() -> bool {
+    while (true) {
+      ssize_t len = pread(cpu_stats_, buf_.data(), buf_.size(), 0);
+      if (len <= 0) return false;
+      if (static_cast<std::size_t>(len) < buf_.size()) {
+        len_ = static_cast<std::size_t>(len);
+        return true;
+      }
+      buf_.resize(buf_.size() * 2);
+    }
+  }
+
+  [[nodiscard]] auto to_times(const std::array<std::uint64_t, 8>& fields) const
+      -> cpu_times {
+    auto ns = [&](std::uint64_t jiffies) {
+      return std::chrono::nanoseconds(
+          1000000000 / clock_ticks_per_sec_ * jiffies);
+    };
+    cpu_times t{};
+    t.user = ns(fields[0] + fields[1]);
+    t.system = ns(fields[2]);
+    t.idle = ns(fields[3]);
+    t.iowait = ns(fields[4]);
+    t.irq = ns(fields[5]);
+    t.softirq = ns(fields[6]);
+    t.steal = ns(fields[7]);
+    return t;
+  }
+};
+
+auto linux_cpu_clock() -> proc_cpu_clock& {
+  static proc_cpu_clock clock{};
+  return clock;
+}
+
+}  // namespace
+
+auto cpu_clock::now(std::vector<cpu_times>& cpus) -> bool {
+  return linux_cpu_clock().get_cpu_times(cpus);
+}
+
+auto cpu_clock::is_available() noexcept -> bool {
+  return linux_cpu_clock().is_enabled();
+}
+
+}  // namespace ubench::chrono
@@ -0,0 +1,14 @@
+#include <vector>
+
+#include "ubench/clock.h"
+
+namespace ubench::chrono {
+
+auto cpu_clock::now(std::vector<cpu_times>& cpus) -> bool {
+  cpus.clear();
+  return false;
+}
+
+auto cpu_clock::is_available() noexcept -> bool { return false; }
+
+}  // namespace ubench::chrono
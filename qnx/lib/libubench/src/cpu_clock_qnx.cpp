@@ -0,0 +1,58 @@
+#include <sys/neutrino.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "ubench/clock.h"
+#include "ubench/thread.h"
+
+namespace ubench::chrono {
+
+namespace {
+
+// The clocks of the idle thread of each CPU, as for the idle_clock. QNX
+// doesn't count the other states, so only the idle time is given.
+//
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::vector<int> cpu_idle_clocks{};
+
+auto init_cpu_clocks() -> bool {
+  auto threads = ubench::thread::thread_count();
+  cpu_idle_clocks.reserve(threads);
+  for (std::size_t i = 0; i < threads; i++) {
+    int result = ClockId(1, i + 1);
+    if (result == -1) {
+      cpu_idle_clocks.clear();
+      return false;
+    }
+    cpu_idle_clocks.emplace_back(result);
+  }
+  return true;
+}
+
+auto init_static() -> bool {
+  static const auto result = init_cpu_clocks();
+  return result;
+}
+
+}  // namespace
+
+auto cpu_clock::now(std::vector<cpu_times>& cpus) -> bool {
+  cpus.clear();
+  if (!init_static()) return false;
+
+  cpus.resize(cpu_idle_clocks.size());
+  for (std::size_t cpu = 0; cpu < cpu_idle_clocks.size(); cpu++) {
+    std::uint64_t idle_time = 0;
+    if (ClockTime(cpu_idle_clocks[cpu], nullptr, &idle_time) == -1) {
+      cpus.clear();
+      return false;
+    }
+    cpus[cpu].idle = std::chrono::nanoseconds(idle_time);
+  }
+  return true;
+}
+
+auto cpu_clock::is_available() noexcept -> bool { return init_static(); }
+
+}  // namespace ubench::chrono
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "ubench/clock.h"
+
+namespace ubench::chrono {
+
+namespace {
+
+auto calibrate() noexcept -> double {
+  if constexpr (cycle_clock::type() == cycle_clock_type::steady) {
+    using period = std::chrono::steady_clock::period;
+    return 1e9 * static_cast<double>(period::num) /
+           static_cast<double>(period::den);
+  }
+
+  // The counter is read just after the steady clock at both ends, so the time
+  // to read the clocks cancels out.
+  constexpr auto period = std::chrono::milliseconds{10};
+  auto start = std::chrono::steady_clock::now();
+  std::uint64_t start_ticks = cycle_clock::ticks();
+  auto end = start;
+  while (end - start < period) {
+    end = std::chrono::steady_clock::now();
+  }
+  std::uint64_t end_ticks = cycle_clock::ticks();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+  if (end_ticks == start_ticks) return 1.0;
+  return static_cast<double>(ns.count()) /
+         static_cast<double>(end_ticks - start_ticks);
+}
+
+}  // namespace
+
+auto cycle_clock::ns_per_tick() noexcept -> double {
+  static const double rate = calibrate();
+  return rate;
+}
+
+auto cycle_clock::is_invariant() noexcept -> bool {
+#if defined(__x86_64__) || defined(__i386__)
+  // Advanced Power Management, EDX bit 8 is the invariant TSC.
+  constexpr unsigned int leaf_apm = 0x80000007;
+  unsigned int eax = 0;
+  unsigned int ebx = 0;
+  unsigned int ecx = 0;
+  unsigned int edx = 0;
+  if (__get_cpuid_max(0x80000000, nullptr) < leaf_apm) return false;
+  if (!__get_cpuid(leaf_apm, &eax, &ebx, &ecx, &edx)) return false;
+  return (edx & (1U << 8)) != 0;
+#else
+  return true;
+#endif
+}
+
+}  // namespace ubench::chrono
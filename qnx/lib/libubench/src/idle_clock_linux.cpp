@@ -1,14 +1,14 @@
 #include <unistd.h>
 
+#include <array>
 #include <cstdint>
-#include <fstream>
-#include <locale>
+#include <cstring>
 #include <memory>
-#include <sstream>
-#include <string>
 
 #include "ubench/clock.h"
+#include "ubench/file.h"
 #include "base_clock.h"
+#include "proc_stat.h"
 
 namespace ubench::chrono {
 
@@ -16,7 +16,8 @@ namespace {
 
 class proc_idle_clock : public base_clock {
  public:
-  proc_idle_clock() noexcept { init_proc_clock(); }
+  proc_idle_clock() noexcept
+      : cpu_stats_{open_proc_stat(clock_ticks_per_sec_)} {}
   proc_idle_clock(const proc_idle_clock& other) = delete;
   auto operator=(const proc_idle_clock& other) -> proc_idle_clock& = delete;
   proc_idle_clock(proc_idle_clock&& other) = delete;
@@ -24,7 +25,7 @@ class proc_idle_clock : public base_clock {
   ~proc_idle_clock() override = default;
 
   [[nodiscard]] auto is_enabled() const noexcept -> bool override {
-    return cpu_stats_.is_open();
+    return cpu_stats_;
   }
 
   [[nodiscard]] auto get_idle_clock() noexcept -> std::uint64_t override {
@@ -32,58 +33,39 @@ class proc_idle_clock : public base_clock {
   }
 
   [[nodiscard]] auto type() const noexcept -> idle_clock_type override {
-    if (!cpu_stats_.is_open()) return idle_clock_type::null;
+    if (!cpu_stats_) return idle_clock_type::null;
     return idle_clock_type::proc_stat;
   }
 
  private:
   long clock_ticks_per_sec_{0};
-  std::ifstream cpu_stats_{};
+  ubench::file::fdesc cpu_stats_{};
 
-  auto init_proc_clock() noexcept -> void {
-    clock_ticks_per_sec_ = sysconf(_SC_CLK_TCK);
-    if (clock_ticks_per_sec_ <= 0) {
-      clock_ticks_per_sec_ = 0;
-      return;
-    }
+  // The first line is "cpu  user nice system idle ...", in jiffies.
+  //
+  // This is called to sample the idle time, so it doesn't allocate, and parses
+  // only up to the field it needs.
+  auto get_idle_time() noexcept -> std::uint64_t {
+    if (!cpu_stats_) return 0;
 
-    cpu_stats_.open("/proc/stat");
-    if (!cpu_stats_) {
-      cpu_stats_.close();
-      clock_ticks_per_sec_ = 0;
-      return;
-    }
+    std::array<char, 256> buf{};
+    ssize_t len = pread(cpu_stats_, buf.data(), buf.size(), 0);
+    if (len <= 0) return 0;
 
-    // Ensure that we always interpret the /proc/stats correctly irrespective of
-    // whatever locale the user has configured.
-    cpu_stats_.imbue(std::locale::classic());
-  }
+    const char* p = buf.data();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const char* end = p + len;
+    if (len < 4 || std::memcmp(p, "cpu ", 4) != 0) return 0;
+    p += 4;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
-  auto get_idle_time() noexcept -> std::uint64_t {
-    if (!cpu_stats_.is_open()) return 0;
-
-    std::string line;
-    if (!std::getline(cpu_stats_, line)) return 0;
-
-    std::istringstream iss(line);
-    std::string token;
-    int i = 0;
-    while (iss >> token) {
-      if (i == 4) {
-        std::uint64_t idle_time = std::stoull(token);
-        cpu_stats_.clear();
-        cpu_stats_.seekg(0);
-
-        // The idle_time is in units of jiffies. Need to convert this to
-        // nanoseconds.
-        return 1000000000 / clock_ticks_per_sec_ * idle_time;
-      }
-      i++;
+    std::uint64_t idle_time = 0;
+    for (int i = 0; i < 4; i++) {
+      if (!parse_uint(p, end, idle_time)) return 0;
     }
 
-    // Error, didn't find the contents. So close.
-    cpu_stats_.close();
-    return 0;
+    // The idle_time is in units of jiffies. Need to convert this to
+    // nanoseconds.
+    return 1000000000 / clock_ticks_per_sec_ * idle_time;
   }
 };
 
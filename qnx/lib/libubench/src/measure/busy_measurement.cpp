@@ -1,22 +1,60 @@
 #include "ubench/measure/busy_measurement.h"
 
+#include <string>
+
 #include "ubench/thread.h"
 
 namespace ubench::measure {
 
-busy_stop_watch::busy_stop_watch() noexcept { reset(); }
+namespace {
+
+auto to_ms(std::chrono::nanoseconds ns) -> std::chrono::milliseconds {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(ns);
+}
+
+// The time of a CPU between two readings. The run time isn't read from the
+// CPU, so the busy time is what remains of it.
+auto cpu_span(const ubench::chrono::cpu_times& start,
+    const ubench::chrono::cpu_times& end, std::chrono::nanoseconds run_time)
+    -> cpu_measurement {
+  cpu_measurement result{};
+  result.user = to_ms(end.user - start.user);
+  result.system = to_ms(end.system - start.system);
+  result.irq = to_ms(end.irq - start.irq);
+  result.softirq = to_ms(end.softirq - start.softirq);
+  result.steal = to_ms(end.steal - start.steal);
+  result.iowait = to_ms(end.iowait - start.iowait);
+  result.idle = to_ms(end.idle - start.idle);
+
+  auto not_busy = (end.idle - start.idle) + (end.iowait - start.iowait) +
+                  (end.steal - start.steal);
+  if (run_time > not_busy) {
+    result.busy = to_ms(run_time - not_busy);
+  } else {
+    result.busy = std::chrono::milliseconds(0);
+  }
+  return result;
+}
+
+}  // namespace
+
+busy_stop_watch::busy_stop_watch() { reset(); }
 
 auto busy_stop_watch::reset() -> void {
+  // Read the CPU times first, as they may allocate on the first read.
+  ubench::chrono::cpu_clock::now(start_cpus_);
   start_idle_ = ubench::chrono::idle_clock::now();
   start_proc_ = ubench::chrono::process_clock::now();
   start_time_ = std::chrono::high_resolution_clock::now();
 }
 
-auto busy_stop_watch::measure() const noexcept -> busy_measurement {
+auto busy_stop_watch::measure() const -> busy_measurement {
   busy_measurement result{};
   auto end_idle = ubench::chrono::idle_clock::now();
   auto end_proc = ubench::chrono::process_clock::now();
   auto end_time = std::chrono::high_resolution_clock::now();
+  std::vector<ubench::chrono::cpu_times> end_cpus{};
+  ubench::chrono::cpu_clock::now(end_cpus);
 
   // Use default nanosecond resolution to reduce rounding errors later when
   // multiplying by the number of cores.
@@ -43,6 +81,41 @@ auto busy_stop_watch::measure() const noexcept -> busy_measurement {
       std::chrono::duration_cast<std::chrono::milliseconds>(proc_span);
   result.run_time =
       std::chrono::duration_cast<std::chrono::milliseconds>(time_span);
+
+  // A CPU that came online during the measurement has no start time, so the
+  // CPUs are only given if the same CPUs were read at the start and end.
+  if (!start_cpus_.empty() && start_cpus_.size() == end_cpus.size()) {
+    result.cpus.reserve(end_cpus.size());
+    for (std::size_t cpu = 0; cpu < end_cpus.size(); cpu++) {
+      result.cpus.emplace_back(
+          cpu_span(start_cpus_[cpu], end_cpus[cpu], time_span));
+    }
+  }
+  return result;
+}
+
+auto make_cpu_table(const busy_measurement& measurement) -> table {
+  table result{};
+  if (measurement.cpus.empty()) return result;
+
+  result.add_column("CPU", alignment::right);
+  result.add_column("Busy %", alignment::right);
+  result.add_column("User %", alignment::right);
+  result.add_column("System %", alignment::right);
+  result.add_column("IRQ %", alignment::right);
+  result.add_column("SoftIRQ %", alignment::right);
+  result.add_column("Steal %", alignment::right);
+  result.add_column("IOWait %", alignment::right);
+  result.add_column("Idle %", alignment::right);
+
+  auto run = measurement.run_time;
+  for (std::size_t cpu = 0; cpu < measurement.cpus.size(); cpu++) {
+    const auto& m = measurement.cpus[cpu];
+    result.add_line({std::to_string(cpu), percent(m.busy, run),
+        percent(m.user, run), percent(m.system, run), percent(m.irq, run),
+        percent(m.softirq, run), percent(m.steal, run), percent(m.iowait, run),
+        percent(m.idle, run)});
+  }
   return result;
 }
 
@@ -0,0 +1,68 @@
+#include "ubench/measure/latency_histogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace ubench::measure {
+
+auto latency_histogram::index(std::uint64_t value) noexcept -> unsigned int {
+  if (value < SUB_BUCKETS) return static_cast<unsigned int>(value);
+
+  // The position of the highest bit set, so that value >> shift is between
+  // SUB_BUCKETS and 2 * SUB_BUCKETS - 1.
+  unsigned int shift = 0;
+  while ((value >> shift) >= 2 * SUB_BUCKETS) shift++;
+  auto sub = static_cast<unsigned int>(value >> shift) - SUB_BUCKETS;
+  return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+auto latency_histogram::highest(unsigned int index) noexcept -> std::uint64_t {
+  if (index < SUB_BUCKETS) return index;
+
+  unsigned int shift = index / SUB_BUCKETS - 1;
+  std::uint64_t sub = index % SUB_BUCKETS + SUB_BUCKETS;
+  return ((sub + 1) << shift) - 1;
+}
+
+auto latency_histogram::record(std::chrono::nanoseconds latency) noexcept
+    -> void {
+  auto value = static_cast<std::uint64_t>(
+      std::max(latency.count(), static_cast<std::int64_t>(0)));
+  counts_[index(value)]++;
+  count_++;
+  max_ = std::max(max_, value);
+}
+
+auto latency_histogram::merge(const latency_histogram& other) noexcept
+    -> void {
+  for (unsigned int i = 0; i < BUCKETS; i++) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  max_ = std::max(max_, other.max_);
+}
+
+auto latency_histogram::percentile(double percentile) const noexcept
+    -> std::chrono::nanoseconds {
+  if (count_ == 0) return std::chrono::nanoseconds{0};
+
+  auto target = static_cast<std::uint64_t>(
+      std::ceil(static_cast<double>(count_) * percentile / 100.0));
+  target = std::clamp(target, static_cast<std::uint64_t>(1), count_);
+
+  std::uint64_t seen = 0;
+  for (unsigned int i = 0; i < BUCKETS; i++) {
+    seen += counts_[i];
+    if (seen >= target) {
+      // The bucket may be wider than the largest value recorded.
+      return std::chrono::nanoseconds{
+          static_cast<std::chrono::nanoseconds::rep>(
+              std::min(highest(i), max_))};
+    }
+  }
+  return max();
+}
+
+}  // namespace ubench::measure
@@ -0,0 +1,22 @@
+#include "ubench/measure/perf_counters.h"
+
+namespace ubench::measure {
+
+auto perf_event_name(perf_event event) noexcept -> const char* {
+  switch (event) {
+    case perf_event::cycles:
+      return "Cycles";
+    case perf_event::instructions:
+      return "Instructions";
+    case perf_event::cache_misses:
+      return "LLC Misses";
+    case perf_event::l1d_misses:
+      return "L1D Misses";
+    case perf_event::branch_misses:
+      return "Branch Misses";
+    default:
+      return "Unknown";
+  }
+}
+
+}  // namespace ubench::measure
@@ -0,0 +1,154 @@
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+
+#include "ubench/measure/perf_counters.h"
+
+namespace ubench::measure {
+
+namespace {
+
+struct event_config {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+// In the order of perf_event. The first is the leader of the group, which
+// must be available for the others to be opened.
+constexpr std::array<event_config, perf_event_count> events = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+
+auto open_event(const event_config& event, int group) -> int {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  // Only the leader is disabled, the others are enabled with it.
+  attr.disabled = group == -1 ? 1 : 0;
+  attr.inherit = 1;
+  // Counting the kernel is usually not allowed to a user.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC));
+}
+
+}  // namespace
+
+class perf_counters::perf_counters_impl {
+ public:
+  perf_counters_impl() noexcept {
+    fds_.fill(-1);
+    fds_[0] = open_event(events[0], -1);
+    if (fds_[0] == -1) {
+      error_ = errno;
+      return;
+    }
+    for (std::size_t e = 1; e < events.size(); e++) {
+      fds_[e] = open_event(events[e], fds_[0]);
+    }
+  }
+
+  perf_counters_impl(const perf_counters_impl&) = delete;
+  perf_counters_impl(perf_counters_impl&&) = delete;
+  auto operator=(const perf_counters_impl&) -> perf_counters_impl& = delete;
+  auto operator=(perf_counters_impl&&) -> perf_counters_impl& = delete;
+
+  ~perf_counters_impl() {
+    // The members of the group are closed before the leader.
+    for (auto it = fds_.rbegin(); it != fds_.rend(); ++it) {
+      if (*it != -1) close(*it);
+    }
+  }
+
+  [[nodiscard]] auto is_available() const noexcept -> bool {
+    return fds_[0] != -1;
+  }
+
+  [[nodiscard]] auto error() const noexcept -> int { return error_; }
+
+  auto start() noexcept -> void {
+    if (fds_[0] == -1) return;
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  auto stop() noexcept -> void {
+    if (fds_[0] == -1) return;
+    ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  [[nodiscard]] auto read() const noexcept -> perf_sample {
+    perf_sample sample{};
+    for (std::size_t e = 0; e < fds_.size(); e++) {
+      if (fds_[e] == -1) continue;
+
+      // The value, the time enabled and the time running.
+      std::array<std::uint64_t, 3> data{};
+      auto len = ::read(fds_[e], data.data(), sizeof(data));
+      if (len != static_cast<ssize_t>(sizeof(data))) continue;
+
+      // The group didn't run, as the CPU doesn't have enough counters.
+      if (data[2] == 0) continue;
+      if (data[2] < data[1]) {
+        sample.scaled = true;
+        sample.values[e] = static_cast<std::uint64_t>(
+            static_cast<long double>(data[0]) * data[1] / data[2]);
+      } else {
+        sample.values[e] = data[0];
+      }
+    }
+    return sample;
+  }
+
+ private:
+  std::array<int, perf_event_count> fds_{};
+  int error_{};
+};
+
+perf_counters::perf_counters()
+    : impl_{std::make_unique<perf_counters::perf_counters_impl>()} {}
+
+perf_counters::perf_counters(perf_counters&&) noexcept = default;
+
+auto perf_counters::operator=(perf_counters&&) noexcept
+    -> perf_counters& = default;
+
+perf_counters::~perf_counters() = default;
+
+auto perf_counters::is_available() const noexcept -> bool {
+  return impl_ && impl_->is_available();
+}
+
+auto perf_counters::error() const noexcept -> int {
+  return impl_ ? impl_->error() : 0;
+}
+
+auto perf_counters::start() noexcept -> void {
+  if (impl_) impl_->start();
+}
+
+auto perf_counters::stop() noexcept -> void {
+  if (impl_) impl_->stop();
+}
+
+auto perf_counters::read() const noexcept -> perf_sample {
+  if (!impl_) return {};
+  return impl_->read();
+}
+
+}  // namespace ubench::measure
@@ -0,0 +1,28 @@
+#include <cerrno>
+
+#include "ubench/measure/perf_counters.h"
+
+namespace ubench::measure {
+
+class perf_counters::perf_counters_impl {};
+
+perf_counters::perf_counters() = default;
+
+perf_counters::perf_counters(perf_counters&&) noexcept = default;
+
+auto perf_counters::operator=(perf_counters&&) noexcept
+    -> perf_counters& = default;
+
+perf_counters::~perf_counters() = default;
+
+auto perf_counters::is_available() const noexcept -> bool { return false; }
+
+auto perf_counters::error() const noexcept -> int { return ENOSYS; }
+
+auto perf_counters::start() noexcept -> void {}
+
+auto perf_counters::stop() noexcept -> void {}
+
+auto perf_counters::read() const noexcept -> perf_sample { return {}; }
+
+}  // namespace ubench::measure
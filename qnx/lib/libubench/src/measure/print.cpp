@@ -1,12 +1,100 @@
 #include "ubench/measure/print.h"
 
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <string>
+#include <utility>
 
 namespace ubench::measure {
 
+namespace {
+
+auto is_digit(char c) -> bool {
+  return std::isdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+/// @brief Check if the cell is a number in the JSON grammar, such as "-12",
+/// "0.5" or "1e-3". Numbers with a leading zero or a plus sign are not.
+auto is_json_number(const std::string& cell) -> bool {
+  std::size_t p = 0;
+  std::size_t len = cell.length();
+  if (p < len && cell[p] == '-') p++;
+  if (p == len || !is_digit(cell[p])) return false;
+  if (cell[p] == '0') {
+    p++;
+  } else {
+    while (p < len && is_digit(cell[p])) p++;
+  }
+  if (p < len && cell[p] == '.') {
+    p++;
+    if (p == len || !is_digit(cell[p])) return false;
+    while (p < len && is_digit(cell[p])) p++;
+  }
+  if (p < len && (cell[p] == 'e' || cell[p] == 'E')) {
+    p++;
+    if (p < len && (cell[p] == '+' || cell[p] == '-')) p++;
+    if (p == len || !is_digit(cell[p])) return false;
+    while (p < len && is_digit(cell[p])) p++;
+  }
+  return p == len;
+}
+
+auto json_print_string(std::ostream& os, const std::string& str) -> void {
+  os << '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast<int>(c) << std::dec << std::setfill(' ');
+        } else {
+          os << c;
+        }
+        break;
+    }
+  }
+  os << '"';
+}
+
+auto json_print_cell(std::ostream& os, const std::string& cell) -> void {
+  if (is_json_number(cell)) {
+    os << cell;
+  } else {
+    json_print_string(os, cell);
+  }
+}
+
+}  // namespace
+
+auto percent(std::chrono::nanoseconds time, std::chrono::nanoseconds total)
+    -> std::string {
+  if (total.count() <= 0) return "-";
+  // The product is in long double, as time * 10000 overflows 64 bits after
+  // about 10 days.
+  auto p = static_cast<std::uint64_t>(
+      static_cast<long double>(time.count()) * 10000 / total.count());
+  std::string frac = std::to_string(p % 100);
+  if (frac.size() < 2) frac.insert(0, 1, '0');
+  return std::to_string(p / 100) + "." + frac;
+}
+
 auto table::md_print_row(std::ostream& os, const std::vector<std::string>& row,
     const std::vector<ubench::measure::table::colprop>& prop) const -> void {
   os << "| ";
@@ -99,6 +187,35 @@ auto table::add_line(std::initializer_list<std::string> line) -> bool {
   return true;
 }
 
+auto table::add_line(std::vector<std::string> line) -> bool {
+  // The number of columns given for this row doesn't match.
+  if (!colprop_.empty() && line.size() != colprop_.size()) return false;
+
+  auto& l = table_.emplace_back(std::move(line));
+  update_cols(l);
+  return true;
+}
+
+auto table::write_json(std::ostream& os) const -> void {
+  os << "[";
+  bool first_row = true;
+  for (const auto& row : table_) {
+    os << (first_row ? "\n  " : ",\n  ");
+    first_row = false;
+    os << (hdr_.empty() ? "[" : "{");
+    for (std::size_t p = 0; p < row.size(); p++) {
+      if (p) os << ", ";
+      if (!hdr_.empty()) {
+        json_print_string(os, hdr_[p]);
+        os << ": ";
+      }
+      json_print_cell(os, row[p]);
+    }
+    os << (hdr_.empty() ? "]" : "}");
+  }
+  os << (first_row ? "]" : "\n]");
+}
+
 }  // namespace ubench::measure
 
 auto operator<<(std::ostream& os, const ubench::measure::table& table)
@@ -0,0 +1,200 @@
+#include "ubench/measure/sampler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "ubench/thread.h"
+
+namespace ubench::measure {
+
+sampler::sampler(std::chrono::microseconds period, std::size_t capacity,
+    std::optional<unsigned int> core)
+    : period_{period},
+      core_{core},
+      capacity_{std::max<std::size_t>(capacity, 2)} {}
+
+sampler::~sampler() { stop(); }
+
+auto sampler::add_counter(
+    std::string name, const std::atomic<std::uint64_t>& counter) -> bool {
+  if (started_) return false;
+  counters_.push_back({std::move(name), &counter});
+  return true;
+}
+
+auto sampler::start() -> bool {
+  if (started_) return false;
+  started_ = true;
+
+  // All memory is allocated here, so that the sampling thread only allocates
+  // when a CPU comes online.
+  std::vector<ubench::chrono::cpu_times> cpus{};
+  ubench::chrono::cpu_clock::now(cpus);
+  cpus_ = cpus.size();
+  readings_.resize(capacity_);
+  cpu_readings_.resize(capacity_ * cpus_);
+  counter_readings_.resize(capacity_ * counters_.size());
+
+  // The first sample is taken before returning, so that the test can start
+  // immediately after.
+  start_ = std::chrono::steady_clock::now();
+  take(std::chrono::nanoseconds{0}, cpus);
+  thread_ = std::thread([this, cpus = std::move(cpus)]() mutable {
+    std::optional<ubench::thread::pin_core> pin{};
+    if (core_) {
+      pin.emplace(*core_);
+      if (!*pin) pinned_ = false;
+    }
+    run(cpus);
+    take(std::chrono::nanoseconds{0}, cpus);
+  });
+  return true;
+}
+
+auto sampler::stop() -> void {
+  if (!thread_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+auto sampler::elapsed() const -> std::chrono::nanoseconds {
+  if (!started_) return std::chrono::nanoseconds{0};
+  return std::chrono::steady_clock::now() - start_;
+}
+
+auto sampler::run(std::vector<ubench::chrono::cpu_times>& cpus) -> void {
+  auto next = start_ + period_;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_until(lock, next, [this]() { return stop_; })) {
+    auto now = std::chrono::steady_clock::now();
+    take(now - next, cpus);
+
+    // If the thread woke more than a period late, the samples missed are
+    // skipped, instead of sampling quickly to catch up.
+    next += period_;
+    if (next <= now) {
+      next = now + period_;
+    }
+  }
+}
+
+auto sampler::take(std::chrono::nanoseconds late,
+    std::vector<ubench::chrono::cpu_times>& cpus) -> void {
+  std::size_t slot = count_ % capacity_;
+  reading& r = readings_[slot];
+  r.time = std::chrono::steady_clock::now();
+  r.late = late;
+  r.idle = ubench::chrono::idle_clock::now();
+  r.process = ubench::chrono::process_clock::now();
+
+  // A CPU that comes online or goes offline while sampling is ignored.
+  ubench::chrono::cpu_clock::now(cpus);
+  for (std::size_t cpu = 0; cpu < cpus_; cpu++) {
+    cpu_readings_[slot * cpus_ + cpu] =
+        cpu < cpus.size() ? cpus[cpu] : ubench::chrono::cpu_times{};
+  }
+
+  for (std::size_t c = 0; c < counters_.size(); c++) {
+    counter_readings_[slot * counters_.size() + c] =
+        counters_[c].value->load(std::memory_order_relaxed);
+  }
+  count_++;
+}
+
+auto sampler::overwritten() const -> std::size_t {
+  return count_ > capacity_ ? count_ - capacity_ : 0;
+}
+
+auto sampler::series() const -> std::vector<sample_interval> {
+  std::vector<sample_interval> result{};
+  std::size_t n = std::min(count_, capacity_);
+  if (n < 2) return result;
+  result.reserve(n - 1);
+
+  auto cores = ubench::thread::thread_count();
+  std::size_t first = count_ - n;
+  for (std::size_t i = first + 1; i < count_; i++) {
+    std::size_t ps = (i - 1) % capacity_;
+    std::size_t s = i % capacity_;
+    const reading& prev = readings_[ps];
+    const reading& cur = readings_[s];
+
+    sample_interval interval{};
+    interval.time = cur.time - start_;
+    interval.length = cur.time - prev.time;
+    interval.late = cur.late;
+    interval.idle = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        cur.idle - prev.idle);
+    interval.process = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        cur.process - prev.process);
+
+    // As for the busy_stop_watch, the busy time is what isn't idle.
+    if (interval.length * cores > interval.idle) {
+      interval.busy = interval.length * cores - interval.idle;
+    }
+
+    interval.cpu_busy.reserve(cpus_);
+    for (std::size_t cpu = 0; cpu < cpus_; cpu++) {
+      const auto& pc = cpu_readings_[ps * cpus_ + cpu];
+      const auto& cc = cpu_readings_[s * cpus_ + cpu];
+      auto not_busy = (cc.idle - pc.idle) + (cc.iowait - pc.iowait) +
+                      (cc.steal - pc.steal);
+      interval.cpu_busy.push_back(interval.length > not_busy
+                                      ? interval.length - not_busy
+                                      : std::chrono::nanoseconds{0});
+    }
+
+    interval.counters.reserve(counters_.size());
+    for (std::size_t c = 0; c < counters_.size(); c++) {
+      interval.counters.push_back(
+          counter_readings_[s * counters_.size() + c] -
+          counter_readings_[ps * counters_.size() + c]);
+    }
+    result.push_back(std::move(interval));
+  }
+  return result;
+}
+
+auto sampler::make_table() const -> table {
+  table result{};
+  result.add_column("Time ms", alignment::right);
+  result.add_column("Late us", alignment::right);
+  result.add_column("Busy %", alignment::right);
+  result.add_column("Process %", alignment::right);
+  for (std::size_t cpu = 0; cpu < cpus_; cpu++) {
+    result.add_column("CPU" + std::to_string(cpu) + " %", alignment::right);
+  }
+  for (const auto& c : counters_) {
+    result.add_column(c.name + "/sec", alignment::right);
+  }
+
+  for (const auto& interval : series()) {
+    std::vector<std::string> line{};
+    line.reserve(4 + cpus_ + counters_.size());
+    line.push_back(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(interval.time)
+            .count()));
+    line.push_back(std::to_string(
+        std::chrono::duration_cast<std::chrono::microseconds>(interval.late)
+            .count()));
+    line.push_back(percent(interval.busy, interval.length));
+    line.push_back(percent(interval.process, interval.length));
+    for (auto busy : interval.cpu_busy) {
+      line.push_back(percent(busy, interval.length));
+    }
+    for (auto value : interval.counters) {
+      line.push_back(interval.length.count() > 0
+                         ? std::to_string(value * 1000000000 /
+                                          interval.length.count())
+                         : "-");
+    }
+    result.add_line(std::move(line));
+  }
+  return result;
+}
+
+}  // namespace ubench::measure
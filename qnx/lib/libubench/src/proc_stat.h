@@ -0,0 +1,66 @@
+#ifndef UBENCH_CHRONO_PROC_STAT_H
+#define UBENCH_CHRONO_PROC_STAT_H
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "ubench/file.h"
+
+namespace ubench::chrono {
+
+/// @brief Open /proc/stat, to be read from the start on each sample.
+///
+/// The file is kept open, so that reading the clock is a single system call.
+///
+/// @param ticks_per_sec [out] the jiffies per second, or 0 if the file can't
+/// be used.
+///
+/// @return the file, which isn't opened if the jiffies per second or the file
+/// aren't available.
+inline auto open_proc_stat(long& ticks_per_sec) noexcept
+    -> ubench::file::fdesc {
+  ticks_per_sec = sysconf(_SC_CLK_TCK);
+  if (ticks_per_sec <= 0) {
+    ticks_per_sec = 0;
+    return {};
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+  ubench::file::fdesc fd = ::open("/proc/stat", O_RDONLY | O_CLOEXEC);
+  if (!fd) ticks_per_sec = 0;
+  return fd;
+}
+
+/// @brief Read a decimal number from /proc/stat, after any spaces, and move
+/// past it.
+///
+/// This is called while sampling the clocks, so it doesn't allocate or
+/// depend on the locale.
+///
+/// @param p the position to read from, moved to the end of the number.
+///
+/// @param end the end of the buffer.
+///
+/// @param value the number read.
+///
+/// @return false if there is no number.
+inline auto parse_uint(const char*& p, const char* end, std::uint64_t& value)
+    -> bool {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  while (p != end && *p == ' ') p++;
+  if (p == end || *p < '0' || *p > '9') return false;
+
+  value = 0;
+  while (p != end && *p >= '0' && *p <= '9') {
+    value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+    p++;
+  }
+  return true;
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+}  // namespace ubench::chrono
+
+#endif
@@ -0,0 +1,59 @@
+#include "ubench/str_hash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "str_hash_common.h"
+
+namespace ubench::string {
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+auto hash64(std::string_view str, std::uint64_t seed) noexcept
+    -> std::uint64_t {
+  using details::HASH_P0;
+  using details::HASH_P1;
+  using details::HASH_P2;
+  using details::mix;
+  using details::read8;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* p = reinterpret_cast<const unsigned char*>(str.data());
+  std::size_t len = str.size();
+  seed ^= mix(seed ^ HASH_P0, HASH_P1);
+
+  std::uint64_t a{};
+  std::uint64_t b{};
+  if (len <= 16) {
+    details::read_short(p, len, a, b);
+  } else {
+    std::size_t i = len;
+    if (i > 32) {
+      // Two lanes are independent, so that their multiplies overlap.
+      std::uint64_t s1 = seed;
+      do {
+        seed = mix(read8(p) ^ HASH_P1, read8(p + 8) ^ seed);
+        s1 = mix(read8(p + 16) ^ HASH_P2, read8(p + 24) ^ s1);
+        p += 32;
+        i -= 32;
+      } while (i > 32);
+      seed ^= s1;
+    }
+    while (i > 16) {
+      seed = mix(read8(p) ^ HASH_P1, read8(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    // The last 16 bytes, which may overlap bytes already read.
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+
+  a ^= HASH_P1;
+  b ^= seed;
+  details::mul128(a, b);
+  return mix(a ^ HASH_P0 ^ len, b ^ HASH_P1);
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace ubench::string
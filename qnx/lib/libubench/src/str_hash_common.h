@@ -0,0 +1,99 @@
+#ifndef UBENCH_STRING_STR_HASH_COMMON_H
+#define UBENCH_STRING_STR_HASH_COMMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ubench::string::details {
+
+// The constants of wyhash, which are odd, with half of the bits set in every
+// byte.
+constexpr std::uint64_t HASH_P0 = 0xa0761d6478bd642fULL;
+constexpr std::uint64_t HASH_P1 = 0xe7037ed1a0b428dbULL;
+constexpr std::uint64_t HASH_P2 = 0x8ebc6af09c88c6e3ULL;
+constexpr std::uint64_t HASH_P3 = 0x589965cc75374cc3ULL;
+
+/// @brief Multiply two 64-bit values to 128-bits.
+///
+/// @param a [in, out] the first value, replaced with the low 64 bits.
+///
+/// @param b [in, out] the second value, replaced with the high 64 bits.
+inline auto mul128(std::uint64_t& a, std::uint64_t& b) noexcept -> void {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  a = static_cast<std::uint64_t>(r);
+  b = static_cast<std::uint64_t>(r >> 64);
+#else
+  // 32-bit targets don't have a 128-bit type.
+  std::uint64_t ha = a >> 32;
+  std::uint64_t hb = b >> 32;
+  std::uint64_t la = a & 0xffffffffULL;
+  std::uint64_t lb = b & 0xffffffffULL;
+  std::uint64_t rh = ha * hb;
+  std::uint64_t rm0 = ha * lb;
+  std::uint64_t rm1 = hb * la;
+  std::uint64_t rl = la * lb;
+  std::uint64_t t = rl + (rm0 << 32);
+  std::uint64_t c = t < rl;
+  std::uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  a = lo;
+  b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/// @brief Multiply two 64-bit values, and fold the 128-bit result to 64 bits.
+inline auto mix(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t {
+  mul128(a, b);
+  return a ^ b;
+}
+
+/// @brief Read 8 bytes in host byte order.
+inline auto read8(const unsigned char* p) noexcept -> std::uint64_t {
+  std::uint64_t v{};
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/// @brief Read 4 bytes in host byte order.
+inline auto read4(const unsigned char* p) noexcept -> std::uint64_t {
+  std::uint32_t v{};
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/// @brief Read a string of up to 16 bytes into two values.
+///
+/// Strings of 4 bytes or more are read with two pairs of overlapping loads, and
+/// shorter strings by single bytes. Only the bytes of the string are read, and
+/// there are no loops.
+///
+/// @param p the string.
+///
+/// @param len the length of the string, which is 16 or less.
+///
+/// @param a [out] the first value.
+///
+/// @param b [out] the second value.
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+inline auto read_short(const unsigned char* p, std::size_t len,
+    std::uint64_t& a, std::uint64_t& b) noexcept -> void {
+  if (len >= 4) {
+    std::size_t o = (len >> 3) << 2;
+    a = (read4(p) << 32) | read4(p + o);
+    b = (read4(p + len - 4) << 32) | read4(p + len - 4 - o);
+  } else if (len > 0) {
+    a = (static_cast<std::uint64_t>(p[0]) << 16) |
+        (static_cast<std::uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+    b = 0;
+  } else {
+    a = 0;
+    b = 0;
+  }
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}  // namespace ubench::string::details
+
+#endif
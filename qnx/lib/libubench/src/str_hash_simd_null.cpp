@@ -0,0 +1,15 @@
+#include <cstdint>
+#include <string_view>
+
+#include "ubench/str_hash.h"
+
+namespace ubench::string {
+
+auto hash64_simd(std::string_view str, std::uint64_t seed) noexcept
+    -> std::uint64_t {
+  return hash64(str, seed);
+}
+
+auto hash64_simd_enabled() noexcept -> bool { return false; }
+
+}  // namespace ubench::string
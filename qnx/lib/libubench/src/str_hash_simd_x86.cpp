@@ -0,0 +1,122 @@
+#include <immintrin.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "str_hash_common.h"
+#include "ubench/str_hash.h"
+
+namespace ubench::string {
+
+namespace {
+
+using hash_fn = std::uint64_t (*)(std::string_view, std::uint64_t) noexcept;
+
+/// @brief The hash using AES-NI.
+///
+/// Every 16 bytes are xored into a lane, which is then encrypted with one AES
+/// round, which mixes every bit of the lane. Long strings use two lanes, so
+/// that the latency of the rounds overlaps.
+__attribute__((target("aes,sse4.1"))) auto hash64_aes(
+    std::string_view str, std::uint64_t seed) noexcept -> std::uint64_t {
+  using details::HASH_P0;
+  using details::HASH_P1;
+  using details::HASH_P2;
+  using details::HASH_P3;
+
+  const char* p = str.data();
+  std::size_t len = str.size();
+  const __m128i k0 = _mm_set_epi64x(static_cast<long long>(HASH_P1),
+      static_cast<long long>(HASH_P0));
+  const __m128i k1 = _mm_set_epi64x(static_cast<long long>(HASH_P3),
+      static_cast<long long>(HASH_P2));
+  // The length is encrypted first, so that a difference in the length can't be
+  // cancelled by the same difference in the first bytes.
+  __m128i h = _mm_aesenc_si128(
+      _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(seed),
+                        static_cast<long long>(len)),
+          k0),
+      k1);
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (len <= 16) {
+    // Reading 16 bytes could cross into an unmapped page, so short strings are
+    // read the same as hash64().
+    std::uint64_t a{};
+    std::uint64_t b{};
+    details::read_short(
+        reinterpret_cast<const unsigned char*>(p), len, a, b);
+    __m128i v = _mm_set_epi64x(
+        static_cast<long long>(b), static_cast<long long>(a));
+    h = _mm_aesenc_si128(_mm_xor_si128(h, v), k1);
+  } else if (len <= 32) {
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i v1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + len - 16));
+    h = _mm_aesenc_si128(_mm_xor_si128(h, v0), k1);
+    h = _mm_aesenc_si128(_mm_xor_si128(h, v1), k0);
+  } else {
+    __m128i h1 = _mm_xor_si128(h, k1);
+    const char* end = p + len;
+    while (end - p > 32) {
+      __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+      h = _mm_aesenc_si128(_mm_xor_si128(h, v0), k1);
+      h1 = _mm_aesenc_si128(_mm_xor_si128(h1, v1), k0);
+      p += 32;
+    }
+    // The last 32 bytes, which may overlap bytes already read.
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(end - 32));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(end - 16));
+    h = _mm_aesenc_si128(_mm_xor_si128(h, v0), k1);
+    h1 = _mm_aesenc_si128(_mm_xor_si128(h1, v1), k0);
+    h = _mm_aesenc_si128(h, h1);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+  // Two more rounds, so that every input bit affects every output bit.
+  h = _mm_aesenc_si128(h, k0);
+  h = _mm_aesenc_si128(h, k1);
+  h = _mm_aesenclast_si128(h, k0);
+  return static_cast<std::uint64_t>(_mm_cvtsi128_si64(h)) ^
+         static_cast<std::uint64_t>(_mm_extract_epi64(h, 1));
+}
+
+auto select_hash() noexcept -> hash_fn {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("aes") && __builtin_cpu_supports("sse4.1")) {
+    return &hash64_aes;
+  }
+  return &hash64;
+}
+
+auto hash64_resolve(std::string_view str, std::uint64_t seed) noexcept
+    -> std::uint64_t;
+
+// Starts with the function that selects the implementation on the first call,
+// so that it is valid before static initialisation.
+std::atomic<hash_fn> hash64_impl{&hash64_resolve};
+
+auto hash64_resolve(std::string_view str, std::uint64_t seed) noexcept
+    -> std::uint64_t {
+  hash_fn fn = select_hash();
+  hash64_impl.store(fn, std::memory_order_relaxed);
+  return fn(str, seed);
+}
+
+}  // namespace
+
+auto hash64_simd(std::string_view str, std::uint64_t seed) noexcept
+    -> std::uint64_t {
+  return hash64_impl.load(std::memory_order_relaxed)(str, seed);
+}
+
+auto hash64_simd_enabled() noexcept -> bool {
+  return select_hash() != &hash64;
+}
+
+}  // namespace ubench::string
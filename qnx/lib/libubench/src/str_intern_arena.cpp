@@ -0,0 +1,205 @@
+#include "config.h"
+
+#include "ubench/str_intern_arena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "str_intern_common.h"
+#include "str_intern_snapshot.h"
+#include "str_intern_table.h"
+
+namespace ubench::string {
+
+using details::ext_monotonic_resource;
+
+namespace {
+
+/// @brief The header of an interned string in the arena.
+///
+/// The bytes of the string and a nul-terminator immediately follow the
+/// header.
+struct arena_entry {
+  std::uint32_t length;  //< The length of the string, without the nul.
+  std::uint32_t id;      //< The identifier, which is the order it was added.
+
+  [[nodiscard]] auto data() const -> const char* {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<const char*>(this + 1);
+  }
+
+  [[nodiscard]] auto view() const -> std::string_view {
+    return {data(), length};
+  }
+};
+
+/// @brief Stores the interned strings back to back in a memory arena.
+class arena_storage {
+ private:
+  using alloc_s_t = ext_monotonic_resource<131072>;
+
+ public:
+  using entry_type = arena_entry;
+
+  auto add(std::string_view str, std::uint32_t id) -> arena_entry& {
+    if (str.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("string is too long to intern");
+    }
+
+    // Entries are aligned to the header, so that they're packed with at most
+    // three bytes between them.
+    void* p = alloc_s_->allocate(
+        sizeof(arena_entry) + str.size() + 1, alignof(arena_entry));
+    auto* entry =
+        new (p) arena_entry{static_cast<std::uint32_t>(str.size()), id};
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto* data = reinterpret_cast<char*>(entry + 1);
+    str.copy(data, str.size());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    data[str.size()] = '\0';
+    return *entry;
+  }
+
+  [[nodiscard]] auto bytes() const -> std::size_t {
+    return alloc_s_->reserved();
+  }
+
+ private:
+  std::unique_ptr<alloc_s_t> alloc_s_ = std::make_unique<alloc_s_t>();
+};
+
+}  // namespace
+
+/// @brief implementation of str_intern_arena using the pimpl pattern.
+class str_intern_arena::interned
+    : public details::basic_interned<arena_storage> {
+ public:
+  using basic_interned::basic_interned;
+
+  /// @brief The snapshot that was mapped, or nullptr.
+  [[nodiscard]] auto snapshot() const -> const details::str_intern_snapshot* {
+    return snapshot_.get();
+  }
+
+  auto snapshot(std::unique_ptr<details::str_intern_snapshot> snapshot)
+      -> void {
+    snapshot_ = std::move(snapshot);
+  }
+
+  /// @brief The identifier of the first string not in the snapshot.
+  [[nodiscard]] auto first_id() const -> std::uint32_t {
+    return snapshot_ ? snapshot_->size() : 0;
+  }
+
+ private:
+  std::unique_ptr<details::str_intern_snapshot> snapshot_{};
+};
+
+// For the "pimpl" pattern (using a unique_ptr on a forward declarated class),
+// need to ensure that there is no definition (inline) of the constructor in the
+// header file.
+str_intern_arena::str_intern_arena(str_intern_arena&&) noexcept = default;
+auto str_intern_arena::operator=(str_intern_arena&&) noexcept
+    -> str_intern_arena& = default;
+str_intern_arena::~str_intern_arena() = default;
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+str_intern_arena::str_intern_arena(std::size_t buckets,
+    std::size_t max_buckets, str_intern_backend backend,
+    str_intern_rehash rehash, str_intern_hash hash) {
+  details::check_buckets(buckets, max_buckets);
+  interned_ = std::make_unique<interned>(
+      buckets, max_buckets, backend, rehash, hash);
+}
+
+auto str_intern_arena::map(const std::filesystem::path& path)
+    -> str_intern_arena {
+  str_intern_arena arena{};
+  arena.interned_->snapshot(details::str_intern_snapshot::map(path));
+  return arena;
+}
+
+auto str_intern_arena::intern(std::string_view str) -> std::string_view {
+  if (const auto* snapshot = interned_->snapshot()) {
+    if (auto id = snapshot->find(str)) return snapshot->view(*id);
+  }
+  return interned_->intern(str).view();
+}
+
+auto str_intern_arena::intern_batch(const std::string_view* strs,
+    std::size_t count, std::string_view* out) -> void {
+  if (interned_->snapshot()) {
+    // The snapshot is searched first, and is not prefetched.
+    for (std::size_t i = 0; i < count; i++) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      out[i] = intern(strs[i]);
+    }
+    return;
+  }
+
+  interned_->intern_batch(strs, count,
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      [out](std::size_t i, const arena_entry& e) { out[i] = e.view(); });
+}
+
+auto str_intern_arena::intern_id(std::string_view str) -> std::uint32_t {
+  if (const auto* snapshot = interned_->snapshot()) {
+    if (auto id = snapshot->find(str)) return *id;
+  }
+  return interned_->first_id() + interned_->intern(str).id;
+}
+
+auto str_intern_arena::lookup(std::uint32_t id) const -> std::string_view {
+  std::uint32_t first_id = interned_->first_id();
+  if (id < first_id) return interned_->snapshot()->view(id);
+  return interned_->lookup(id - first_id).view();
+}
+
+auto str_intern_arena::save(const std::filesystem::path& path) const -> void {
+  details::save_snapshot(path, size(),
+      [this](std::uint32_t id) { return lookup(id); });
+}
+
+auto str_intern_arena::size() const -> unsigned int {
+  return interned_->first_id() + interned_->size();
+}
+
+[[nodiscard]] auto str_intern_arena::max_load_factor() const -> float {
+  return interned_->max_load_factor();
+}
+
+auto str_intern_arena::max_load_factor(float ml) -> void {
+  if (ml <= 0.01) {
+    throw std::invalid_argument("max_load_factor is too small");
+  }
+  interned_->max_load_factor(ml);
+}
+
+[[nodiscard]] auto str_intern_arena::bucket_count() const -> std::size_t {
+  return interned_->bucket_count();
+}
+
+[[nodiscard]] auto str_intern_arena::backend() const -> str_intern_backend {
+  return interned_->backend();
+}
+
+[[nodiscard]] auto str_intern_arena::rehash_mode() const -> str_intern_rehash {
+  return interned_->rehash_mode();
+}
+
+[[nodiscard]] auto str_intern_arena::hash_function() const -> str_intern_hash {
+  return interned_->hash_function();
+}
+
+[[nodiscard]] auto str_intern_arena::stats() const -> str_intern_stats {
+  return interned_->stats();
+}
+
+}  // namespace ubench::string
@@ -0,0 +1,168 @@
+#ifndef UBENCH_STRING_STR_INTERN_COMMON_H
+#define UBENCH_STRING_STR_INTERN_COMMON_H
+
+#include "config.h"
+
+#include <array>
+#include <cstddef>
+#include <forward_list>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#if HAVE_CXX_EXPERIMENTAL_MEMORY_RESOURCE
+// Under QNX 7.1 (GCC 8.3.0), the functionality is only experimental. We map the
+// experimental namespace to the std namespace to be compatible with later
+// compiler collections.
+#include <experimental/forward_list>
+#include <experimental/memory_resource>
+#include <experimental/vector>
+
+namespace std::pmr {
+using memory_resource = std::experimental::pmr::memory_resource;
+template <class T>
+using forward_list = std::experimental::pmr::forward_list<T>;
+template <class T>
+using vector = std::experimental::pmr::vector<T>;
+}  // namespace std::pmr
+#else
+#include <memory_resource>
+#include <vector>
+#endif
+
+namespace ubench::string::details {
+
+/// @brief Calculate the next value of power of two.
+///
+/// Calculates the next value that is a power of 2. If the value is too large,
+/// then zero is returned.
+///
+/// @tparam T the unsigned type to calculate the bit ceiling for.
+///
+/// @param v the value to calculate the bit ceiling for.
+///
+/// @return the next power of 2, or zero if none.
+template <typename T,
+    std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>, bool> =
+        true>
+auto bit_ceil(T v) -> T {
+  v--;
+  v |= v >> 1;
+  v |= v >> 2;
+  v |= v >> 4;
+  if (sizeof(T) > 1) {
+    v |= v >> 8;
+  }
+  if (sizeof(T) > 2) {
+    v |= v >> 16;
+  }
+  if (sizeof(T) > 4) {
+    v |= v >> 32;
+  }
+  v++;
+  return v;
+}
+
+/// @brief Hint to the processor that memory will soon be read.
+///
+/// This doesn't block, and doesn't fault if the address isn't valid. Compilers
+/// without the builtin ignore the hint.
+///
+/// @param p the address that will be read.
+inline auto prefetch([[maybe_unused]] const void* p) noexcept -> void {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p);
+#endif
+}
+
+/// @brief An extending monotonic memory resource.
+///
+/// The resource is not thread-safe. Users that share it between threads must
+/// serialise all allocations.
+template <std::size_t N>
+class ext_monotonic_resource : public std::pmr::memory_resource {
+ public:
+  explicit ext_monotonic_resource() {
+    mem_.emplace_front();
+    mem_ptr_ = mem_.front().data();
+  }
+  ext_monotonic_resource(const ext_monotonic_resource&) = delete;
+  auto operator=(const ext_monotonic_resource&)
+      -> ext_monotonic_resource& = delete;
+  ext_monotonic_resource(ext_monotonic_resource&&) = delete;
+  auto operator=(ext_monotonic_resource&&) -> ext_monotonic_resource& = delete;
+  ~ext_monotonic_resource() override {
+    for (const auto p : mem_large_) {
+      // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+      delete[] static_cast<std::byte*>(p);
+    }
+  }
+
+  /// @brief The memory obtained for the blocks and the large allocations.
+  ///
+  /// @return the number of bytes, including what isn't allocated yet.
+  [[nodiscard]] auto reserved() const noexcept -> std::size_t {
+    return reserved_;
+  }
+
+ private:
+  static constexpr std::size_t BLOCK_SIZE = N;
+
+  auto get_pointer(std::size_t bytes, std::size_t alignment) -> void* {
+    void* p = std::align(alignment, bytes, mem_ptr_, avail_);
+    if (p) {
+      avail_ -= bytes;
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      mem_ptr_ = static_cast<std::byte*>(p) + bytes;
+    }
+    return p;
+  }
+
+  // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+  auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+    if (bytes > BLOCK_SIZE >> 4) {
+      // Large chunks of memory will be allocated separately.
+      void* l = (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                    ? new (std::align_val_t(alignment)) std::byte[bytes]
+                    : new std::byte[bytes];
+      mem_large_.emplace_front(l);
+      reserved_ += bytes;
+      return l;
+    }
+
+    // Ensures we don't return the same pointer twice.
+    if (bytes == 0) bytes = 1;
+
+    void* p = get_pointer(bytes, alignment);
+    if (p) return p;
+
+    avail_ = BLOCK_SIZE;
+    mem_.emplace_front();
+    mem_ptr_ = mem_.front().data();
+    reserved_ += BLOCK_SIZE;
+    p = get_pointer(bytes, alignment);
+    if (p) return p;
+
+    throw std::bad_alloc();
+  }
+
+  auto do_deallocate(void*, std::size_t, std::size_t) -> void override {
+    return;
+  }
+
+  [[nodiscard]] auto do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept -> bool override {
+    return this == &other;
+  }
+
+  std::size_t avail_{BLOCK_SIZE};
+  void* mem_ptr_{};
+  std::forward_list<std::array<std::byte, BLOCK_SIZE>> mem_{};
+  std::forward_list<void*> mem_large_{};
+  std::size_t reserved_{BLOCK_SIZE};
+};
+
+}  // namespace ubench::string::details
+
+#endif
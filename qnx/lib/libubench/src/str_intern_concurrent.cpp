@@ -0,0 +1,352 @@
+#include "config.h"
+
+#include "ubench/str_intern_concurrent.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "str_intern_common.h"
+
+namespace ubench::string {
+
+using details::bit_ceil;
+using details::ext_monotonic_resource;
+
+namespace {
+
+/// @brief An entry in a bucket chain that may be read without a lock.
+///
+/// Nodes are never modified after being published, except for the head of
+/// the bucket which points to it.
+struct chain_node {
+  chain_node(std::size_t hash, const std::string* interned, chain_node* next)
+      : hash{hash}, interned{interned}, next{next} {}
+
+  std::size_t hash;               //< The computed hash.
+  const std::string* interned;    //< Pointer to string that won't be freed.
+  std::atomic<chain_node*> next;  //< The next node in the bucket chain.
+};
+
+/// @brief The buckets of a single shard.
+struct shard_table {
+  explicit shard_table(std::size_t buckets)
+      : mask{buckets - 1},
+        heads{std::make_unique<std::atomic<chain_node*>[]>(buckets)} {}
+
+  [[nodiscard]] auto size() const -> std::size_t { return mask + 1; }
+
+  std::size_t mask;
+  std::unique_ptr<std::atomic<chain_node*>[]> heads;
+};
+
+// The alignment separates shards into their own cache lines, so that the lock
+// of one shard doesn't slow down the readers of the neighbouring shard.
+constexpr std::size_t SHARD_ALIGN = 64;
+
+/// @brief A single shard, which is a variable set of buckets.
+///
+/// Readers may call find() at any time. All other methods must be called with
+/// the mutex held.
+class alignas(SHARD_ALIGN) shard {
+ private:
+  // Smaller blocks than str_intern, as there is one allocator per shard.
+  using alloc_s_t = ext_monotonic_resource<32768>;
+  using alloc_n_t = ext_monotonic_resource<32768>;
+  using string_block_t = std::pmr::forward_list<std::string>;
+
+ public:
+  shard(const shard&) = delete;
+  auto operator=(const shard&) -> shard& = delete;
+  shard(shard&&) = delete;
+  auto operator=(shard&&) -> shard& = delete;
+  ~shard() = default;
+
+  // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+  shard(std::size_t buckets, std::size_t max_buckets)
+      : max_buckets_{max_buckets},
+        rehash_count_{buckets}  // Assumes a max_load_factor = 1.0
+  {
+    tables_.push_back(std::make_unique<shard_table>(buckets));
+    table_.store(tables_.back().get(), std::memory_order_release);
+    if (buckets == max_buckets) rehash_count_ = 0;
+  }
+
+  /// @brief Look for an existing string without taking the lock.
+  [[nodiscard]] auto find(std::size_t h, std::string_view str) const
+      -> const std::string* {
+    const shard_table* table = table_.load(std::memory_order_acquire);
+    const chain_node* node =
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        table->heads[h & table->mask].load(std::memory_order_acquire);
+    while (node) {
+      if (node->hash == h && str == *node->interned) return node->interned;
+      node = node->next.load(std::memory_order_acquire);
+    }
+    return nullptr;
+  }
+
+  auto insert(std::size_t h, std::string_view str) -> const std::string& {
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    // Another thread may have added the same string while we were waiting for
+    // the lock.
+    const std::string* found = find(h, str);
+    if (found) return *found;
+
+    std::size_t interned = interned_.load(std::memory_order_relaxed);
+    if (rehash_count_ != 0 && interned >= rehash_count_) {
+      rehash(next_size(interned));
+    }
+
+    auto& s = strings_.emplace_front(str);
+    shard_table* table = table_.load(std::memory_order_relaxed);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto& head = table->heads[h & table->mask];
+    chain_node* node = make_node(h, &s, head.load(std::memory_order_relaxed));
+
+    // Publishing the node makes it visible to the readers, so it must be fully
+    // constructed before.
+    head.store(node, std::memory_order_release);
+    interned_.store(interned + 1, std::memory_order_relaxed);
+    return s;
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return interned_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto bucket_count() const -> std::size_t {
+    return table_.load(std::memory_order_acquire)->size();
+  }
+
+  auto lock() -> std::unique_lock<std::mutex> {
+    return std::unique_lock<std::mutex>{mutex_};
+  }
+
+  /// @brief Update the max_load_factor. The lock must be held.
+  ///
+  /// See str_intern::interned::max_load_factor() for the calculation.
+  auto max_load_factor(float ml) -> void {
+    max_load_factor_ = ml;
+
+    std::size_t buckets = table_.load(std::memory_order_relaxed)->size();
+    if (max_buckets_ == buckets) {
+      rehash_count_ = 0;
+    } else {
+      float f = static_cast<float>(buckets) * max_load_factor_;
+      if (f >= static_cast<float>(std::numeric_limits<std::size_t>::max())) {
+        rehash_count_ = 0;
+      } else {
+        rehash_count_ =
+            std::max(static_cast<std::size_t>(std::ceil(f)), buckets);
+      }
+    }
+  }
+
+ private:
+  std::mutex mutex_{};
+  std::atomic<shard_table*> table_{};
+  std::atomic<std::size_t> interned_{};
+
+  std::unique_ptr<alloc_s_t> alloc_s_ = std::make_unique<alloc_s_t>();
+  string_block_t strings_{alloc_s_.get()};
+  std::unique_ptr<alloc_n_t> alloc_n_ = std::make_unique<alloc_n_t>();
+
+  // All tables ever used. Readers may still be in an older table, so they're
+  // only freed when the shard is destroyed.
+  std::vector<std::unique_ptr<shard_table>> tables_{};
+
+  std::size_t max_buckets_{};
+  float max_load_factor_{1.0};
+  std::size_t rehash_count_{};
+
+  auto make_node(std::size_t h, const std::string* s, chain_node* next)
+      -> chain_node* {
+    void* p = alloc_n_->allocate(sizeof(chain_node), alignof(chain_node));
+    return new (p) chain_node{h, s, next};
+  }
+
+  [[nodiscard]] auto next_size(std::size_t interned) const -> std::size_t {
+    float f = static_cast<float>(interned + 1) / max_load_factor_;
+    auto new_buckets = static_cast<std::size_t>(std::ceil(f));
+    if (new_buckets >= max_buckets_) {
+      return max_buckets_;
+    }
+    return bit_ceil(new_buckets);
+  }
+
+  auto rehash(std::size_t new_buckets) -> void {
+    const shard_table* old_table = table_.load(std::memory_order_relaxed);
+    auto new_table = std::make_unique<shard_table>(new_buckets);
+
+    // Readers may be walking the chains of the old table, so the nodes are
+    // copied instead of being moved into the new table.
+    for (std::size_t b = 0; b < old_table->size(); b++) {
+      const chain_node* node =
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          old_table->heads[b].load(std::memory_order_relaxed);
+      while (node) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto& head = new_table->heads[node->hash & new_table->mask];
+        head.store(make_node(node->hash, node->interned,
+                       head.load(std::memory_order_relaxed)),
+            std::memory_order_relaxed);
+        node = node->next.load(std::memory_order_relaxed);
+      }
+    }
+
+    tables_.push_back(std::move(new_table));
+    table_.store(tables_.back().get(), std::memory_order_release);
+
+    if (new_buckets == max_buckets_) {
+      rehash_count_ = 0;
+    } else {
+      rehash_count_ = static_cast<std::size_t>(
+          static_cast<float>(new_buckets) * max_load_factor_);
+    }
+  }
+};
+
+}  // namespace
+
+/// @brief implementation of str_intern_concurrent using the pimpl pattern.
+class str_intern_concurrent::interned {
+ public:
+  interned(const interned&) = delete;
+  auto operator=(const interned&) -> interned& = delete;
+  interned(interned&&) = delete;
+  auto operator=(interned&&) -> interned& = delete;
+  ~interned() = default;
+
+  // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+  interned(std::size_t shards, std::size_t buckets, std::size_t max_buckets)
+      : shard_mask_{shards - 1} {
+    // The shard is selected with the upper bits of the hash, the bucket within
+    // the shard with the lower bits, so that they're independent of each
+    // other.
+    unsigned int bits = 0;
+    while ((static_cast<std::size_t>(1) << bits) < shards) bits++;
+    if (bits != 0) {
+      shard_shift_ = std::numeric_limits<std::size_t>::digits - bits;
+    }
+
+    shards_.reserve(shards);
+    for (std::size_t s = 0; s < shards; s++) {
+      shards_.push_back(
+          std::make_unique<shard>(buckets / shards, max_buckets / shards));
+    }
+  }
+
+  auto intern(std::string_view str) -> const std::string& {
+    std::size_t h = svh_(str);
+    shard& s = *shards_[(h >> shard_shift_) & shard_mask_];
+    const std::string* found = s.find(h, str);
+    if (found) return *found;
+    return s.insert(h, str);
+  }
+
+  [[nodiscard]] auto size() const -> unsigned int {
+    std::size_t count = 0;
+    for (const auto& s : shards_) {
+      count += s->size();
+    }
+    return static_cast<unsigned int>(count);
+  }
+
+  [[nodiscard]] auto max_load_factor() const -> float {
+    return max_load_factor_.load(std::memory_order_relaxed);
+  }
+
+  auto max_load_factor(float ml) -> void {
+    max_load_factor_.store(ml, std::memory_order_relaxed);
+    for (const auto& s : shards_) {
+      auto lock = s->lock();
+      s->max_load_factor(ml);
+    }
+  }
+
+  [[nodiscard]] auto bucket_count() const -> std::size_t {
+    std::size_t count = 0;
+    for (const auto& s : shards_) {
+      count += s->bucket_count();
+    }
+    return count;
+  }
+
+  [[nodiscard]] auto shard_count() const -> std::size_t {
+    return shards_.size();
+  }
+
+ private:
+  std::vector<std::unique_ptr<shard>> shards_{};
+  std::size_t shard_mask_{};
+  unsigned int shard_shift_{};
+  std::atomic<float> max_load_factor_{1.0};
+  std::hash<std::string_view> svh_{};
+};
+
+// For the "pimpl" pattern (using a unique_ptr on a forward declarated class),
+// need to ensure that there is no definition (inline) of the constructor in the
+// header file.
+str_intern_concurrent::str_intern_concurrent(
+    str_intern_concurrent&&) noexcept = default;
+auto str_intern_concurrent::operator=(str_intern_concurrent&&) noexcept
+    -> str_intern_concurrent& = default;
+str_intern_concurrent::~str_intern_concurrent() = default;
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+str_intern_concurrent::str_intern_concurrent(
+    std::size_t shards, std::size_t buckets, std::size_t max_buckets) {
+  if (shards == 0 || shards & (shards - 1)) {
+    throw std::invalid_argument("shards is not a power of 2");
+  }
+  if (buckets == 0 || buckets & (buckets - 1)) {
+    throw std::invalid_argument("buckets is not a power of 2");
+  }
+  if (buckets < shards) {
+    throw std::invalid_argument("buckets must be greater/equal to shards");
+  }
+  if (max_buckets < buckets) {
+    throw std::invalid_argument("max_buckets must be greater/equal to buckets");
+  }
+  if (max_buckets & (max_buckets - 1)) {
+    throw std::invalid_argument("max_buckets is not a power of 2");
+  }
+  interned_ = std::make_unique<interned>(shards, buckets, max_buckets);
+}
+
+auto str_intern_concurrent::intern(std::string_view str) -> const std::string& {
+  return interned_->intern(str);
+}
+
+auto str_intern_concurrent::size() const -> unsigned int {
+  return interned_->size();
+}
+
+[[nodiscard]] auto str_intern_concurrent::max_load_factor() const -> float {
+  return interned_->max_load_factor();
+}
+
+auto str_intern_concurrent::max_load_factor(float ml) -> void {
+  if (ml <= 0.01) {
+    throw std::invalid_argument("max_load_factor is too small");
+  }
+  interned_->max_load_factor(ml);
+}
+
+[[nodiscard]] auto str_intern_concurrent::bucket_count() const -> std::size_t {
+  return interned_->bucket_count();
+}
+
+[[nodiscard]] auto str_intern_concurrent::shard_count() const -> std::size_t {
+  return interned_->shard_count();
+}
+
+}  // namespace ubench::string
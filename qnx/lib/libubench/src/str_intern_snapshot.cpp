@@ -0,0 +1,272 @@
+#include "str_intern_snapshot.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "str_intern_common.h"
+#include "ubench/file.h"
+
+namespace ubench::string::details {
+
+namespace {
+
+constexpr std::array<char, 8> SNAPSHOT_MAGIC = {
+    'U', 'B', 'S', 'T', 'R', 'I', 'N', 'T'};
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+constexpr std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct snapshot_header {
+  std::array<char, 8> magic;    //< Identifies the file as a snapshot.
+  std::uint32_t version;        //< The version of the layout.
+  std::uint32_t byte_order;     //< Detects a file from a different host.
+  std::uint64_t count;          //< The number of strings.
+  std::uint64_t buckets;        //< The number of slots in the index.
+  std::uint64_t index_offset;   //< File offset of the index.
+  std::uint64_t ids_offset;     //< File offset of the identifier table.
+  std::uint64_t file_size;      //< The size of the complete file.
+};
+
+struct snapshot_slot {
+  std::uint32_t hash;  //< The upper 32 bits of the hash.
+  std::uint32_t id;    //< The identifier plus one, or zero if empty.
+};
+
+static_assert(sizeof(snapshot_header) % 8 == 0);
+static_assert(sizeof(snapshot_slot) == 8);
+
+/// @brief The FNV-1a 64-bit hash of a string.
+auto fnv1a(std::string_view str) noexcept -> std::uint64_t {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (char c : str) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/// @brief Read a value from the mapped file.
+template <typename T>
+auto load(const std::byte* p) noexcept -> T {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+/// @brief The size of a string in the file, including the length and the nul.
+auto entry_size(std::size_t length) noexcept -> std::uint64_t {
+  std::uint64_t size = sizeof(std::uint32_t) + length + 1;
+  return (size + 3) & ~static_cast<std::uint64_t>(3);
+}
+
+auto write_all(int fd, const void* buf, std::size_t len) -> void {
+  const auto* p = static_cast<const char*>(buf);
+  while (len > 0) {
+    ssize_t w = ::write(fd, p, len);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      throw std::system_error(
+          errno, std::generic_category(), "Couldn't write snapshot");
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    p += w;
+    len -= static_cast<std::size_t>(w);
+  }
+}
+
+}  // namespace
+
+str_intern_snapshot::~str_intern_snapshot() {
+  if (addr_) munmap(addr_, length_);
+}
+
+auto str_intern_snapshot::map(const std::filesystem::path& path)
+    -> std::unique_ptr<str_intern_snapshot> {
+  ubench::file::fdesc fd{path.string()};
+  if (!fd) {
+    throw std::system_error(errno, std::generic_category(),
+        "Couldn't open snapshot " + path.string());
+  }
+
+  struct stat sb {};
+  if (fstat(fd, &sb) < 0) {
+    throw std::system_error(errno, std::generic_category(),
+        "Couldn't get size of snapshot " + path.string());
+  }
+  auto length = static_cast<std::size_t>(sb.st_size);
+  if (length < sizeof(snapshot_header)) {
+    throw std::runtime_error("File is not a snapshot " + path.string());
+  }
+
+  void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (addr == MAP_FAILED) {  // NOLINT(performance-no-int-to-ptr)
+    throw std::system_error(errno, std::generic_category(),
+        "Couldn't map snapshot " + path.string());
+  }
+
+  // From here, the destructor unmaps the file.
+  std::unique_ptr<str_intern_snapshot> snapshot{new str_intern_snapshot{}};
+  snapshot->addr_ = addr;
+  snapshot->length_ = length;
+
+  const auto* base = static_cast<const std::byte*>(addr);
+  auto header = load<snapshot_header>(base);
+  if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+      header.byte_order != SNAPSHOT_BYTE_ORDER ||
+      header.file_size != length) {
+    throw std::runtime_error("File is not a snapshot " + path.string());
+  }
+
+  // The checks are ordered so that none of the calculations can overflow.
+  if (header.count > std::numeric_limits<std::uint32_t>::max() ||
+      header.buckets == 0 || (header.buckets & (header.buckets - 1)) ||
+      header.buckets <= header.count ||
+      header.buckets > length / sizeof(snapshot_slot) ||
+      header.index_offset != sizeof(snapshot_header) ||
+      header.ids_offset !=
+          header.index_offset + header.buckets * sizeof(snapshot_slot) ||
+      header.ids_offset > length ||
+      header.count > (length - header.ids_offset) / sizeof(std::uint64_t)) {
+    throw std::runtime_error("Snapshot is corrupt " + path.string());
+  }
+
+  snapshot->count_ = static_cast<std::uint32_t>(header.count);
+  snapshot->hash_mask_ = header.buckets - 1;
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  snapshot->index_ = base + header.index_offset;
+  snapshot->ids_ = base + header.ids_offset;
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return snapshot;
+}
+
+auto str_intern_snapshot::find(std::string_view str) const
+    -> std::optional<std::uint32_t> {
+  std::uint64_t h = fnv1a(str);
+  auto hash = static_cast<std::uint32_t>(h >> 32);
+  std::uint64_t i = h & hash_mask_;
+  // A valid index always has an empty slot, but a corrupt one may not, so no
+  // more than every slot is probed.
+  for (std::uint64_t probe = 0; probe <= hash_mask_; probe++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto slot = load<snapshot_slot>(index_ + i * sizeof(snapshot_slot));
+    if (slot.id == 0 || slot.id > count_) return std::nullopt;
+    if (slot.hash == hash && view(slot.id - 1) == str) return slot.id - 1;
+    i = (i + 1) & hash_mask_;
+  }
+  return std::nullopt;
+}
+
+auto str_intern_snapshot::view(std::uint32_t id) const -> std::string_view {
+  const auto* base = static_cast<const std::byte*>(addr_);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  auto offset = load<std::uint64_t>(ids_ + id * sizeof(std::uint64_t));
+  if (offset > length_ - sizeof(std::uint32_t)) {
+    throw std::runtime_error("Snapshot is corrupt");
+  }
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  auto len = load<std::uint32_t>(base + offset);
+  if (len >= length_ - offset - sizeof(std::uint32_t)) {
+    throw std::runtime_error("Snapshot is corrupt");
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return {reinterpret_cast<const char*>(base + offset + sizeof(std::uint32_t)),
+      len};
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+auto save_snapshot(const std::filesystem::path& path, std::uint32_t count,
+    const std::function<std::string_view(std::uint32_t)>& get) -> void {
+  // The index is at most half full.
+  std::uint64_t buckets =
+      bit_ceil(std::max(static_cast<std::uint64_t>(count) * 2,
+          static_cast<std::uint64_t>(1)));
+  std::uint64_t index_offset = sizeof(snapshot_header);
+  std::uint64_t ids_offset = index_offset + buckets * sizeof(snapshot_slot);
+  std::uint64_t offset = ids_offset + count * sizeof(std::uint64_t);
+
+  std::vector<snapshot_slot> index(buckets);
+  std::vector<std::uint64_t> ids(count);
+  for (std::uint32_t id = 0; id < count; id++) {
+    std::string_view str = get(id);
+    if (str.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("string is too long to save");
+    }
+
+    std::uint64_t h = fnv1a(str);
+    std::uint64_t i = h & (buckets - 1);
+    while (index[i].id != 0) i = (i + 1) & (buckets - 1);
+    index[i] = {static_cast<std::uint32_t>(h >> 32), id + 1};
+
+    ids[id] = offset;
+    offset += entry_size(str.size());
+  }
+
+  snapshot_header header{SNAPSHOT_MAGIC, SNAPSHOT_VERSION, SNAPSHOT_BYTE_ORDER,
+      count, buckets, index_offset, ids_offset, offset};
+
+  // The snapshot is written to a temporary file that then replaces the
+  // original, so a snapshot that is currently mapped is never truncated.
+  std::filesystem::path tmp_path = path;
+  tmp_path += ".tmp";
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+  ubench::file::fdesc fd = ::open(
+      tmp_path.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (!fd) {
+    throw std::system_error(errno, std::generic_category(),
+        "Couldn't create snapshot " + tmp_path.string());
+  }
+
+  // The temporary file is removed if it can't be completed, so that a failed
+  // save leaves nothing behind.
+  try {
+    write_all(fd, &header, sizeof(header));
+    write_all(fd, index.data(), index.size() * sizeof(snapshot_slot));
+    write_all(fd, ids.data(), ids.size() * sizeof(std::uint64_t));
+
+    // The strings are written through a buffer, to reduce the number of calls.
+    // A string larger than the buffer grows it.
+    constexpr std::size_t buff_size = 65536;
+    std::vector<char> buff{};
+    buff.reserve(buff_size);
+    for (std::uint32_t id = 0; id < count; id++) {
+      std::string_view str = get(id);
+      auto len = static_cast<std::uint32_t>(str.size());
+      std::size_t pos = buff.size();
+      buff.resize(pos + entry_size(str.size()), '\0');
+      std::memcpy(&buff[pos], &len, sizeof(len));
+      std::memcpy(&buff[pos + sizeof(len)], str.data(), str.size());
+      if (buff.size() >= buff_size) {
+        write_all(fd, buff.data(), buff.size());
+        buff.clear();
+      }
+    }
+    write_all(fd, buff.data(), buff.size());
+
+    // The error from close() is checked, as a write error might only be
+    // reported then.
+    int raw_fd = fd;
+    fd.reset();
+    if (::close(raw_fd) < 0) {
+      throw std::system_error(errno, std::generic_category(),
+          "Couldn't write snapshot " + tmp_path.string());
+    }
+    std::filesystem::rename(tmp_path, path);
+  } catch (...) {
+    fd.close();
+    std::error_code ec{};
+    std::filesystem::remove(tmp_path, ec);
+    throw;
+  }
+}
+
+}  // namespace ubench::string::details
@@ -0,0 +1,97 @@
+#ifndef UBENCH_STRING_STR_INTERN_SNAPSHOT_H
+#define UBENCH_STRING_STR_INTERN_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace ubench::string::details {
+
+// The layout of a snapshot file. All values are in the byte order of the host
+// that wrote it, and all sections are aligned to 8 bytes.
+//
+//  snapshot_header
+//  snapshot_slot[buckets]          Open addressing index, linear probing.
+//  std::uint64_t[count]            File offset of each string, by identifier.
+//  strings                         std::uint32_t length, bytes and a nul,
+//                                  aligned to 4 bytes.
+//
+// The index is hashed with FNV-1a 64-bit, which doesn't depend on the standard
+// library used. The index is never more than half full, so a probe always ends
+// at an empty slot.
+
+/// @brief A read-only snapshot of interned strings, mapped into memory.
+///
+/// Strings are found and returned from the mapped file without copying.
+class str_intern_snapshot {
+ public:
+  str_intern_snapshot(const str_intern_snapshot&) = delete;
+  auto operator=(const str_intern_snapshot&) -> str_intern_snapshot& = delete;
+  str_intern_snapshot(str_intern_snapshot&&) = delete;
+  auto operator=(str_intern_snapshot&&) -> str_intern_snapshot& = delete;
+  ~str_intern_snapshot();
+
+  /// @brief Map a snapshot file into memory.
+  ///
+  /// @param path the file written by save_snapshot().
+  ///
+  /// @return the mapped snapshot.
+  ///
+  /// @exception std::system_error The file couldn't be opened or mapped.
+  ///
+  /// @exception std::runtime_error The file is not a valid snapshot.
+  static auto map(const std::filesystem::path& path)
+      -> std::unique_ptr<str_intern_snapshot>;
+
+  /// @brief Find a string in the snapshot.
+  ///
+  /// @param str the string to look for.
+  ///
+  /// @return the identifier of the string, if found.
+  [[nodiscard]] auto find(std::string_view str) const
+      -> std::optional<std::uint32_t>;
+
+  /// @brief Get the string for an identifier.
+  ///
+  /// @param id the identifier, which must be less than size().
+  ///
+  /// @return the string in the mapped file, which is nul-terminated.
+  [[nodiscard]] auto view(std::uint32_t id) const -> std::string_view;
+
+  /// @brief The number of strings in the snapshot.
+  [[nodiscard]] auto size() const -> std::uint32_t { return count_; }
+
+ private:
+  str_intern_snapshot() = default;
+
+  void* addr_{};
+  std::size_t length_{};
+  std::uint32_t count_{};
+  std::uint64_t hash_mask_{};
+  const std::byte* index_{};
+  const std::byte* ids_{};
+};
+
+/// @brief Write a snapshot of interned strings to a file.
+///
+/// @param path the file to write. An existing file is replaced, even if it is
+/// mapped.
+///
+/// @param count the number of strings.
+///
+/// @param get returns the string for each identifier from zero to count - 1.
+/// All strings must be different.
+///
+/// @exception std::system_error The file couldn't be written.
+///
+/// @exception std::length_error A string is longer than 4GB.
+auto save_snapshot(const std::filesystem::path& path, std::uint32_t count,
+    const std::function<std::string_view(std::uint32_t)>& get) -> void;
+
+}  // namespace ubench::string::details
+
+#endif
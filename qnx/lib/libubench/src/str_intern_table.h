@@ -0,0 +1,792 @@
+#ifndef UBENCH_STRING_STR_INTERN_TABLE_H
+#define UBENCH_STRING_STR_INTERN_TABLE_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "str_intern_common.h"
+#include "ubench/str_hash.h"
+#include "ubench/str_intern.h"
+
+namespace ubench::string::details {
+
+template <typename Entry>
+struct string_hash_block {
+  string_hash_block(std::size_t hash, Entry* interned)
+      : hash{hash}, interned{interned} {}
+
+  std::size_t hash;  //< The computed hash.
+  Entry* interned;   //< Pointer to string that won't be freed.
+};
+
+/// @brief The buckets of a str_intern, storing pointers to interned strings.
+///
+/// The table doesn't own the strings. It only decides where they're stored and
+/// how they're found.
+template <typename Entry>
+class intern_table {
+ public:
+  intern_table() = default;
+  intern_table(const intern_table&) = delete;
+  auto operator=(const intern_table&) -> intern_table& = delete;
+  intern_table(intern_table&&) = delete;
+  auto operator=(intern_table&&) -> intern_table& = delete;
+  virtual ~intern_table() = default;
+
+  /// @brief Find an interned string.
+  ///
+  /// @param h the hash of str.
+  ///
+  /// @param str the string to look for.
+  ///
+  /// @return the interned string, or nullptr if not found.
+  [[nodiscard]] virtual auto find(std::size_t h, std::string_view str) const
+      -> Entry* = 0;
+
+  /// @brief Add a string that is known not to be in the table.
+  ///
+  /// @param h the hash of the string.
+  ///
+  /// @param interned the string to add, which must not be freed.
+  virtual auto insert(std::size_t h, Entry* interned) -> void = 0;
+
+  /// @brief Start loading the bucket for a hash into the cache.
+  ///
+  /// @param h the hash of a string that will be searched for soon.
+  virtual auto prefetch(std::size_t h) const noexcept -> void = 0;
+
+  /// @brief Replace the buckets with a new number of buckets.
+  ///
+  /// @param buckets the new number of buckets, which is a power of 2.
+  virtual auto rehash(std::size_t buckets) -> void = 0;
+
+  /// @brief Insert the strings of some buckets into another table.
+  ///
+  /// The strings remain in this table.
+  ///
+  /// @param first the first bucket to copy.
+  ///
+  /// @param last one past the last bucket to copy.
+  ///
+  /// @param to the table to insert the strings to, which must not contain any
+  /// of them.
+  virtual auto copy_to(std::size_t first, std::size_t last,
+      intern_table& to) const -> void = 0;
+
+  /// @brief The number of buckets.
+  [[nodiscard]] virtual auto bucket_count() const -> std::size_t = 0;
+
+  /// @brief Count the strings by the length of their chain.
+  ///
+  /// See str_intern_stats::chain_lengths.
+  ///
+  /// @param lengths [out] the histogram, which is resized as needed.
+  virtual auto chain_lengths(std::vector<std::size_t>& lengths) const
+      -> void = 0;
+
+  /// @brief The memory obtained for the buckets.
+  [[nodiscard]] virtual auto bytes() const -> std::size_t = 0;
+
+  /// @brief The largest load factor this table can be used with.
+  [[nodiscard]] virtual auto max_fill() const -> float {
+    return std::numeric_limits<float>::infinity();
+  }
+};
+
+/// @brief A table using separate chaining, with a list for each bucket.
+template <typename Entry>
+class chained_table final : public intern_table<Entry> {
+ private:
+  using alloc_h_t = ext_monotonic_resource<131072>;
+  using set_t =
+      std::pmr::vector<std::pmr::forward_list<string_hash_block<Entry>>>;
+
+ public:
+  explicit chained_table(std::size_t buckets) : hash_mask_(buckets - 1) {
+    alloc_h_ = std::make_unique<alloc_h_t>();
+    set_ = std::make_unique<set_t>(alloc_h_.get());
+    set_->resize(buckets);
+  }
+
+  [[nodiscard]] auto find(std::size_t h, std::string_view str) const
+      -> Entry* override {
+    for (const auto& block : (*set_)[h & hash_mask_]) {
+      if (block.hash == h) {
+        if (str == block.interned->view()) {
+          return block.interned;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  auto insert(std::size_t h, Entry* interned) -> void override {
+    (*set_)[h & hash_mask_].emplace_front(h, interned);
+  }
+
+  auto prefetch(std::size_t h) const noexcept -> void override {
+    details::prefetch(&(*set_)[h & hash_mask_]);
+  }
+
+  auto rehash(std::size_t new_buckets) -> void override {
+    auto new_alloc = std::make_unique<alloc_h_t>();
+    auto new_set = std::make_unique<set_t>(new_alloc.get());
+
+    std::size_t hash_mask = new_buckets - 1;
+
+    new_set->resize(new_buckets);
+    for (auto& set : *set_) {
+      for (const auto& block : set) {
+        std::size_t i = block.hash & hash_mask;
+        (*new_set)[i].emplace_front(block);
+      }
+    }
+
+    hash_mask_ = hash_mask;
+
+    // Replace the set first so that the old allocator is no longer needed. Then
+    // replace the allocator.
+    //
+    // In C++17, it is undefined behaviour to assign a PMR container with
+    // another one if the memory allocators are different. Because of this, we
+    // need to give the memory allocator to the container during construction
+    // (not assignment) and swap using pointers.
+    set_ = std::move(new_set);
+    alloc_h_ = std::move(new_alloc);
+  }
+
+  // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+  auto copy_to(std::size_t first, std::size_t last,
+      intern_table<Entry>& to) const -> void override {
+    for (std::size_t b = first; b < last; b++) {
+      for (const auto& block : (*set_)[b]) {
+        to.insert(block.hash, block.interned);
+      }
+    }
+  }
+
+  [[nodiscard]] auto bucket_count() const -> std::size_t override {
+    return set_->size();
+  }
+
+  auto chain_lengths(std::vector<std::size_t>& lengths) const -> void override {
+    for (const auto& set : *set_) {
+      auto length =
+          static_cast<std::size_t>(std::distance(set.begin(), set.end()));
+      if (length >= lengths.size()) lengths.resize(length + 1);
+      lengths[length]++;
+    }
+  }
+
+  [[nodiscard]] auto bytes() const -> std::size_t override {
+    return alloc_h_->reserved();
+  }
+
+ private:
+  std::unique_ptr<alloc_h_t> alloc_h_{};
+  std::unique_ptr<set_t> set_{};
+  std::size_t hash_mask_{};
+};
+
+/// @brief A table using open addressing, with linear probing.
+///
+/// Entries are inserted using Robin Hood hashing. An entry that is further
+/// away from its preferred slot takes the place of an entry that is closer to
+/// its own, which is then moved further along. This keeps the distance of all
+/// entries small, and a lookup can stop as soon as it finds an entry that is
+/// closer to its preferred slot than the string being searched for.
+template <typename Entry>
+class flat_table final : public intern_table<Entry> {
+ private:
+  struct slot {
+    std::size_t hash;  //< The computed hash.
+    Entry* interned;   //< Pointer to string, or nullptr if empty.
+  };
+
+ public:
+  explicit flat_table(std::size_t buckets)
+      : hash_mask_(buckets - 1), slots_{std::make_unique<slot[]>(buckets)} {}
+
+  [[nodiscard]] auto find(std::size_t h, std::string_view str) const
+      -> Entry* override {
+    std::size_t i = h & hash_mask_;
+    for (std::size_t d = 0; d <= max_probe_; d++) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const slot& s = slots_[i];
+      if (!s.interned) return nullptr;
+      if (s.hash == h && str == s.interned->view()) return s.interned;
+
+      // If we were here, we would have replaced this entry when inserted.
+      if (distance(i, s.hash) < d) return nullptr;
+      i = (i + 1) & hash_mask_;
+    }
+    return nullptr;
+  }
+
+  auto insert(std::size_t h, Entry* interned) -> void override {
+    slot entry{h, interned};
+    std::size_t i = h & hash_mask_;
+    std::size_t d = 0;
+    while (true) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      slot& s = slots_[i];
+      if (!s.interned) {
+        s = entry;
+        max_probe_ = std::max(max_probe_, d);
+        return;
+      }
+
+      std::size_t sd = distance(i, s.hash);
+      if (sd < d) {
+        std::swap(s, entry);
+        max_probe_ = std::max(max_probe_, d);
+        d = sd;
+      }
+      i = (i + 1) & hash_mask_;
+      d++;
+    }
+  }
+
+  auto prefetch(std::size_t h) const noexcept -> void override {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    details::prefetch(&slots_[h & hash_mask_]);
+  }
+
+  auto rehash(std::size_t new_buckets) -> void override {
+    auto old_slots = std::move(slots_);
+    std::size_t old_buckets = hash_mask_ + 1;
+
+    slots_ = std::make_unique<slot[]>(new_buckets);
+    hash_mask_ = new_buckets - 1;
+    max_probe_ = 0;
+    for (std::size_t i = 0; i < old_buckets; i++) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const slot& s = old_slots[i];
+      if (s.interned) insert(s.hash, s.interned);
+    }
+  }
+
+  // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+  auto copy_to(std::size_t first, std::size_t last,
+      intern_table<Entry>& to) const -> void override {
+    for (std::size_t i = first; i < last; i++) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const slot& s = slots_[i];
+      if (s.interned) to.insert(s.hash, s.interned);
+    }
+  }
+
+  [[nodiscard]] auto bucket_count() const -> std::size_t override {
+    return hash_mask_ + 1;
+  }
+
+  auto chain_lengths(std::vector<std::size_t>& lengths) const -> void override {
+    if (lengths.size() < max_probe_ + 2) lengths.resize(max_probe_ + 2);
+    for (std::size_t i = 0; i <= hash_mask_; i++) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const slot& s = slots_[i];
+      if (s.interned) {
+        lengths[distance(i, s.hash) + 1]++;
+      } else {
+        lengths[0]++;
+      }
+    }
+  }
+
+  [[nodiscard]] auto bytes() const -> std::size_t override {
+    return (hash_mask_ + 1) * sizeof(slot);
+  }
+
+  [[nodiscard]] auto max_fill() const -> float override {
+    // Probe lengths increase quickly as the table fills up.
+    return 0.875;
+  }
+
+ private:
+  std::size_t hash_mask_{};
+  std::unique_ptr<slot[]> slots_{};
+  std::size_t max_probe_{};
+
+  /// @brief The distance of the slot from the preferred slot of the hash.
+  [[nodiscard]] auto distance(std::size_t i, std::size_t h) const
+      -> std::size_t {
+    return (i - h) & hash_mask_;
+  }
+};
+
+// Some details about the implementation.
+//
+// The rehash_count_ == buckets initially, because the max_load_factor_ is 1.0.
+//
+// When the rehash_count_ == 0, then no more checks should be made to increase
+// the number of buckets. We've reached the maximum.
+//
+// load_factor = interned_ / buckets.
+//
+// max_load_factor = rehash_count_ / buckets.
+//
+// The table may limit the max_load_factor further with max_fill(), as an open
+// addressing table can't store more strings than it has buckets.
+//
+// With an incremental rehash, set_ is always the newest table and new strings
+// are only added to it. The old_set_ is kept until all its buckets are copied
+// to set_, and is searched after set_.
+
+/// @brief The interned strings indexed by identifier.
+///
+/// The pointers are kept in fixed-size chunks that are never moved, so adding
+/// an identifier never copies the ones before it, as growing a vector would.
+/// Only the list of chunks grows, which is CHUNK_SIZE times smaller.
+template <typename Entry>
+class id_table {
+ public:
+  [[nodiscard]] auto size() const -> std::size_t { return size_; }
+
+  /// @brief Get the entry for the identifier.
+  ///
+  /// @throws std::out_of_range if the identifier wasn't added.
+  [[nodiscard]] auto at(std::size_t id) const -> const Entry* {
+    if (id >= size_) throw std::out_of_range("str_intern unknown identifier");
+    return (*chunks_[id >> CHUNK_SHIFT])[id & CHUNK_MASK];
+  }
+
+  auto push_back(const Entry* entry) -> void {
+    if ((size_ & CHUNK_MASK) == 0) {
+      chunks_.push_back(std::make_unique<chunk>());
+    }
+    (*chunks_.back())[size_ & CHUNK_MASK] = entry;
+    size_++;
+  }
+
+  [[nodiscard]] auto bytes() const -> std::size_t {
+    return chunks_.size() * sizeof(chunk) +
+           chunks_.capacity() * sizeof(std::unique_ptr<chunk>);
+  }
+
+ private:
+  static constexpr std::size_t CHUNK_SHIFT = 12;
+  static constexpr std::size_t CHUNK_SIZE = std::size_t{1} << CHUNK_SHIFT;
+  static constexpr std::size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+  using chunk = std::array<const Entry*, CHUNK_SIZE>;
+
+  std::vector<std::unique_ptr<chunk>> chunks_{};
+  std::size_t size_{};
+};
+
+/// @brief The implementation of a str_intern, independent of how the strings
+/// are stored.
+///
+/// @tparam Storage the storage for interned strings. It has the type
+/// entry_type for a stored string, a method add(str, id) which copies the
+/// string and returns a reference to the new entry_type, and a method bytes()
+/// returning the memory used. An entry_type has the method view() returning
+/// the string, and the member id.
+template <typename Storage>
+class basic_interned {
+ private:
+  using hash_fn_t = std::size_t (*)(std::string_view) noexcept;
+
+ public:
+  using entry_type = typename Storage::entry_type;
+
+  basic_interned(const basic_interned&) = delete;
+  auto operator=(const basic_interned&) -> basic_interned& = delete;
+  basic_interned(basic_interned&&) noexcept = default;
+  auto operator=(basic_interned&&) noexcept -> basic_interned& = default;
+  ~basic_interned() = default;
+
+  // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+  basic_interned(std::size_t buckets, std::size_t max_buckets,
+      str_intern_backend backend, str_intern_rehash rehash,
+      str_intern_hash hash)
+      : max_buckets_(max_buckets),
+        backend_{backend},
+        rehash_mode_{rehash},
+        hash_{hash},
+        hash_fn_{select_hash(hash)} {
+    set_ = make_table(buckets);
+
+    // Assumes a max_load_factor = 1.0
+    rehash_count_ = std::min(buckets, fill_limit(buckets));
+    if (buckets == max_buckets) rehash_count_ = 0;
+  };
+
+  [[nodiscard]] auto size() const -> unsigned int { return interned_; }
+
+  auto intern(std::string_view str) -> entry_type& {
+    return intern(hash_fn_(str), str);
+  }
+
+  /// @brief Intern many strings, overlapping the cache misses of the lookups.
+  ///
+  /// The strings are interned in groups. All strings of a group are hashed and
+  /// their buckets are prefetched, before any string in the group is looked
+  /// up. The result is the same as calling intern() for each string in order.
+  ///
+  /// @tparam F the function called with the index and the entry of each
+  /// interned string.
+  ///
+  /// @param strs the strings to intern.
+  ///
+  /// @param count the number of strings.
+  ///
+  /// @param out called for each string in order.
+  template <typename F>
+  auto intern_batch(const std::string_view* strs, std::size_t count, F&& out)
+      -> void {
+    std::array<std::size_t, BATCH_SIZE> hashes{};
+    for (std::size_t first = 0; first < count; first += BATCH_SIZE) {
+      std::size_t n = std::min(BATCH_SIZE, count - first);
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+      for (std::size_t i = 0; i < n; i++) {
+        hashes[i] = hash_fn_(strs[first + i]);
+        set_->prefetch(hashes[i]);
+        if (old_set_) old_set_->prefetch(hashes[i]);
+      }
+
+      // A rehash while inserting makes the remaining prefetches useless, but
+      // the lookups are still correct.
+      for (std::size_t i = 0; i < n; i++) {
+        out(first + i, intern(hashes[i], strs[first + i]));
+      }
+      // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }
+
+  [[nodiscard]] auto lookup(std::uint32_t id) const -> const entry_type& {
+    return *ids_.at(id);
+  }
+
+  [[nodiscard]] auto max_load_factor() const -> float {
+    return max_load_factor_;
+  }
+
+  /// @brief Update the max_load_factor.
+  ///
+  /// @param ml the new maximum load factor.
+  auto max_load_factor(float ml) -> void {
+    // As a reminder, the load_factor is based on the number of interned_ words.
+    //
+    //  load_factor = interned_ / buckets
+    //
+    // So that the max_load_factor_ can tell us how many interned_ words we need
+    // before we need to rehash, such as:
+    //
+    //  max_load_factor_ = rehash_count_ / buckets
+    //
+    // so we want to recalculate what the new rehash_count_ should be.
+    //
+    //  rehash_count_ = max_load_factor_ * buckets
+    //
+    // If the rehash_count_ exceeds the maximum value, then we'll never rehash,
+    // so we can set rehash_count_ to zero. If it is smaller than the current
+    // value, we'll later have to update the size of the buckets the next time a
+    // word is entered. We don't do that here.
+
+    max_load_factor_ = ml;
+
+    std::size_t buckets = set_->bucket_count();
+    if (max_buckets_ == buckets) {
+      // No need to recalculate if we're already at the maximum size. The
+      // max_load_factor_ is then effectively ignored.
+      rehash_count_ = 0;
+    } else {
+      float f = static_cast<float>(buckets) * max_load_factor_;
+      if (f >= static_cast<float>(std::numeric_limits<std::size_t>::max())) {
+        rehash_count_ = 0;
+      } else {
+        rehash_count_ =
+            std::max(static_cast<std::size_t>(std::ceil(f)), buckets);
+      }
+
+      // The table itself may not be able to hold that many.
+      std::size_t limit = fill_limit(buckets);
+      if (rehash_count_ == 0 || rehash_count_ > limit) rehash_count_ = limit;
+    }
+  }
+
+  [[nodiscard]] auto bucket_count() const -> std::size_t {
+    return set_->bucket_count();
+  }
+
+  [[nodiscard]] auto backend() const -> str_intern_backend { return backend_; }
+
+  [[nodiscard]] auto rehash_mode() const -> str_intern_rehash {
+    return rehash_mode_;
+  }
+
+  [[nodiscard]] auto hash_function() const -> str_intern_hash { return hash_; }
+
+  [[nodiscard]] auto stats() const -> str_intern_stats {
+    str_intern_stats stats{};
+    set_->chain_lengths(stats.chain_lengths);
+    while (stats.chain_lengths.size() > 1 && stats.chain_lengths.back() == 0) {
+      stats.chain_lengths.pop_back();
+    }
+    stats.longest_probe = stats.chain_lengths.size() - 1;
+    stats.string_bytes = storage_.bytes();
+    stats.table_bytes = set_->bytes() + ids_.bytes();
+    if (old_set_) stats.table_bytes += old_set_->bytes();
+    stats.rehashes = rehashes_;
+    stats.rehash_time = rehash_time_;
+    stats.counters = STR_INTERN_COUNTERS != 0;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    return stats;
+  }
+
+ private:
+  std::size_t interned_{};
+
+  Storage storage_{};
+  std::unique_ptr<intern_table<entry_type>> set_{};
+
+  // While rehashing incrementally, the buckets being moved to set_. All
+  // buckets before rehash_bucket_ are already copied.
+  std::unique_ptr<intern_table<entry_type>> old_set_{};
+  std::size_t rehash_bucket_{};
+
+  // The interned strings in the order they were added, indexed by identifier.
+  id_table<entry_type> ids_{};
+
+  std::size_t max_buckets_{};
+  float max_load_factor_{1.0};
+  std::size_t rehash_count_{};
+  str_intern_backend backend_{};
+  str_intern_rehash rehash_mode_{};
+  str_intern_hash hash_{};
+  hash_fn_t hash_fn_{};
+
+  std::size_t rehashes_{};
+  std::chrono::nanoseconds rehash_time_{};
+  std::uint64_t hits_{};
+  std::uint64_t misses_{};
+
+  // The number of old buckets copied with every call while rehashing
+  // incrementally. As the new table has at least double the buckets, the copy
+  // is complete before the new table needs to grow again, unless the
+  // max_load_factor is very small.
+  static constexpr std::size_t REHASH_STEP = 16;
+
+  // The number of strings hashed and prefetched together by intern_batch().
+  // Enough to cover the memory latency, while the buckets prefetched for a
+  // group still fit in the L1 cache.
+  static constexpr std::size_t BATCH_SIZE = 16;
+
+  /// @brief Intern a string, for which the hash is already calculated.
+  auto intern(std::size_t h, std::string_view str) -> entry_type& {
+    if (old_set_) return intern_rehashing(h, str);
+
+    entry_type* found = set_->find(h, str);
+    if (found) return hit(*found);
+    return insert(h, str);
+  }
+
+  /// @brief Count a string that was found.
+  auto hit(entry_type& entry) -> entry_type& {
+#if STR_INTERN_COUNTERS
+    hits_++;
+#endif
+    return entry;
+  }
+
+  /// @brief The function to calculate the hash with.
+  ///
+  /// The hash is called through a pointer, the same as the out of line
+  /// std::hash<std::string_view> of the standard library.
+  [[nodiscard]] static auto select_hash(str_intern_hash hash) -> hash_fn_t {
+    switch (hash) {
+      case str_intern_hash::fast:
+        return [](std::string_view str) noexcept {
+          return static_cast<std::size_t>(hash64(str));
+        };
+      case str_intern_hash::simd:
+        return [](std::string_view str) noexcept {
+          return static_cast<std::size_t>(hash64_simd(str));
+        };
+      default:
+        return [](std::string_view str) noexcept {
+          return std::hash<std::string_view>{}(str);
+        };
+    }
+  }
+
+  [[nodiscard]] auto make_table(std::size_t buckets) const
+      -> std::unique_ptr<intern_table<entry_type>> {
+    if (backend_ == str_intern_backend::open_addressing) {
+      return std::make_unique<flat_table<entry_type>>(buckets);
+    }
+    return std::make_unique<chained_table<entry_type>>(buckets);
+  }
+
+  /// @brief Add a string that isn't interned.
+  auto insert(std::size_t h, std::string_view str) -> entry_type& {
+    if (rehash_count_ != 0 && interned_ >= rehash_count_) {
+      rehash(next_size());
+    } else if (interned_ >= fill_limit(max_buckets_)) {
+      throw std::length_error("str_intern has no free buckets");
+    }
+
+    std::size_t id = ids_.size();
+    if (id > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("str_intern has no free identifiers");
+    }
+
+    auto& interned = storage_.add(str, static_cast<std::uint32_t>(id));
+    ids_.push_back(&interned);
+    set_->insert(h, &interned);
+    interned_++;
+#if STR_INTERN_COUNTERS
+    misses_++;
+#endif
+    return interned;
+  }
+
+  /// @brief Intern a string while both the old and new buckets are used.
+  auto intern_rehashing(std::size_t h, std::string_view str) -> entry_type& {
+    rehash_step(REHASH_STEP);
+
+    // Strings already copied, or added since the rehash started, are in the
+    // new table. The old table is only needed for the remaining strings.
+    entry_type* found = set_->find(h, str);
+    if (found) return hit(*found);
+    if (old_set_) {
+      found = old_set_->find(h, str);
+      if (found) return hit(*found);
+    }
+    return insert(h, str);
+  }
+
+  /// @brief Copy some of the old buckets to the new table.
+  ///
+  /// @param buckets the maximum number of buckets to copy.
+  auto rehash_step(std::size_t buckets) -> void {
+#if STR_INTERN_COUNTERS
+    auto start = std::chrono::steady_clock::now();
+#endif
+    std::size_t old_buckets = old_set_->bucket_count();
+    std::size_t last = std::min(rehash_bucket_ + buckets, old_buckets);
+    old_set_->copy_to(rehash_bucket_, last, *set_);
+    rehash_bucket_ = last;
+    if (rehash_bucket_ == old_buckets) old_set_.reset();
+#if STR_INTERN_COUNTERS
+    rehash_time_ += std::chrono::steady_clock::now() - start;
+#endif
+  }
+
+  /// @brief The number of strings the table may hold for the buckets given.
+  ///
+  /// @param buckets the number of buckets in the table.
+  ///
+  /// @return the number of strings, which is at least one.
+  [[nodiscard]] auto fill_limit(std::size_t buckets) const -> std::size_t {
+    float fill = set_->max_fill();
+    if (fill == std::numeric_limits<float>::infinity()) {
+      return std::numeric_limits<std::size_t>::max();
+    }
+    if (buckets == max_buckets_) return buckets;
+    return std::max(
+        static_cast<std::size_t>(static_cast<float>(buckets) * fill),
+        static_cast<std::size_t>(1));
+  }
+
+  [[nodiscard]] auto next_size() const -> std::size_t {
+    // In calculating the number of buckets we want, we must fulfill the
+    // following formula, so that we don't have to hash immediately again:
+    //
+    //  rehash_count_ > interned
+    //
+    // and
+    //
+    //  rehash_count_ = max_load_factor_ * buckets
+    //
+    // This results in
+    //
+    //  buckets > interned_ / max_load_factor_
+    //
+    // and then rounded up to the next power of 2.
+
+    float ml = std::min(max_load_factor_, set_->max_fill());
+    float f = static_cast<float>(interned_ + 1) / ml;
+    auto new_buckets = static_cast<std::size_t>(std::ceil(f));
+    if (new_buckets >= max_buckets_) {
+      return max_buckets_;
+    }
+    return bit_ceil(new_buckets);
+  }
+
+  auto rehash(std::size_t new_buckets) -> void {
+    if (rehash_mode_ == str_intern_rehash::incremental) {
+      // The previous rehash must be complete, before starting a new one.
+      if (old_set_) rehash_step(old_set_->bucket_count());
+
+#if STR_INTERN_COUNTERS
+      auto start = std::chrono::steady_clock::now();
+#endif
+      auto new_set = make_table(new_buckets);
+      old_set_ = std::move(set_);
+      set_ = std::move(new_set);
+      rehash_bucket_ = 0;
+#if STR_INTERN_COUNTERS
+      rehash_time_ += std::chrono::steady_clock::now() - start;
+#endif
+    } else {
+#if STR_INTERN_COUNTERS
+      auto start = std::chrono::steady_clock::now();
+#endif
+      set_->rehash(new_buckets);
+#if STR_INTERN_COUNTERS
+      rehash_time_ += std::chrono::steady_clock::now() - start;
+#endif
+    }
+    rehashes_++;
+
+    if (new_buckets == max_buckets_) {
+      rehash_count_ = 0;
+    } else {
+      auto count = static_cast<std::size_t>(
+          static_cast<float>(new_buckets) * max_load_factor_);
+      rehash_count_ = std::min(count, fill_limit(new_buckets));
+    }
+  }
+};
+
+/// @brief Check the buckets given to the constructor of a str_intern.
+///
+/// @param buckets Number of buckets to use initially.
+///
+/// @param max_buckets Maximum number of buckets to use.
+///
+/// @exception std::invalid_argument The parameter buckets or max_buckets is
+/// not a power of 2. The parameter max_buckets is less than buckets.
+inline auto check_buckets(std::size_t buckets, std::size_t max_buckets)
+    -> void {
+  if (buckets == 0 || buckets & (buckets - 1)) {
+    throw std::invalid_argument("buckets is not a power of 2");
+  }
+  if (max_buckets < buckets) {
+    throw std::invalid_argument("max_buckets must be greater/equal to buckets");
+  }
+  if (max_buckets & (buckets - 1)) {
+    throw std::invalid_argument("max_buckets is not a power of 2");
+  }
+}
+
+}  // namespace ubench::string::details
+
+#endif
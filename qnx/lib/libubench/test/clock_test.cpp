@@ -1,11 +1,16 @@
 #include "ubench/clock.h"
 
 #include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ubench/thread.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 using ::testing::Eq;
+using ::testing::Ge;
 using ::testing::Ne;
 
 TEST(idle_clock, is_available) {
@@ -35,6 +40,53 @@ TEST(process_clock, is_available) {
   EXPECT_THAT(time.time_since_epoch().count(), Ne(0));
 }
 
+TEST(cpu_clock, now) {
+  std::vector<ubench::chrono::cpu_times> cpus{};
+  if (!ubench::chrono::cpu_clock::is_available()) {
+    EXPECT_THAT(ubench::chrono::cpu_clock::now(cpus), Eq(false));
+    EXPECT_THAT(cpus.size(), Eq(0));
+    GTEST_SKIP() << "cpu_clock not available";
+  }
+
+  // There may be CPUs offline, which we can't run on, so there are at least
+  // as many CPUs as we can run on.
+  ASSERT_THAT(ubench::chrono::cpu_clock::now(cpus), Eq(true));
+  EXPECT_THAT(cpus.size(), Ge(ubench::thread::thread_count()));
+
+  std::vector<ubench::chrono::cpu_times> later{};
+  ASSERT_THAT(ubench::chrono::cpu_clock::now(later), Eq(true));
+  ASSERT_THAT(later.size(), Eq(cpus.size()));
+  for (std::size_t cpu = 0; cpu < cpus.size(); cpu++) {
+    EXPECT_THAT(later[cpu].idle >= cpus[cpu].idle, Eq(true));
+    EXPECT_THAT(later[cpu].user >= cpus[cpu].user, Eq(true));
+    EXPECT_THAT(later[cpu].system >= cpus[cpu].system, Eq(true));
+  }
+}
+
+TEST(cycle_clock, now) {
+  EXPECT_THAT(ubench::chrono::cycle_clock::ns_per_tick() > 0.0, Eq(true));
+
+  auto t1 = ubench::chrono::cycle_clock::now();
+  auto t2 = ubench::chrono::cycle_clock::now();
+  EXPECT_THAT(t2 >= t1, Eq(true));
+}
+
+TEST(cycle_clock, steady_clock) {
+  // The rate is calibrated against the steady clock, so both should measure
+  // about the same time. The test may be preempted, so the bounds are loose.
+  static_cast<void>(ubench::chrono::cycle_clock::ns_per_tick());
+  auto steady_start = std::chrono::steady_clock::now();
+  auto start = ubench::chrono::cycle_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  auto end = ubench::chrono::cycle_clock::now();
+  auto steady_end = std::chrono::steady_clock::now();
+
+  auto elapsed = end - start;
+  auto steady_elapsed = steady_end - steady_start;
+  EXPECT_THAT(elapsed >= std::chrono::milliseconds{40}, Eq(true));
+  EXPECT_THAT(elapsed <= steady_elapsed * 1.1, Eq(true));
+}
+
 TEST(timespec, nanoseconds_t0) {
   std::chrono::nanoseconds ns{0};
   timespec ts = ubench::chrono::duration_to_timespec(ns);
@@ -0,0 +1,47 @@
+#include "ubench/measure/busy_measurement.h"
+
+#include <chrono>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(busy_measurement, cpu_table_empty) {
+  ubench::measure::busy_measurement m{};
+  m.run_time = 1000ms;
+
+  auto t = ubench::measure::make_cpu_table(m);
+  EXPECT_EQ(t.size(), 0);
+}
+
+TEST(busy_measurement, cpu_table) {
+  ubench::measure::busy_measurement m{};
+  m.run_time = 1000ms;
+  m.cpus.push_back({});
+  m.cpus[0].user = 250ms;
+  m.cpus[0].system = 125ms;
+  m.cpus[0].irq = 1ms;
+  m.cpus[0].idle = 624ms;
+  m.cpus[0].busy = 376ms;
+
+  std::stringstream os{};
+  os << ubench::measure::make_cpu_table(m) << std::flush;
+  EXPECT_EQ(os.str(),
+      "| CPU | Busy % | User % | System % | IRQ % | SoftIRQ % | Steal % | "
+      "IOWait % | Idle % |\n"
+      "| --: | -----: | -----: | -------: | ----: | --------: | ------: | "
+      "-------: | -----: |\n"
+      "|   0 |  37.60 |  25.00 |    12.50 |  0.10 |      0.00 |    0.00 | "
+      "    0.00 |  62.40 |");
+}
+
+TEST(busy_stop_watch, cpus) {
+  ubench::measure::busy_stop_watch sw{};
+  auto m = sw.measure();
+  if (!ubench::chrono::cpu_clock::is_available()) {
+    EXPECT_EQ(m.cpus.size(), 0);
+    GTEST_SKIP() << "cpu_clock not available";
+  }
+  EXPECT_GT(m.cpus.size(), 0);
+}
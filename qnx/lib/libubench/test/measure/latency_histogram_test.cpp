@@ -0,0 +1,48 @@
+#include "ubench/measure/latency_histogram.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(latency_histogram, empty) {
+  ubench::measure::latency_histogram h{};
+  EXPECT_EQ(h.count(), 0U);
+  EXPECT_EQ(h.percentile(50.0), 0ns);
+  EXPECT_EQ(h.max(), 0ns);
+}
+
+TEST(latency_histogram, small_values_exact) {
+  ubench::measure::latency_histogram h{};
+  for (int i = 1; i <= 10; i++) {
+    h.record(std::chrono::nanoseconds{i});
+  }
+  EXPECT_EQ(h.count(), 10U);
+  EXPECT_EQ(h.percentile(50.0), 5ns);
+  EXPECT_EQ(h.percentile(100.0), 10ns);
+  EXPECT_EQ(h.max(), 10ns);
+}
+
+TEST(latency_histogram, large_values_precision) {
+  ubench::measure::latency_histogram h{};
+  h.record(1000000ns);
+  h.record(-5ns);
+
+  // The bucket of a large value is at most 1/32 wider than the value.
+  EXPECT_EQ(h.percentile(50.0), 0ns);
+  EXPECT_EQ(h.percentile(100.0), 1000000ns);
+  EXPECT_GE(h.percentile(99.0), 1000000ns);
+}
+
+TEST(latency_histogram, merge) {
+  ubench::measure::latency_histogram a{};
+  ubench::measure::latency_histogram b{};
+  a.record(10ns);
+  b.record(20ns);
+  b.record(30ns);
+  a.merge(b);
+  EXPECT_EQ(a.count(), 3U);
+  EXPECT_EQ(a.percentile(50.0), 20ns);
+  EXPECT_EQ(a.max(), 30ns);
+}
@@ -0,0 +1,48 @@
+#include "ubench/measure/perf_counters.h"
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+TEST(perf_counters, names) {
+  EXPECT_EQ(std::string{ubench::measure::perf_event_name(
+                ubench::measure::perf_event::cycles)},
+      "Cycles");
+  EXPECT_EQ(std::string{ubench::measure::perf_event_name(
+                ubench::measure::perf_event::branch_misses)},
+      "Branch Misses");
+}
+
+TEST(perf_counters, count) {
+  ubench::measure::perf_counters perf{};
+  perf.start();
+  volatile std::uint64_t sum = 0;
+  for (std::uint64_t i = 0; i < 100000; i++) {
+    sum = sum + i;
+  }
+  perf.stop();
+  auto sample = perf.read();
+
+  if (!perf.is_available()) {
+    // Counting isn't allowed, which isn't an error.
+    EXPECT_NE(perf.error(), 0);
+    for (const auto& value : sample.values) {
+      EXPECT_FALSE(value);
+    }
+    GTEST_SKIP() << "perf_counters not available";
+  }
+
+  // The CPU may have no counter free for the group, then nothing is counted.
+  auto instructions = sample.get(ubench::measure::perf_event::instructions);
+  if (instructions) {
+    EXPECT_GE(*instructions, 100000);
+  }
+}
+
+TEST(perf_counters, move) {
+  ubench::measure::perf_counters perf{};
+  bool available = perf.is_available();
+  ubench::measure::perf_counters moved{std::move(perf)};
+  EXPECT_EQ(moved.is_available(), available);
+}
@@ -1,6 +1,9 @@
 #include "ubench/measure/print.h"
 
+#include <chrono>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -168,3 +171,71 @@ TEST(print_table, no_header_two_cols) {
   os << t << std::flush;
   EXPECT_EQ(os.str(), "| x | y |");
 }
+
+TEST(print_table, vector_line) {
+  std::stringstream os{};
+  ubench::measure::table t{};
+  t.add_column("col 1");
+  t.add_column("col 2");
+  std::vector<std::string> line{"x"};
+  EXPECT_FALSE(t.add_line(line));
+  line.emplace_back("yy");
+  EXPECT_TRUE(t.add_line(line));
+
+  os << t << std::flush;
+  EXPECT_EQ(os.str(), "| col 1 | col 2 |\n| ----- | ----- |\n| x     | yy    |");
+}
+
+TEST(print_table_json, empty) {
+  std::stringstream os{};
+  ubench::measure::table t{};
+  t.add_column("col 1");
+
+  t.write_json(os);
+  EXPECT_EQ(os.str(), "[]");
+}
+
+TEST(print_table_json, rows) {
+  std::stringstream os{};
+  ubench::measure::table t{};
+  t.add_column("name");
+  t.add_column("value", ubench::measure::alignment::right);
+  t.add_line({"a", "10"});
+  t.add_line({"b", "-0.5e3"});
+
+  t.write_json(os);
+  EXPECT_EQ(os.str(),
+      "[\n  {\"name\": \"a\", \"value\": 10},\n"
+      "  {\"name\": \"b\", \"value\": -0.5e3}\n]");
+}
+
+TEST(print_table_json, not_numbers) {
+  std::stringstream os{};
+  ubench::measure::table t{};
+  t.add_line({"", "01", "1.", "+1", "1e", "99:1", "0"});
+
+  t.write_json(os);
+  EXPECT_EQ(os.str(),
+      "[\n  [\"\", \"01\", \"1.\", \"+1\", \"1e\", \"99:1\", 0]\n]");
+}
+
+TEST(print_table_json, escape) {
+  std::stringstream os{};
+  ubench::measure::table t{};
+  t.add_column("a \"b\"");
+  t.add_line({"c\\d\n\x01"});
+
+  t.write_json(os);
+  EXPECT_EQ(os.str(), "[\n  {\"a \\\"b\\\"\": \"c\\\\d\\n\\u0001\"}\n]");
+}
+
+TEST(print_percent, format) {
+  using namespace std::chrono_literals;
+  EXPECT_EQ(ubench::measure::percent(1ms, 8ms), "12.50");
+  EXPECT_EQ(ubench::measure::percent(1ms, 1000ms), "0.10");
+  EXPECT_EQ(ubench::measure::percent(3s, 1s), "300.00");
+  EXPECT_EQ(ubench::measure::percent(1ms, 0ms), "-");
+
+  // The product with the precision would overflow 64 bits.
+  EXPECT_EQ(ubench::measure::percent(480h, 960h), "50.00");
+}
@@ -0,0 +1,62 @@
+#include "ubench/measure/sampler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(sampler, not_started) {
+  ubench::measure::sampler s{1ms, 10};
+  EXPECT_EQ(s.elapsed().count(), 0);
+  EXPECT_EQ(s.series().size(), 0);
+  EXPECT_EQ(s.overwritten(), 0);
+  s.stop();
+}
+
+TEST(sampler, series) {
+  std::atomic<std::uint64_t> counter{0};
+  ubench::measure::sampler s{2ms, 1000};
+  EXPECT_TRUE(s.add_counter("Counter", counter));
+  ASSERT_TRUE(s.start());
+  EXPECT_FALSE(s.start());
+  EXPECT_FALSE(s.add_counter("Late", counter));
+
+  for (int i = 0; i < 20; i++) {
+    counter += 10;
+    std::this_thread::sleep_for(1ms);
+  }
+  s.stop();
+
+  auto series = s.series();
+  ASSERT_GE(series.size(), 1);
+  EXPECT_EQ(s.overwritten(), 0);
+
+  std::uint64_t total = 0;
+  auto time = 0ns;
+  for (const auto& interval : series) {
+    EXPECT_GT(interval.time, time);
+    EXPECT_GE(interval.late.count(), 0);
+    ASSERT_EQ(interval.counters.size(), 1);
+    total += interval.counters[0];
+    time = interval.time;
+  }
+  EXPECT_EQ(total, 200);
+
+  // A line per interval.
+  EXPECT_EQ(s.make_table().size(), series.size());
+}
+
+TEST(sampler, overwritten) {
+  ubench::measure::sampler s{1ms, 2};
+  ASSERT_TRUE(s.start());
+  std::this_thread::sleep_for(20ms);
+  s.stop();
+
+  // Only the last two samples are kept, which is one interval.
+  EXPECT_GT(s.overwritten(), 0);
+  EXPECT_EQ(s.series().size(), 1);
+}
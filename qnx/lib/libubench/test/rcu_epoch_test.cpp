@@ -0,0 +1,282 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ubench/atomics.h"
+
+namespace {
+
+// Counts the objects freed, so a test can check when they are reclaimed.
+std::atomic<int> freed{0};
+
+struct counted_delete {
+  auto operator()(int *p) const -> void {
+    freed++;
+    delete p;  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+};
+
+using counted_ptr = std::unique_ptr<int, counted_delete>;
+
+auto make_counted(int value) -> counted_ptr {
+  return counted_ptr{new int{value}};
+}
+
+}  // namespace
+
+TEST(rcu_epoch, read_init_and_read) {
+  std::unique_ptr v = std::make_unique<int>(10);
+  int *rv = v.get();
+  rcu_epoch x{std::move(v)};
+
+  rcu_epoch_ptr p = x.read();
+  EXPECT_TRUE(p);
+  EXPECT_EQ(p.get(), rv);
+  EXPECT_EQ(*p, 10);
+}
+
+TEST(rcu_epoch, update_null_pointer) {
+  rcu_epoch x{std::make_unique<int>(10)};
+  EXPECT_FALSE(x.update(nullptr));
+  EXPECT_EQ(*x.read(), 10);
+}
+
+TEST(rcu_epoch, update_while_reading) {
+  freed = 0;
+  rcu_epoch<int, counted_delete> x{make_counted(10)};
+
+  rcu_epoch_ptr p = x.read();
+  EXPECT_TRUE(x.update(make_counted(20)));
+
+  // The old object is still read, so it isn't freed.
+  EXPECT_EQ(*p, 10);
+  EXPECT_EQ(*x.read(), 20);
+  EXPECT_EQ(freed.load(), 0);
+  EXPECT_EQ(x.reclaim(), 1U);
+
+  p.reset();
+  EXPECT_EQ(x.reclaim(), 0U);
+  EXPECT_EQ(freed.load(), 1);
+}
+
+TEST(rcu_epoch, update_many_never_fails) {
+  freed = 0;
+  {
+    rcu_epoch<int, counted_delete> x{make_counted(0)};
+    rcu_epoch_ptr p = x.read();
+
+    // Unlike `rcu`, holding a reference doesn't limit the number of updates.
+    for (int i = 1; i <= 20; i++) {
+      EXPECT_TRUE(x.update(make_counted(i)));
+    }
+    EXPECT_EQ(*p, 0);
+    EXPECT_EQ(*x.read(), 20);
+    EXPECT_EQ(freed.load(), 0);
+
+    p.reset();
+    EXPECT_EQ(x.reclaim(), 0U);
+    EXPECT_EQ(freed.load(), 20);
+  }
+  EXPECT_EQ(freed.load(), 21);
+}
+
+TEST(rcu_epoch, update_frees_after_read) {
+  freed = 0;
+  rcu_epoch<int, counted_delete> x{make_counted(0)};
+
+  {
+    rcu_epoch_ptr p = x.read();
+    EXPECT_EQ(*p, 0);
+  }
+
+  // No reader, so the old object is freed by the update.
+  EXPECT_TRUE(x.update(make_counted(1)));
+  EXPECT_EQ(freed.load(), 1);
+}
+
+TEST(rcu_epoch, nested_read) {
+  freed = 0;
+  rcu_epoch<int, counted_delete> x{make_counted(0)};
+
+  rcu_epoch_ptr p = x.read();
+  EXPECT_TRUE(x.update(make_counted(1)));
+  {
+    rcu_epoch_ptr q = x.read();
+    EXPECT_EQ(*q, 1);
+  }
+
+  // The inner read ended, but the outer read still holds the old object.
+  EXPECT_EQ(x.reclaim(), 1U);
+  EXPECT_EQ(*p, 0);
+
+  p.reset();
+  EXPECT_EQ(x.reclaim(), 0U);
+}
+
+TEST(rcu_epoch, reader_on_other_thread) {
+  freed = 0;
+  rcu_epoch<int, counted_delete> x{make_counted(0)};
+
+  std::atomic<bool> reading{false};
+  std::atomic<bool> done{false};
+  std::thread reader([&]() {
+    rcu_epoch_ptr p = x.read();
+    reading = true;
+    while (!done) std::this_thread::yield();
+    EXPECT_EQ(*p, 0);
+  });
+  while (!reading) std::this_thread::yield();
+
+  EXPECT_TRUE(x.update(make_counted(1)));
+  EXPECT_EQ(x.reclaim(), 1U);
+  EXPECT_EQ(freed.load(), 0);
+
+  done = true;
+  reader.join();
+  EXPECT_EQ(x.reclaim(), 0U);
+  EXPECT_EQ(freed.load(), 1);
+}
+
+TEST(rcu_epoch, ptr_move) {
+  rcu_epoch x{std::make_unique<int>(5)};
+
+  rcu_epoch_ptr p1 = x.read();
+  rcu_epoch_ptr p2{std::move(p1)};
+  // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move)
+  EXPECT_FALSE(p1);
+  EXPECT_TRUE(p2);
+
+  rcu_epoch_ptr<int> p3;
+  p3 = std::move(p2);
+  // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move)
+  EXPECT_FALSE(p2);
+  EXPECT_EQ(*p3, 5);
+}
+
+TEST(rcu_epoch, stress) {
+  freed = 0;
+  {
+    rcu_epoch<int, counted_delete> x{make_counted(0)};
+    std::atomic<bool> terminate{false};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+      readers.emplace_back([&]() {
+        int last = 0;
+        while (!terminate) {
+          rcu_epoch_ptr p = x.read();
+          EXPECT_GE(*p, last);
+          last = *p;
+        }
+      });
+    }
+
+    for (int i = 1; i <= 1000; i++) {
+      EXPECT_TRUE(x.update(make_counted(i)));
+    }
+    terminate = true;
+    for (auto &r : readers) {
+      r.join();
+    }
+    EXPECT_EQ(x.reclaim(), 0U);
+    EXPECT_EQ(freed.load(), 1000);
+  }
+  EXPECT_EQ(freed.load(), 1001);
+}
+
+TEST(rcu_epoch, synchronize_waits_for_reader) {
+  rcu_epoch x{std::make_unique<int>(0)};
+
+  std::atomic<bool> reading{false};
+  std::atomic<bool> released{false};
+  std::thread reader([&]() {
+    rcu_epoch_ptr p = x.read();
+    reading = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    released = true;
+  });
+  while (!reading) std::this_thread::yield();
+
+  rcu_epoch_domain::global().synchronize();
+  EXPECT_TRUE(released.load());
+  reader.join();
+}
+
+TEST(rcu_epoch, reclaimer_frees_after_read) {
+  freed = 0;
+  rcu_reclaimer reclaimer{};
+  rcu_epoch<int, counted_delete> x{make_counted(0), reclaimer};
+
+  std::atomic<bool> reading{false};
+  std::atomic<bool> done{false};
+  std::thread reader([&]() {
+    rcu_epoch_ptr p = x.read();
+    reading = true;
+    while (!done) std::this_thread::yield();
+    EXPECT_EQ(*p, 0);
+  });
+  while (!reading) std::this_thread::yield();
+
+  // The update returns at once, the free waits for the reader.
+  EXPECT_TRUE(x.update(make_counted(1)));
+  EXPECT_EQ(*x.read(), 1);
+  rcu_reclaimer_stats stats = reclaimer.stats();
+  EXPECT_EQ(stats.pending, 1U);
+  EXPECT_EQ(stats.pending_bytes, sizeof(int));
+  EXPECT_EQ(freed.load(), 0);
+
+  done = true;
+  reader.join();
+  reclaimer.barrier();
+  EXPECT_EQ(freed.load(), 1);
+  stats = reclaimer.stats();
+  EXPECT_EQ(stats.pending, 0U);
+  EXPECT_EQ(stats.pending_bytes, 0U);
+  EXPECT_EQ(stats.max_pending, 1U);
+  EXPECT_EQ(stats.reclaimed, 1U);
+}
+
+TEST(rcu_epoch, reclaimer_slow_reader_never_blocks_update) {
+  freed = 0;
+  {
+    rcu_reclaimer reclaimer{};
+    rcu_epoch<int, counted_delete> x{make_counted(0), reclaimer};
+
+    std::atomic<bool> reading{false};
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+      rcu_epoch_ptr p = x.read();
+      reading = true;
+      while (!done) std::this_thread::yield();
+    });
+    while (!reading) std::this_thread::yield();
+
+    // None of the old objects can be freed while the reader holds the first.
+    for (int i = 1; i <= 100; i++) {
+      EXPECT_TRUE(x.update(make_counted(i)));
+    }
+    EXPECT_EQ(reclaimer.stats().pending, 100U);
+    EXPECT_EQ(freed.load(), 0);
+
+    done = true;
+    reader.join();
+  }
+  // The reclaimer frees what is still queued when it is destroyed.
+  EXPECT_EQ(freed.load(), 101);
+}
+
+TEST(rcu_epoch, reclaimer_call) {
+  rcu_reclaimer reclaimer{std::chrono::microseconds{100}};
+  std::atomic<int> calls{0};
+  for (int i = 0; i < 10; i++) {
+    reclaimer.call([&]() { calls++; });
+  }
+  reclaimer.barrier();
+  EXPECT_EQ(calls.load(), 10);
+  EXPECT_EQ(reclaimer.stats().reclaimed, 10U);
+  EXPECT_GE(reclaimer.stats().batches, 1U);
+}
@@ -0,0 +1,147 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ubench/atomics.h"
+
+TEST(rcu_map, empty) {
+  rcu_map<int, int> map{};
+  EXPECT_EQ(map.size(), 0U);
+  EXPECT_EQ(map.bucket_count(), 16U);
+  EXPECT_FALSE(map.find(1));
+  EXPECT_FALSE(map.get(1));
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_FALSE(map.erase(1));
+}
+
+TEST(rcu_map, buckets_power_of_two) {
+  rcu_map<int, int> map{100};
+  EXPECT_EQ(map.bucket_count(), 128U);
+}
+
+TEST(rcu_map, insert_and_find) {
+  rcu_map<std::string, int> map{};
+  EXPECT_TRUE(map.insert_or_assign("one", 1));
+  EXPECT_TRUE(map.insert_or_assign("two", 2));
+  EXPECT_EQ(map.size(), 2U);
+
+  rcu_epoch_ptr one = map.find("one");
+  ASSERT_TRUE(one);
+  EXPECT_EQ(*one, 1);
+  EXPECT_EQ(map.get("two"), 2);
+  EXPECT_FALSE(map.contains("three"));
+}
+
+TEST(rcu_map, assign_keeps_old_value) {
+  rcu_map<int, std::string> map{};
+  EXPECT_TRUE(map.insert_or_assign(1, "old"));
+
+  rcu_epoch_ptr old = map.find(1);
+  EXPECT_FALSE(map.insert_or_assign(1, "new"));
+  EXPECT_EQ(map.size(), 1U);
+
+  // The reference still sees the value it found, a new lookup the new value.
+  EXPECT_EQ(*old, "old");
+  EXPECT_EQ(map.get(1), "new");
+  EXPECT_EQ(map.reclaim(), 1U);
+
+  old.reset();
+  EXPECT_EQ(map.reclaim(), 0U);
+}
+
+TEST(rcu_map, erase) {
+  rcu_map<int, int> map{};
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(map.insert_or_assign(i, i * 10));
+  }
+
+  rcu_epoch_ptr five = map.find(5);
+  EXPECT_TRUE(map.erase(5));
+  EXPECT_FALSE(map.erase(5));
+  EXPECT_EQ(map.size(), 9U);
+  EXPECT_FALSE(map.contains(5));
+  EXPECT_EQ(*five, 50);
+
+  for (int i = 0; i < 10; i++) {
+    if (i != 5) {
+      EXPECT_EQ(map.get(i), i * 10);
+    }
+  }
+}
+
+TEST(rcu_map, erase_in_chain) {
+  // One bucket, so that every key is in the same chain.
+  rcu_map<int, int> map{1};
+  EXPECT_TRUE(map.insert_or_assign(1, 1));
+  EXPECT_TRUE(map.insert_or_assign(2, 2));
+  EXPECT_EQ(map.bucket_count(), 2U);
+  EXPECT_TRUE(map.insert_or_assign(3, 3));
+
+  EXPECT_TRUE(map.erase(2));
+  EXPECT_EQ(map.get(1), 1);
+  EXPECT_FALSE(map.get(2));
+  EXPECT_EQ(map.get(3), 3);
+}
+
+TEST(rcu_map, grow) {
+  rcu_map<int, int> map{4};
+  rcu_epoch_ptr<int> first;
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(map.insert_or_assign(i, i));
+    if (i == 0) first = map.find(0);
+  }
+  EXPECT_EQ(map.size(), 1000U);
+  EXPECT_GE(map.bucket_count(), 1000U);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(map.get(i), i);
+  }
+
+  // The node found before the map grew is still valid.
+  EXPECT_EQ(*first, 0);
+  first.reset();
+  EXPECT_EQ(map.reclaim(), 0U);
+}
+
+TEST(rcu_map, stress) {
+  constexpr int keys = 64;
+  rcu_map<int, std::uint64_t> map{};
+  for (int k = 0; k < keys; k++) {
+    map.insert_or_assign(k, 0);
+  }
+
+  std::atomic<bool> terminate{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&]() {
+      std::vector<std::uint64_t> last(keys);
+      while (!terminate) {
+        for (int k = 0; k < keys; k++) {
+          auto value = map.get(k);
+          ASSERT_TRUE(value);
+          EXPECT_GE(*value, last[k]);
+          last[k] = *value;
+        }
+      }
+    });
+  }
+
+  // Values only increase, and keys above `keys` are added and removed, so
+  // that the map grows while reading.
+  for (std::uint64_t i = 1; i <= 200; i++) {
+    for (int k = 0; k < keys; k++) {
+      map.insert_or_assign(k, i);
+    }
+    map.insert_or_assign(keys + static_cast<int>(i), i);
+    if (i % 2 == 0) map.erase(keys + static_cast<int>(i) - 1);
+  }
+  terminate = true;
+  for (auto &r : readers) {
+    r.join();
+  }
+  EXPECT_EQ(map.reclaim(), 0U);
+  EXPECT_EQ(map.get(0), 200U);
+}
@@ -0,0 +1,236 @@
+#include <sys/resource.h>
+
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ubench/atomics.h"
+
+namespace {
+
+class nocore {
+ public:
+  nocore() {
+    int rgres = getrlimit(RLIMIT_CORE, &limit_cur_);
+    EXPECT_EQ(rgres, 0) << "couldn't get RLIMIT_CORE";
+
+    struct rlimit limit_new = limit_cur_;
+    limit_new.rlim_cur = 0;
+    int rsres = setrlimit(RLIMIT_CORE, &limit_new);
+    EXPECT_EQ(rsres, 0) << "couldn't set RLIMIT_CORE";
+  }
+  nocore(const nocore &) = delete;
+  nocore(nocore &&) noexcept = default;
+  auto operator=(const nocore &) -> nocore & = delete;
+  auto operator=(nocore &&) noexcept -> nocore & = default;
+  ~nocore() {
+    int rrres = setrlimit(RLIMIT_CORE, &limit_cur_);
+    EXPECT_EQ(rrres, 0) << "couldn't restore RLIMIT_CORE";
+  }
+
+ private:
+  struct rlimit limit_cur_ {};
+};
+
+// Counts the objects freed, so a test can check when they are reclaimed.
+std::atomic<int> freed{0};
+
+struct counted_delete {
+  auto operator()(int *p) const -> void {
+    freed++;
+    delete p;  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+};
+
+using counted_ptr = std::unique_ptr<int, counted_delete>;
+
+auto make_counted(int value) -> counted_ptr {
+  return counted_ptr{new int{value}};
+}
+
+}  // namespace
+
+TEST(rcu_sharded, init_null_pointer) {
+  nocore ncore{};
+
+  EXPECT_EXIT(
+      { rcu_sharded<int> x{nullptr}; }, testing::KilledBySignal(SIGABRT), "");
+}
+
+TEST(rcu_sharded, init_destructor_when_not_free) {
+  nocore ncore{};
+
+  rcu_sharded_ptr<int> p;
+
+  EXPECT_EXIT(
+      {
+        rcu_sharded x{std::make_unique<int>(5)};
+        p = x.read();
+
+        // x would be destroyed here, while p outlives x.
+      },
+      testing::KilledBySignal(SIGABRT), "");
+}
+
+TEST(rcu_sharded, read_init_and_read) {
+  std::unique_ptr v = std::make_unique<int>(10);
+  int *rv = v.get();
+  rcu_sharded x{std::move(v)};
+
+  rcu_sharded_ptr p = x.read();
+  EXPECT_TRUE(p);
+  EXPECT_EQ(p.get(), rv);
+  EXPECT_EQ(*p, 10);
+}
+
+TEST(rcu_sharded, update_null_pointer) {
+  rcu_sharded x{std::make_unique<int>(10)};
+  EXPECT_FALSE(x.update(nullptr));
+  EXPECT_EQ(*x.read(), 10);
+}
+
+TEST(rcu_sharded, update_while_reading) {
+  freed = 0;
+  rcu_sharded<int, counted_delete> x{make_counted(10)};
+
+  rcu_sharded_ptr p = x.read();
+  EXPECT_TRUE(x.update(make_counted(20)));
+
+  // The old object is still read, so it isn't freed.
+  EXPECT_EQ(*p, 10);
+  EXPECT_EQ(*x.read(), 20);
+  EXPECT_EQ(freed.load(), 0);
+  EXPECT_EQ(x.reclaim(), 1U);
+
+  // Releasing the reference doesn't free the object, the writer does.
+  p.reset();
+  EXPECT_EQ(freed.load(), 0);
+  EXPECT_EQ(x.reclaim(), 0U);
+  EXPECT_EQ(freed.load(), 1);
+}
+
+TEST(rcu_sharded, update_frees_after_read) {
+  freed = 0;
+  rcu_sharded<int, counted_delete> x{make_counted(0)};
+
+  {
+    rcu_sharded_ptr p = x.read();
+    EXPECT_EQ(*p, 0);
+  }
+
+  // No reader, so the old object is freed by the update.
+  EXPECT_TRUE(x.update(make_counted(1)));
+  EXPECT_EQ(freed.load(), 1);
+}
+
+TEST(rcu_sharded, update_many) {
+  freed = 0;
+  {
+    rcu_sharded<int, counted_delete, 5> x{make_counted(0)};
+    rcu_sharded_ptr p = x.read();
+
+    // The slot of p remains in use, the others are freed and reused.
+    for (int i = 1; i <= 10; i++) {
+      EXPECT_TRUE(x.update(make_counted(i)));
+    }
+    EXPECT_EQ(*p, 0);
+    EXPECT_EQ(*x.read(), 10);
+    EXPECT_EQ(freed.load(), 9);
+  }
+  EXPECT_EQ(freed.load(), 11);
+}
+
+TEST(rcu_sharded, update_full) {
+  rcu_sharded<int, std::default_delete<int>, 5> x{std::make_unique<int>(0)};
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+  std::array<rcu_sharded_ptr<int>, 5> p;
+  for (int i = 0; i < 4; i++) {
+    p[i] = x.read();
+    EXPECT_EQ(*p[i], i);
+    EXPECT_TRUE(x.update(std::make_unique<int>(i + 1)));
+  }
+  p[4] = x.read();
+  // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+
+  // Too many different `rcu_sharded_ptr` instances with different values.
+  std::unique_ptr v = std::make_unique<int>(5);
+  EXPECT_FALSE(x.update(std::move(v)));
+  EXPECT_EQ(*x.read(), 4);
+  EXPECT_EQ(x.reclaim(), 4U);
+
+  // Releasing one reference frees a slot for the next update.
+  p[0].reset();
+  EXPECT_TRUE(x.update(std::make_unique<int>(6)));
+  EXPECT_EQ(*x.read(), 6);
+}
+
+TEST(rcu_sharded, ptr_copy) {
+  freed = 0;
+  rcu_sharded<int, counted_delete> x{make_counted(0)};
+
+  rcu_sharded_ptr p1 = x.read();
+  rcu_sharded_ptr p1c{p1};
+  EXPECT_TRUE(x.update(make_counted(1)));
+
+  p1.reset();
+  EXPECT_EQ(x.reclaim(), 1U);
+  EXPECT_EQ(*p1c, 0);
+
+  p1c.reset();
+  EXPECT_EQ(x.reclaim(), 0U);
+  EXPECT_EQ(freed.load(), 1);
+}
+
+TEST(rcu_sharded, ptr_move) {
+  rcu_sharded x{std::make_unique<int>(5)};
+
+  rcu_sharded_ptr p1 = x.read();
+  rcu_sharded_ptr p2{std::move(p1)};
+  // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move)
+  EXPECT_FALSE(p1);
+  EXPECT_TRUE(p2);
+
+  rcu_sharded_ptr<int> p3;
+  p3 = std::move(p2);
+  // NOLINTNEXTLINE(bugprone-use-after-move, clang-analyzer-cplusplus.Move)
+  EXPECT_FALSE(p2);
+  EXPECT_EQ(*p3, 5);
+}
+
+TEST(rcu_sharded, stress) {
+  freed = 0;
+  {
+    rcu_sharded<int, counted_delete> x{make_counted(0)};
+    std::atomic<bool> terminate{false};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+      readers.emplace_back([&]() {
+        int last = 0;
+        while (!terminate) {
+          rcu_sharded_ptr p = x.read();
+          EXPECT_GE(*p, last);
+          last = *p;
+        }
+      });
+    }
+
+    // Each reader holds at most one slot, so there is always a free slot.
+    for (int i = 1; i <= 1000; i++) {
+      EXPECT_TRUE(x.update(make_counted(i)));
+    }
+    terminate = true;
+    for (auto &r : readers) {
+      r.join();
+    }
+    EXPECT_EQ(x.reclaim(), 0U);
+    EXPECT_EQ(freed.load(), 1000);
+  }
+  EXPECT_EQ(freed.load(), 1001);
+}
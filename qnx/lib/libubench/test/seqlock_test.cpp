@@ -0,0 +1,115 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ubench/atomics.h"
+
+namespace {
+
+// The second field is the inverse of the first, so a torn read can be seen.
+struct pair {
+  std::uint64_t value{};
+  std::uint64_t inverse{~std::uint64_t{0}};
+};
+
+// An object that isn't a multiple of the word size.
+struct odd {
+  std::array<char, 11> text{};
+};
+
+}  // namespace
+
+TEST(seqlock, default_value) {
+  seqlock<int> x{};
+  EXPECT_EQ(x.load(), 0);
+  EXPECT_EQ(x.sequence(), 0U);
+}
+
+TEST(seqlock, init_and_load) {
+  seqlock<pair> x{pair{5, ~std::uint64_t{5}}};
+  pair p = x.load();
+  EXPECT_EQ(p.value, 5U);
+  EXPECT_EQ(p.inverse, ~std::uint64_t{5});
+}
+
+TEST(seqlock, store) {
+  seqlock<int> x{1};
+  x.store(2);
+  EXPECT_EQ(x.load(), 2);
+  x.store(3);
+  EXPECT_EQ(x.load(), 3);
+  EXPECT_EQ(x.sequence(), 4U);
+}
+
+TEST(seqlock, odd_size) {
+  seqlock<odd> x{};
+  odd o{{'h', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd'}};
+  x.store(o);
+  EXPECT_EQ(x.load().text, o.text);
+}
+
+TEST(seqlock, update) {
+  seqlock<pair> x{};
+  x.update([](pair &p) {
+    p.value = 10;
+    p.inverse = ~p.value;
+  });
+  EXPECT_EQ(x.load().value, 10U);
+  EXPECT_EQ(x.sequence(), 2U);
+}
+
+TEST(seqlock, update_many_writers) {
+  seqlock<std::uint64_t> x{};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 4; t++) {
+    writers.emplace_back([&]() {
+      for (int i = 0; i < 1000; i++) {
+        x.update([](std::uint64_t &v) { v++; });
+      }
+    });
+  }
+  for (auto &w : writers) {
+    w.join();
+  }
+
+  // No increment is lost, as the writers are serialised.
+  EXPECT_EQ(x.load(), 4000U);
+}
+
+TEST(seqlock, single_writer) {
+  seqlock<int, seqlock_no_mutex> x{1};
+  x.store(2);
+  x.update([](int &v) { v *= 10; });
+  EXPECT_EQ(x.load(), 20);
+}
+
+TEST(seqlock, stress) {
+  seqlock<pair, seqlock_no_mutex> x{};
+  std::atomic<bool> terminate{false};
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&]() {
+      std::uint64_t last = 0;
+      while (!terminate) {
+        pair p = x.load();
+        EXPECT_EQ(p.inverse, ~p.value);
+        EXPECT_GE(p.value, last);
+        last = p.value;
+      }
+    });
+  }
+
+  for (std::uint64_t i = 1; i <= 100000; i++) {
+    x.store(pair{i, ~i});
+  }
+  terminate = true;
+  for (auto &r : readers) {
+    r.join();
+  }
+  EXPECT_EQ(x.load().value, 100000U);
+}
@@ -0,0 +1,77 @@
+#include "ubench/str_hash.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(str_hash, hash64_same) {
+  std::string str1 = "the quick brown fox jumps over the lazy dog";
+  std::string str2 = str1;
+  EXPECT_EQ(ubench::string::hash64(str1), ubench::string::hash64(str2));
+  EXPECT_EQ(ubench::string::hash64(str1, 42), ubench::string::hash64(str2, 42));
+  EXPECT_NE(ubench::string::hash64(str1), ubench::string::hash64(str1, 42));
+}
+
+TEST(str_hash, hash64_simd_same) {
+  std::string str1 = "the quick brown fox jumps over the lazy dog";
+  std::string str2 = str1;
+  EXPECT_EQ(
+      ubench::string::hash64_simd(str1), ubench::string::hash64_simd(str2));
+  EXPECT_NE(
+      ubench::string::hash64_simd(str1), ubench::string::hash64_simd(str1, 42));
+  if (!ubench::string::hash64_simd_enabled()) {
+    EXPECT_EQ(ubench::string::hash64_simd(str1), ubench::string::hash64(str1));
+  }
+}
+
+// Every length takes a different path, and a change in any single byte must
+// change the hash.
+template <typename F>
+auto check_single_byte(F&& hash) -> void {
+  std::unordered_set<std::uint64_t> hashes{};
+  std::size_t count = 0;
+  for (std::size_t len = 0; len <= 130; len++) {
+    std::string str(len, 'a');
+    hashes.insert(hash(str));
+    count++;
+    for (std::size_t i = 0; i < len; i++) {
+      std::string changed = str;
+      changed[i] = 'b';
+      hashes.insert(hash(changed));
+      count++;
+    }
+  }
+  EXPECT_EQ(hashes.size(), count);
+}
+
+TEST(str_hash, hash64_single_byte) {
+  check_single_byte([](const std::string& str) {
+    return ubench::string::hash64(str);
+  });
+}
+
+TEST(str_hash, hash64_simd_single_byte) {
+  check_single_byte([](const std::string& str) {
+    return ubench::string::hash64_simd(str);
+  });
+}
+
+TEST(str_hash, hash64_distribution) {
+  // The low bits select the bucket, so must be well distributed for keys that
+  // are very similar.
+  for (auto hash : {&ubench::string::hash64, &ubench::string::hash64_simd}) {
+    constexpr std::uint64_t buckets = 1024;
+    std::vector<unsigned int> counts(buckets);
+    for (int i = 0; i < 65536; i++) {
+      counts[hash("string" + std::to_string(i), 0) & (buckets - 1)]++;
+    }
+    for (auto c : counts) {
+      // On average 64 in each bucket.
+      EXPECT_GT(c, 24);
+      EXPECT_LT(c, 112);
+    }
+  }
+}
@@ -0,0 +1,300 @@
+#include "ubench/str_intern_arena.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "ubench/str_intern.h"
+
+#include <gtest/gtest.h>
+
+TEST(str_intern_arena, initialise) {
+  auto str_intern = ubench::string::str_intern_arena();
+
+  EXPECT_EQ(str_intern.size(), 0);
+  EXPECT_EQ(str_intern.bucket_count(), 4096);
+  EXPECT_EQ(str_intern.max_load_factor(), 1.0);
+  EXPECT_EQ(
+      str_intern.backend(), ubench::string::str_intern_backend::chained);
+}
+
+TEST(str_intern_arena, initialise_non_pow2_buckets) {
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_arena(3, 4096); },
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_arena(256, 128); },
+      std::invalid_argument);
+}
+
+TEST(str_intern_arena, add_string_twice) {
+  auto str_intern = ubench::string::str_intern_arena(1, 256);
+
+  std::string teststr1 = "sso";
+  auto ref1 = str_intern.intern(teststr1);
+  EXPECT_NE(ref1.data(), teststr1.data());
+  EXPECT_EQ(ref1, teststr1);
+  EXPECT_EQ(str_intern.size(), 1);
+
+  std::string teststr2 = "sso";
+  auto ref2 = str_intern.intern(teststr2);
+  EXPECT_EQ(ref1.data(), ref2.data());
+  EXPECT_EQ(ref1.size(), ref2.size());
+  EXPECT_EQ(str_intern.size(), 1);
+}
+
+TEST(str_intern_arena, nul_terminated) {
+  auto str_intern = ubench::string::str_intern_arena(1, 256);
+
+  std::string teststr = "a string that is longer than the SSO";
+  auto ref1 = str_intern.intern(std::string_view{teststr}.substr(0, 8));
+  auto ref2 = str_intern.intern(teststr);
+  auto ref3 = str_intern.intern("");
+
+  EXPECT_EQ(ref1, "a string");
+  EXPECT_EQ(ref1.data()[ref1.size()], '\0');
+  EXPECT_EQ(ref2, teststr);
+  EXPECT_EQ(ref2.data()[ref2.size()], '\0');
+  EXPECT_EQ(ref3, "");
+  EXPECT_EQ(ref3.data()[0], '\0');
+  EXPECT_EQ(str_intern.size(), 3);
+
+  // Strings are stored with a small header in between them.
+  EXPECT_GT(ref2.data(), ref1.data());
+  EXPECT_LT(ref2.data(), ref1.data() + 32);
+}
+
+TEST(str_intern_arena, add_string_rehash) {
+  for (auto backend : {ubench::string::str_intern_backend::chained,
+           ubench::string::str_intern_backend::open_addressing}) {
+    auto str_intern = ubench::string::str_intern_arena(1, 1 << 20, backend);
+
+    std::vector<std::string_view> refs{};
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      std::string teststr = "string" + std::to_string(i);
+      refs.push_back(str_intern.intern(teststr));
+      EXPECT_EQ(str_intern.intern_id(teststr), i);
+    }
+    EXPECT_EQ(str_intern.size(), 1000);
+
+    // Check the strings didn't move due to a rehash.
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      std::string teststr = "string" + std::to_string(i);
+      auto ref = str_intern.intern(teststr);
+      EXPECT_EQ(ref, teststr);
+      EXPECT_EQ(ref.data(), refs[i].data());
+      EXPECT_EQ(str_intern.lookup(i).data(), refs[i].data());
+    }
+    EXPECT_EQ(str_intern.size(), 1000);
+    EXPECT_THROW({ (void)str_intern.lookup(1000); }, std::out_of_range);
+  }
+}
+
+TEST(str_intern_arena, long_strings) {
+  auto str_intern = ubench::string::str_intern_arena(1, 256);
+
+  // Larger than the block size of the arena.
+  std::string teststr(200000, 'x');
+  auto ref = str_intern.intern(teststr);
+  EXPECT_EQ(ref, teststr);
+  EXPECT_EQ(ref.data()[ref.size()], '\0');
+  EXPECT_EQ(str_intern.intern(teststr).data(), ref.data());
+}
+
+TEST(str_intern_arena, move_ctor) {
+  auto str_intern1 = ubench::string::str_intern_arena(1, 4);
+  auto ref1 = str_intern1.intern("sso1");
+
+  ubench::string::str_intern_arena str_intern2{std::move(str_intern1)};
+  EXPECT_EQ(str_intern2.size(), 1);
+  EXPECT_EQ(str_intern2.intern("sso1").data(), ref1.data());
+}
+
+namespace {
+
+auto snapshot_path(const std::string& name) -> std::filesystem::path {
+  return std::filesystem::temp_directory_path() /
+         ("ubench_str_intern_" + name + ".snap");
+}
+
+}  // namespace
+
+TEST(str_intern_arena, snapshot_map) {
+  auto path = snapshot_path("map");
+  {
+    auto str_intern = ubench::string::str_intern_arena(1, 256);
+    for (int i = 0; i < 1000; i++) {
+      str_intern.intern("string" + std::to_string(i));
+    }
+    str_intern.intern("");
+    str_intern.save(path);
+  }
+
+  auto str_intern = ubench::string::str_intern_arena::map(path);
+  EXPECT_EQ(str_intern.size(), 1001);
+  for (std::uint32_t i = 0; i < 1000; i++) {
+    std::string teststr = "string" + std::to_string(i);
+    auto ref = str_intern.intern(teststr);
+    EXPECT_EQ(ref, teststr);
+    EXPECT_EQ(ref.data()[ref.size()], '\0');
+    EXPECT_EQ(str_intern.intern_id(teststr), i);
+    EXPECT_EQ(str_intern.lookup(i).data(), ref.data());
+  }
+  EXPECT_EQ(str_intern.intern_id(""), 1000);
+  EXPECT_EQ(str_intern.size(), 1001);
+  EXPECT_EQ(str_intern.bucket_count(), 4096);
+
+  // New strings are given identifiers after the snapshot.
+  auto ref = str_intern.intern("new");
+  EXPECT_EQ(str_intern.intern_id("new"), 1001);
+  EXPECT_EQ(str_intern.lookup(1001).data(), ref.data());
+  EXPECT_EQ(str_intern.size(), 1002);
+  EXPECT_THROW({ (void)str_intern.lookup(1002); }, std::out_of_range);
+
+  std::filesystem::remove(path);
+}
+
+TEST(str_intern_arena, snapshot_resave) {
+  auto path = snapshot_path("resave");
+  {
+    auto str_intern = ubench::string::str_intern();
+    str_intern.intern("sso1");
+    str_intern.intern("sso2");
+    str_intern.save(path);
+  }
+
+  // Replace the snapshot that is mapped, with the new strings added.
+  auto str_intern1 = ubench::string::str_intern_arena::map(path);
+  str_intern1.intern("sso3");
+  str_intern1.save(path);
+  EXPECT_EQ(str_intern1.lookup(0), "sso1");
+
+  auto str_intern2 = ubench::string::str_intern_arena::map(path);
+  EXPECT_EQ(str_intern2.size(), 3);
+  EXPECT_EQ(str_intern2.intern_id("sso1"), 0);
+  EXPECT_EQ(str_intern2.intern_id("sso2"), 1);
+  EXPECT_EQ(str_intern2.intern_id("sso3"), 2);
+  EXPECT_EQ(str_intern2.size(), 3);
+
+  std::filesystem::remove(path);
+}
+
+TEST(str_intern_arena, snapshot_empty) {
+  auto path = snapshot_path("empty");
+  ubench::string::str_intern_arena().save(path);
+
+  auto str_intern = ubench::string::str_intern_arena::map(path);
+  EXPECT_EQ(str_intern.size(), 0);
+  EXPECT_EQ(str_intern.intern_id("sso"), 0);
+  EXPECT_EQ(str_intern.lookup(0), "sso");
+
+  std::filesystem::remove(path);
+}
+
+TEST(str_intern_arena, snapshot_invalid) {
+  auto path = snapshot_path("invalid");
+  EXPECT_THROW(
+      { ubench::string::str_intern_arena::map(path); }, std::system_error);
+
+  {
+    std::ofstream file{path};
+    file << "This is not a snapshot of interned strings, but is long enough.";
+  }
+  EXPECT_THROW(
+      { ubench::string::str_intern_arena::map(path); }, std::runtime_error);
+
+  std::filesystem::remove(path);
+}
+
+TEST(str_intern_arena, snapshot_save_fails) {
+  // A directory that isn't empty can't be replaced by the snapshot.
+  auto path = snapshot_path("dir");
+  std::filesystem::create_directories(path / "file");
+
+  auto str_intern = ubench::string::str_intern_arena();
+  str_intern.intern("sso1");
+  EXPECT_THROW({ str_intern.save(path); }, std::system_error);
+
+  auto tmp_path = path;
+  tmp_path += ".tmp";
+  EXPECT_FALSE(std::filesystem::exists(tmp_path));
+
+  std::filesystem::remove_all(path);
+}
+
+TEST(str_intern_arena, snapshot_full_index) {
+  auto path = snapshot_path("full");
+  {
+    auto str_intern = ubench::string::str_intern_arena();
+    str_intern.intern("sso1");
+    str_intern.save(path);
+  }
+
+  // Corrupt the index, so that no slot is empty. A lookup of a string not in
+  // the snapshot must still end.
+  std::vector<char> data{};
+  {
+    std::ifstream file{path, std::ios::binary};
+    data.assign(std::istreambuf_iterator<char>{file},
+        std::istreambuf_iterator<char>{});
+  }
+  std::uint64_t buckets = 0;
+  std::uint64_t index_offset = 0;
+  std::memcpy(&buckets, data.data() + 24, sizeof(buckets));
+  std::memcpy(&index_offset, data.data() + 32, sizeof(index_offset));
+  for (std::uint64_t i = 0; i < buckets; i++) {
+    std::array<std::uint32_t, 2> slot = {0, 1};
+    std::memcpy(data.data() + index_offset + i * sizeof(slot), slot.data(),
+        sizeof(slot));
+  }
+  {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+
+  auto str_intern = ubench::string::str_intern_arena::map(path);
+  EXPECT_EQ(str_intern.intern_id("sso2"), 1);
+  EXPECT_EQ(str_intern.size(), 2);
+
+  std::filesystem::remove(path);
+}
+
+TEST(str_intern_arena, intern_batch) {
+  auto str_intern = ubench::string::str_intern_arena(1, 256);
+
+  std::vector<std::string> strs{};
+  for (std::uint32_t i = 0; i < 1001; i++) {
+    strs.push_back("string" + std::to_string(i % 700));
+  }
+  std::vector<std::string_view> views(strs.begin(), strs.end());
+  std::vector<std::string_view> refs(views.size());
+  str_intern.intern_batch(views.data(), views.size(), refs.data());
+  EXPECT_EQ(str_intern.size(), 700);
+  for (std::uint32_t i = 0; i < 1001; i++) {
+    EXPECT_EQ(refs[i], strs[i]);
+    EXPECT_EQ(str_intern.intern(strs[i]).data(), refs[i].data());
+  }
+
+  // With a snapshot, the strings in it are returned from the mapping.
+  auto path = snapshot_path("batch");
+  str_intern.save(path);
+  auto mapped = ubench::string::str_intern_arena::map(path);
+  views.emplace_back("new");
+  refs.resize(views.size());
+  mapped.intern_batch(views.data(), views.size(), refs.data());
+  EXPECT_EQ(mapped.size(), 701);
+  for (std::uint32_t i = 0; i < views.size(); i++) {
+    EXPECT_EQ(refs[i], views[i]);
+    EXPECT_EQ(mapped.intern(views[i]).data(), refs[i].data());
+  }
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,158 @@
+#include "ubench/str_intern_concurrent.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(str_intern_concurrent, initialise) {
+  auto str_intern = ubench::string::str_intern_concurrent();
+
+  EXPECT_EQ(str_intern.size(), 0);
+  EXPECT_EQ(str_intern.shard_count(), 16);
+  EXPECT_EQ(str_intern.bucket_count(), 4096);
+  EXPECT_EQ(str_intern.max_load_factor(), 1.0);
+}
+
+TEST(str_intern_concurrent, initialise_single_shard) {
+  auto str_intern = ubench::string::str_intern_concurrent(1, 1, 256);
+
+  EXPECT_EQ(str_intern.size(), 0);
+  EXPECT_EQ(str_intern.shard_count(), 1);
+  EXPECT_EQ(str_intern.bucket_count(), 1);
+
+  std::string teststr = "sso";
+  const auto& ref = str_intern.intern(teststr);
+  EXPECT_NE(&ref, &teststr);
+  EXPECT_EQ(ref, teststr);
+  EXPECT_EQ(str_intern.size(), 1);
+}
+
+TEST(str_intern_concurrent, initialise_non_pow2) {
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_concurrent(0, 4096); },
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_concurrent(3, 4096); },
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_concurrent(4, 4095); },
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      {
+        auto str_intern = ubench::string::str_intern_concurrent(4, 256, 4095);
+      },
+      std::invalid_argument);
+}
+
+TEST(str_intern_concurrent, initialise_not_enough_buckets) {
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_concurrent(16, 8); },
+      std::invalid_argument);
+
+  EXPECT_THROW(
+      { auto str_intern = ubench::string::str_intern_concurrent(4, 256, 128); },
+      std::invalid_argument);
+}
+
+TEST(str_intern_concurrent, add_string_twice) {
+  auto str_intern = ubench::string::str_intern_concurrent();
+
+  std::string teststr1 = "sso";
+  const auto& ref1 = str_intern.intern(teststr1);
+  EXPECT_NE(&ref1, &teststr1);
+  EXPECT_EQ(ref1, teststr1);
+  EXPECT_EQ(str_intern.size(), 1);
+
+  std::string teststr2 = "sso";
+  const auto& ref2 = str_intern.intern(teststr2);
+  EXPECT_EQ(ref2, teststr2);
+  EXPECT_EQ(str_intern.size(), 1);
+
+  EXPECT_EQ(&ref1, &ref2);
+}
+
+TEST(str_intern_concurrent, add_string_rehash) {
+  // Four shards of one bucket each, growing to 64 buckets each.
+  auto str_intern = ubench::string::str_intern_concurrent(4, 4, 256);
+
+  std::vector<const std::string*> refs{};
+  for (int i = 0; i < 1000; i++) {
+    refs.push_back(&str_intern.intern("string" + std::to_string(i)));
+  }
+  EXPECT_EQ(str_intern.size(), 1000);
+  EXPECT_EQ(str_intern.bucket_count(), 256);
+
+  // Check the strings didn't move due to a rehash.
+  for (int i = 0; i < 1000; i++) {
+    std::string teststr = "string" + std::to_string(i);
+    const auto& ref = str_intern.intern(teststr);
+    EXPECT_EQ(ref, teststr);
+    EXPECT_EQ(&ref, refs[i]);
+  }
+  EXPECT_EQ(str_intern.size(), 1000);
+}
+
+TEST(str_intern_concurrent, max_load_factor) {
+  auto str_intern = ubench::string::str_intern_concurrent(1, 1, 256);
+  str_intern.max_load_factor(0.25);
+  ASSERT_EQ(str_intern.max_load_factor(), 0.25);
+
+  // Same as for str_intern with a single shard: 1 / 1 = 1; Rehash to 2 / 0.25
+  // = 8 buckets.
+  str_intern.intern("sso1");
+  str_intern.intern("sso2");
+  EXPECT_EQ(str_intern.size(), 2);
+  EXPECT_EQ(str_intern.bucket_count(), 8);
+
+  EXPECT_THROW({ str_intern.max_load_factor(0.0); }, std::invalid_argument);
+}
+
+TEST(str_intern_concurrent, move_ctor) {
+  auto str_intern1 = ubench::string::str_intern_concurrent(2, 2, 4);
+  const auto& ref1 = str_intern1.intern("sso1");
+
+  ubench::string::str_intern_concurrent str_intern2{std::move(str_intern1)};
+  EXPECT_EQ(str_intern2.size(), 1);
+  EXPECT_EQ(&str_intern2.intern("sso1"), &ref1);
+}
+
+TEST(str_intern_concurrent, multithreaded_same_strings) {
+  constexpr int threads = 8;
+  constexpr int strings = 2000;
+
+  // Start small so that shards are rehashed while other threads read.
+  auto str_intern = ubench::string::str_intern_concurrent(4, 4);
+  std::vector<std::vector<const std::string*>> refs(threads);
+
+  std::vector<std::thread> workers{};
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&str_intern, &refs, t]() {
+      refs[t].reserve(strings);
+      for (int i = 0; i < strings; i++) {
+        // Each thread interns in a different order, to race on the insert.
+        int s = (i + t * (strings / threads)) % strings;
+        refs[t].push_back(&str_intern.intern("string" + std::to_string(s)));
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  EXPECT_EQ(str_intern.size(), strings);
+
+  // All threads must have been given the same interned string.
+  for (int t = 0; t < threads; t++) {
+    for (int i = 0; i < strings; i++) {
+      int s = (i + t * (strings / threads)) % strings;
+      const auto& ref = str_intern.intern("string" + std::to_string(s));
+      EXPECT_EQ(refs[t][i], &ref);
+    }
+  }
+}
@@ -1,6 +1,10 @@
 #include "ubench/str_intern.h"
 
+#include <cstdint>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -433,3 +437,303 @@ TEST(str_intern, move_assignment) {
   EXPECT_EQ(str_intern2.bucket_count(), 2);
   EXPECT_EQ(ref2, teststr2);
 }
+
+TEST(str_intern, open_addressing_initialise) {
+  auto str_intern = ubench::string::str_intern(
+      ubench::string::str_intern_backend::open_addressing);
+
+  EXPECT_EQ(str_intern.size(), 0);
+  EXPECT_EQ(str_intern.bucket_count(), 4096);
+  EXPECT_EQ(str_intern.max_load_factor(), 1.0);
+  EXPECT_EQ(str_intern.backend(),
+      ubench::string::str_intern_backend::open_addressing);
+
+  auto str_intern_default = ubench::string::str_intern();
+  EXPECT_EQ(str_intern_default.backend(),
+      ubench::string::str_intern_backend::chained);
+}
+
+TEST(str_intern, open_addressing_add_string_twice) {
+  auto str_intern = ubench::string::str_intern(
+      1, 256, ubench::string::str_intern_backend::open_addressing);
+
+  std::string teststr1 = "sso";
+  const auto& ref1 = str_intern.intern(teststr1);
+  EXPECT_NE(&ref1, &teststr1);
+  EXPECT_EQ(ref1, teststr1);
+  EXPECT_EQ(str_intern.size(), 1);
+
+  std::string teststr2 = "sso";
+  const auto& ref2 = str_intern.intern(teststr2);
+  EXPECT_EQ(&ref1, &ref2);
+  EXPECT_EQ(str_intern.size(), 1);
+}
+
+TEST(str_intern, open_addressing_rehash_small) {
+  auto str_intern = ubench::string::str_intern(
+      1, 256, ubench::string::str_intern_backend::open_addressing);
+
+  // The load factor is limited to 0.875, so there is always a free bucket.
+  //
+  // load_factor before = 0 / 1 = 0; no rehash on insert.
+  str_intern.intern("sso1");
+  EXPECT_EQ(str_intern.bucket_count(), 1);
+
+  // load_factor before = 1 / 1 = 1; Rehash to 2 / 0.875 = 4 buckets.
+  str_intern.intern("sso2");
+  EXPECT_EQ(str_intern.bucket_count(), 4);
+
+  // load_factor before = 2 / 4 = 0.5; No rehash.
+  str_intern.intern("sso3");
+  EXPECT_EQ(str_intern.bucket_count(), 4);
+
+  // load_factor before = 3 / 4 = 0.75; Rehash at 3 (4 * 0.875) to 4 / 0.875 =
+  // 8 buckets.
+  str_intern.intern("sso4");
+  EXPECT_EQ(str_intern.size(), 4);
+  EXPECT_EQ(str_intern.bucket_count(), 8);
+}
+
+TEST(str_intern, open_addressing_full) {
+  auto str_intern = ubench::string::str_intern(
+      4, 4, ubench::string::str_intern_backend::open_addressing);
+
+  // At the maximum number of buckets, every bucket may be used.
+  const auto& ref1 = str_intern.intern("sso1");
+  str_intern.intern("sso2");
+  str_intern.intern("sso3");
+  str_intern.intern("sso4");
+  EXPECT_EQ(str_intern.size(), 4);
+  EXPECT_EQ(str_intern.bucket_count(), 4);
+  EXPECT_EQ(&str_intern.intern("sso1"), &ref1);
+
+  EXPECT_THROW({ str_intern.intern("sso5"); }, std::length_error);
+  EXPECT_EQ(str_intern.size(), 4);
+}
+
+TEST(str_intern, open_addressing_many) {
+  auto str_intern = ubench::string::str_intern(
+      16, 1 << 20, ubench::string::str_intern_backend::open_addressing);
+
+  std::vector<const std::string*> refs{};
+  for (int i = 0; i < 10000; i++) {
+    refs.push_back(&str_intern.intern("string" + std::to_string(i)));
+  }
+  EXPECT_EQ(str_intern.size(), 10000);
+  EXPECT_EQ(str_intern.bucket_count(), 16384);
+
+  // Check the strings didn't move due to a rehash, and all are found.
+  for (int i = 0; i < 10000; i++) {
+    std::string teststr = "string" + std::to_string(i);
+    const auto& ref = str_intern.intern(teststr);
+    EXPECT_EQ(ref, teststr);
+    EXPECT_EQ(&ref, refs[i]);
+  }
+  EXPECT_EQ(str_intern.size(), 10000);
+}
+
+TEST(str_intern, intern_id) {
+  auto str_intern = ubench::string::str_intern(1, 256);
+
+  EXPECT_EQ(str_intern.intern_id("sso1"), 0);
+  EXPECT_EQ(str_intern.intern_id("sso2"), 1);
+  EXPECT_EQ(str_intern.intern_id("sso1"), 0);
+  EXPECT_EQ(str_intern.size(), 2);
+
+  // Strings interned without an identifier also get one.
+  const auto& ref3 = str_intern.intern("sso3");
+  EXPECT_EQ(str_intern.intern_id("sso3"), 2);
+  EXPECT_EQ(str_intern.lookup(2).data(), ref3.data());
+
+  EXPECT_EQ(str_intern.lookup(0), "sso1");
+  EXPECT_EQ(str_intern.lookup(1), "sso2");
+  EXPECT_EQ(str_intern.lookup(2), "sso3");
+  EXPECT_THROW({ (void)str_intern.lookup(3); }, std::out_of_range);
+}
+
+TEST(str_intern, intern_id_rehash) {
+  for (auto backend : {ubench::string::str_intern_backend::chained,
+           ubench::string::str_intern_backend::open_addressing}) {
+    auto str_intern = ubench::string::str_intern(1, 1 << 20, backend);
+
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      EXPECT_EQ(str_intern.intern_id("string" + std::to_string(i)), i);
+    }
+
+    // The identifiers don't change with a rehash.
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      std::string teststr = "string" + std::to_string(i);
+      EXPECT_EQ(str_intern.intern_id(teststr), i);
+      EXPECT_EQ(str_intern.lookup(i), teststr);
+      EXPECT_EQ(str_intern.lookup(i).data(), str_intern.intern(teststr).data());
+    }
+    EXPECT_EQ(str_intern.size(), 1000);
+  }
+}
+
+TEST(str_intern, rehash_incremental) {
+  for (auto backend : {ubench::string::str_intern_backend::chained,
+           ubench::string::str_intern_backend::open_addressing}) {
+    auto str_intern = ubench::string::str_intern(
+        1, 1 << 20, backend, ubench::string::str_intern_rehash::incremental);
+    auto str_intern_full = ubench::string::str_intern(1, 1 << 20, backend);
+    EXPECT_EQ(str_intern.rehash_mode(),
+        ubench::string::str_intern_rehash::incremental);
+    EXPECT_EQ(
+        str_intern_full.rehash_mode(), ubench::string::str_intern_rehash::full);
+
+    std::vector<const std::string*> refs{};
+    for (std::uint32_t i = 0; i < 10000; i++) {
+      std::string teststr = "string" + std::to_string(i);
+      refs.push_back(&str_intern.intern(teststr));
+      str_intern_full.intern(teststr);
+
+      // The number of buckets grows the same as a full rehash.
+      EXPECT_EQ(str_intern.bucket_count(), str_intern_full.bucket_count());
+
+      // All strings are found while both tables are used.
+      if (i % 97 == 0) {
+        for (std::uint32_t j = 0; j <= i; j++) {
+          EXPECT_EQ(&str_intern.intern("string" + std::to_string(j)), refs[j]);
+        }
+      }
+    }
+    EXPECT_EQ(str_intern.size(), 10000);
+
+    for (std::uint32_t i = 0; i < 10000; i++) {
+      std::string teststr = "string" + std::to_string(i);
+      EXPECT_EQ(&str_intern.intern(teststr), refs[i]);
+      EXPECT_EQ(str_intern.intern_id(teststr), i);
+    }
+    EXPECT_EQ(str_intern.size(), 10000);
+  }
+}
+
+TEST(str_intern, rehash_incremental_mlf_low) {
+  // A low load factor results in a rehash before the previous one is
+  // complete.
+  auto str_intern = ubench::string::str_intern(1, 1 << 20,
+      ubench::string::str_intern_backend::chained,
+      ubench::string::str_intern_rehash::incremental);
+  str_intern.max_load_factor(0.02);
+
+  std::vector<const std::string*> refs{};
+  for (std::uint32_t i = 0; i < 2000; i++) {
+    refs.push_back(&str_intern.intern("string" + std::to_string(i)));
+  }
+  EXPECT_EQ(str_intern.size(), 2000);
+  for (std::uint32_t i = 0; i < 2000; i++) {
+    EXPECT_EQ(&str_intern.intern("string" + std::to_string(i)), refs[i]);
+  }
+  EXPECT_EQ(str_intern.size(), 2000);
+}
+
+TEST(str_intern, intern_batch) {
+  for (auto rehash : {ubench::string::str_intern_rehash::full,
+           ubench::string::str_intern_rehash::incremental}) {
+    for (auto backend : {ubench::string::str_intern_backend::chained,
+             ubench::string::str_intern_backend::open_addressing}) {
+      auto str_intern = ubench::string::str_intern(1, 1 << 20, backend, rehash);
+
+      // Duplicates within the same group, and a count that isn't a multiple
+      // of the group size. The buckets grow while interning a batch.
+      std::vector<std::string> strs{};
+      for (std::uint32_t i = 0; i < 1001; i++) {
+        strs.push_back("string" + std::to_string(i % 700));
+      }
+      std::vector<std::string_view> views(strs.begin(), strs.end());
+      std::vector<const std::string*> refs(views.size());
+      str_intern.intern_batch(views.data(), views.size(), refs.data());
+      EXPECT_EQ(str_intern.size(), 700);
+
+      for (std::uint32_t i = 0; i < 1001; i++) {
+        EXPECT_EQ(*refs[i], strs[i]);
+        EXPECT_EQ(&str_intern.intern(strs[i]), refs[i]);
+        EXPECT_EQ(str_intern.intern_id(strs[i]), i % 700);
+      }
+      EXPECT_EQ(str_intern.size(), 700);
+
+      str_intern.intern_batch(nullptr, 0, nullptr);
+      EXPECT_EQ(str_intern.size(), 700);
+    }
+  }
+}
+
+TEST(str_intern, hash_function) {
+  for (auto hash : {ubench::string::str_intern_hash::standard,
+           ubench::string::str_intern_hash::fast,
+           ubench::string::str_intern_hash::simd}) {
+    for (auto backend : {ubench::string::str_intern_backend::chained,
+             ubench::string::str_intern_backend::open_addressing}) {
+      auto str_intern = ubench::string::str_intern(1, 1 << 20, backend,
+          ubench::string::str_intern_rehash::full, hash);
+      EXPECT_EQ(str_intern.hash_function(), hash);
+
+      std::vector<const std::string*> refs{};
+      for (std::uint32_t i = 0; i < 5000; i++) {
+        refs.push_back(&str_intern.intern("string" + std::to_string(i)));
+      }
+      EXPECT_EQ(str_intern.size(), 5000);
+      for (std::uint32_t i = 0; i < 5000; i++) {
+        EXPECT_EQ(&str_intern.intern("string" + std::to_string(i)), refs[i]);
+      }
+      EXPECT_EQ(str_intern.size(), 5000);
+    }
+  }
+  EXPECT_EQ(ubench::string::str_intern().hash_function(),
+      ubench::string::str_intern_hash::standard);
+}
+
+TEST(str_intern, stats) {
+  for (auto backend : {ubench::string::str_intern_backend::chained,
+           ubench::string::str_intern_backend::open_addressing}) {
+    auto str_intern = ubench::string::str_intern(4, 1 << 20, backend);
+    auto empty = str_intern.stats();
+    EXPECT_EQ(empty.chain_lengths.size(), 1);
+    EXPECT_EQ(empty.chain_lengths[0], 4);
+    EXPECT_EQ(empty.longest_probe, 0);
+    EXPECT_EQ(empty.rehashes, 0);
+    EXPECT_EQ(empty.hits, 0);
+    EXPECT_EQ(empty.misses, 0);
+
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      str_intern.intern("string" + std::to_string(i));
+    }
+    str_intern.intern("string0");
+    str_intern.intern("string1");
+
+    auto stats = str_intern.stats();
+    EXPECT_EQ(stats.longest_probe + 1, stats.chain_lengths.size());
+    EXPECT_GT(stats.longest_probe, 0);
+    EXPECT_NE(stats.chain_lengths.back(), 0);
+    EXPECT_GT(stats.rehashes, 0);
+    EXPECT_GT(stats.string_bytes, 0);
+    EXPECT_GT(stats.table_bytes, 0);
+
+    // The histogram accounts for every bucket, and every string.
+    std::size_t strings = 0;
+    std::size_t buckets = stats.chain_lengths[0];
+    for (std::size_t n = 1; n < stats.chain_lengths.size(); n++) {
+      if (backend == ubench::string::str_intern_backend::chained) {
+        strings += n * stats.chain_lengths[n];
+        buckets += stats.chain_lengths[n];
+      } else {
+        strings += stats.chain_lengths[n];
+      }
+    }
+    if (backend == ubench::string::str_intern_backend::chained) {
+      EXPECT_EQ(buckets, str_intern.bucket_count());
+    } else {
+      EXPECT_EQ(buckets + strings, str_intern.bucket_count());
+    }
+    EXPECT_EQ(strings, 1000);
+
+    if (stats.counters) {
+      EXPECT_EQ(stats.hits, 2);
+      EXPECT_EQ(stats.misses, 1000);
+    } else {
+      EXPECT_EQ(stats.hits, 0);
+      EXPECT_EQ(stats.misses, 0);
+    }
+  }
+}
@@ -1,9 +1,40 @@
 #ifndef BENCHMARK_BASE_H
 #define BENCHMARK_BASE_H
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 
+#include "ubench/clock.h"
+
+/// @brief The clock used to time each sample.
+enum class clock_type {
+  hires,  //< std::chrono::high_resolution_clock.
+  cycle,  //< ubench::chrono::cycle_clock.
+};
+
+/// @brief Time a function with the clock given.
+///
+/// @param clock the clock to use.
+///
+/// @param func the function to time.
+///
+/// @return the time taken by the function.
+template <typename Func>
+auto time_sample(clock_type clock, Func&& func) -> std::chrono::nanoseconds {
+  if (clock == clock_type::cycle) {
+    auto start = ubench::chrono::cycle_clock::ticks();
+    func();
+    auto end = ubench::chrono::cycle_clock::ticks();
+    return ubench::chrono::cycle_clock::to_duration(end - start);
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  func();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+}
+
 class benchmark {
  public:
   benchmark() = default;
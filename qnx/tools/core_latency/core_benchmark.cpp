@@ -245,11 +245,9 @@ auto core_benchmark::run(std::uint32_t ping_core, std::uint32_t pong_core)
     flag.wait();
 
     for (std::uint32_t i = 0; i < samples_; i++) {
-      auto start = std::chrono::high_resolution_clock::now();
-      cas<PONG, PING>(ctype_, iterations_, flag_);
-      auto end = std::chrono::high_resolution_clock::now();
-      std::uint32_t duration = std::chrono::nanoseconds(end - start).count();
-      stats.insert(duration);
+      auto duration = time_sample(
+          clock_, [&]() { cas<PONG, PING>(ctype_, iterations_, flag_); });
+      stats.insert(static_cast<statistics::value_type>(duration.count()));
     }
   });
 
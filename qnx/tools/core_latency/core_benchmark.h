@@ -17,8 +17,11 @@ class core_benchmark : public benchmark {
 
   // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
   core_benchmark(std::uint32_t iterations, std::uint32_t samples,
-      cas_type ctype = cas_type::cpp)
-      : iterations_{iterations}, samples_{samples}, ctype_{ctype} {}
+      cas_type ctype = cas_type::cpp, clock_type clock = clock_type::hires)
+      : iterations_{iterations},
+        samples_{samples},
+        ctype_{ctype},
+        clock_{clock} {}
 
   [[nodiscard]] auto name() const -> std::string override;
 
@@ -46,6 +49,7 @@ class core_benchmark : public benchmark {
   std::uint32_t iterations_{4000};
   std::uint32_t samples_{500};
   cas_type ctype_{cas_type::cpp};
+  clock_type clock_{clock_type::hires};
 };
 
 #endif
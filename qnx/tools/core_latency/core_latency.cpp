@@ -9,6 +9,7 @@
 #include <iostream>
 #include <memory>
 
+#include "ubench/clock.h"
 #include "ubench/thread.h"
 #include "core_benchmark.h"
 #include "corerw_benchmark.h"
@@ -22,14 +23,14 @@ auto main(int argc, char* argv[]) -> int {
   switch (options->benchmark()) {
     case core_mode::mode_readwrite: {
       bm = std::make_unique<corerw_benchmark>(
-          options->iters(), options->samples());
+          options->iters(), options->samples(), options->clock());
       break;
     }
     case core_mode::mode_cas: {
       auto cm = core_benchmark::mode(options->benchmark_name());
       if (cm) {
         bm = std::make_unique<core_benchmark>(
-            options->iters(), options->samples(), *cm);
+            options->iters(), options->samples(), *cm, options->clock());
       }
       break;
     }
@@ -52,6 +53,19 @@ auto main(int argc, char* argv[]) -> int {
   std::cout << "Running " << bm->name() << " Core Benchmark" << std::endl;
   std::cout << " Samples: " << options->samples() << std::endl;
   std::cout << " Iterations: " << options->iters() << std::endl;
+  if (options->clock() == clock_type::cycle) {
+    // Calibrate before the first sample is timed.
+    double ns_per_tick = ubench::chrono::cycle_clock::ns_per_tick();
+    std::cout << " Clock: cycle (" << std::setprecision(4)
+              << 1000.0 / ns_per_tick << " MHz)" << std::endl;
+    if (!ubench::chrono::cycle_clock::is_invariant()) {
+      std::cerr << "Warning: The cycle counter may not run at a constant "
+                   "rate, or be synchronised between cores"
+                << std::endl;
+    }
+  } else {
+    std::cout << " Clock: hires" << std::endl;
+  }
   std::cout << std::endl;
 
   std::cout << "      ";
@@ -61,16 +61,15 @@ auto corerw_benchmark::run(std::uint32_t ping_core, std::uint32_t pong_core)
 
     std::uint32_t v = PONG;
     for (std::uint32_t i = 0; i < samples_; i++) {
-      auto start = std::chrono::high_resolution_clock::now();
-      for (std::uint32_t j = 0; j < iterations_; j++) {
-        while (this->pong_.load(std::memory_order_acquire) != v) {
+      auto duration = time_sample(clock_, [&]() {
+        for (std::uint32_t j = 0; j < iterations_; j++) {
+          while (this->pong_.load(std::memory_order_acquire) != v) {
+          }
+          this->ping_.store(v, std::memory_order_release);
+          v = !v;
         }
-        this->ping_.store(v, std::memory_order_release);
-        v = !v;
-      }
-      auto end = std::chrono::high_resolution_clock::now();
-      std::uint32_t duration = std::chrono::nanoseconds(end - start).count();
-      stats.insert(duration);
+      });
+      stats.insert(static_cast<statistics::value_type>(duration.count()));
     }
   });
 
@@ -11,8 +11,9 @@ class corerw_benchmark : public benchmark {
  public:
   corerw_benchmark() = default;
   // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
-  corerw_benchmark(std::uint32_t iterations, std::uint32_t samples)
-      : iterations_{iterations}, samples_{samples} {}
+  corerw_benchmark(std::uint32_t iterations, std::uint32_t samples,
+      clock_type clock = clock_type::hires)
+      : iterations_{iterations}, samples_{samples}, clock_{clock} {}
 
   [[nodiscard]] auto name() const -> std::string override;
 
@@ -26,6 +27,7 @@ class corerw_benchmark : public benchmark {
   static constexpr std::uint32_t PONG = !PING;
   std::uint32_t iterations_{4000};
   std::uint32_t samples_{500};
+  clock_type clock_{clock_type::hires};
 
   // Starting from Intel's Sandy Bridge, spatial prefetcher is now pulling pairs
   // of 64-byte cache lines at a time, so we have to align to 128 bytes rather
@@ -1,6 +1,7 @@
 #include "options.h"
 
 #include <iostream>
+#include <string_view>
 
 #include "stdext/expected.h"
 #include "ubench/options.h"
@@ -11,7 +12,8 @@ namespace {
 
 auto print_help(std::string_view prog_name) -> void {
   std::cout << "USAGE: " << prog_name
-            << " [-s <samples>] [-i <iters>] [-b benchmark]" << std::endl;
+            << " [-s <samples>] [-i <iters>] [-b benchmark] [-c clock]"
+            << std::endl;
   std::cout << std::endl;
   std::cout
       << "Execute Core Latency test for <iters> per <sample> for each core."
@@ -22,6 +24,10 @@ auto print_help(std::string_view prog_name) -> void {
     std::cout << " - " << benchmark.first << std::endl;
   }
   std::cout << " - readwrite" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Clocks supported are:" << std::endl;
+  std::cout << " - hires (default)" << std::endl;
+  std::cout << " - cycle" << std::endl;
 }
 
 }  // namespace
@@ -33,7 +39,7 @@ auto make_options(int argc, const char* const argv[]) noexcept
   int err = 0;
 
   options o{};
-  ubench::options opts{argc, argv, "s:i:b:?"};
+  ubench::options opts{argc, argv, "s:i:b:c:?"};
   for (const auto& opt : opts) {
     if (opt) {
       switch (opt->get_option()) {
@@ -75,6 +81,19 @@ auto make_options(int argc, const char* const argv[]) noexcept
           o.benchmark_name_ = *opt->argument();
           break;
         }
+        case 'c': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          std::string_view clock = *opt->argument();
+          if (clock == "hires") {
+            o.clock_ = clock_type::hires;
+          } else if (clock == "cycle") {
+            o.clock_ = clock_type::cycle;
+          } else {
+            err = 1;
+            std::cerr << "Error: clock type unknown." << std::endl;
+          }
+          break;
+        }
         case '?':
           help = true;
           break;
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "stdext/expected.h"
+#include "benchmark.h"
 
 enum class core_mode {
   mode_readwrite,  //< Use sendto() for sending packets.
@@ -45,6 +46,11 @@ class options {
     return core_mode_;
   }
 
+  /// @brief The clock used to time each sample.
+  ///
+  /// @return the clock to time with.
+  [[nodiscard]] auto clock() const noexcept -> clock_type { return clock_; }
+
  private:
   options() = default;
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -55,6 +61,7 @@ class options {
   core_mode core_mode_{};
   unsigned int samples_{500};
   unsigned int iters_{4000};
+  clock_type clock_{clock_type::hires};
 };
 
 /// @brief Get options.
@@ -17,7 +17,8 @@ namespace {
 void print_help(std::string_view prog_name) {
   std::cout << prog_name << " [-n<slots>] [-m<width>] [-p<packets>] [-s<size>]"
             << std::endl;
-  std::cout << "  [-d<duration>] [-T<threads>] [-I] [-B<mode]" << std::endl;
+  std::cout << "  [-d<duration>] [-T<threads>] [-I] [-t<period>] [-B<mode]"
+            << std::endl;
   std::cout << "  -S<sourceip> -D<destip>" << std::endl;
   std::cout << std::endl;
   std::cout << "Writes UDP packets bound from <sourceip> IPv4 address "
@@ -74,6 +75,9 @@ void print_help(std::string_view prog_name) {
                "or multicast)."
             << std::endl;
   std::cout << " -I - Enable IDLE mode test prior" << std::endl;
+  std::cout << " -t<period> - Sample the CPU load every period milliseconds, "
+               "and print the timeline."
+            << std::endl;
   std::cout << std::endl;
   std::cout << " -? - Display this help." << std::endl;
 }
@@ -84,7 +88,7 @@ void print_help(std::string_view prog_name) {
 auto make_options(int argc, char* const argv[]) noexcept
     -> stdext::expected<options, int> {
   options o{};
-  ubench::options opts{argc, argv, "n:m:p:s:d:B:T:S:D:I?"};
+  ubench::options opts{argc, argv, "n:m:p:s:d:B:T:S:D:It:?"};
   for (const auto& opt : opts) {
     if (opt) {
       switch (opt->get_option()) {
@@ -237,6 +241,18 @@ auto make_options(int argc, char* const argv[]) noexcept
         case 'I':
           o.idle_ = true;
           break;
+        case 't': {
+          // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+          auto arg = *opt->argument();
+          auto t = ubench::string::parse_int<std::uint16_t>(arg);
+          if (!t || *t < 1) {
+            std::cerr << "Error: Invalid value for the sample period - " << arg
+                      << std::endl;
+            return stdext::unexpected{1};
+          }
+          o.sample_period_ = *t;
+          break;
+        }
         case '?':
           print_help(opts.prog_name());
           return stdext::unexpected{0};
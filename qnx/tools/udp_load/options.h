@@ -144,6 +144,19 @@ class options {
   /// @return true if the idle test should run, false otherwise.
   [[nodiscard]] auto enable_idle_test() const noexcept -> bool { return idle_; }
 
+  /// @brief The period to sample the CPU load during the test.
+  ///
+  /// This is the '-t period' option, in milliseconds. The CPU load is sampled
+  /// in the background, so that the load can be seen changing over the test,
+  /// such as when the shaping falls behind.
+  ///
+  /// @return The period to sample the CPU load. Zero, the default, if the CPU
+  /// load shouldn't be sampled.
+  [[nodiscard]] auto sample_period() const noexcept
+      -> std::chrono::milliseconds {
+    return std::chrono::milliseconds(sample_period_);
+  }
+
  private:
   options() = default;
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
@@ -160,6 +173,7 @@ class options {
   std::uint32_t packets_{1000};
   std::uint32_t duration_{30000};
   std::uint16_t threads_{1};
+  std::uint16_t sample_period_{0};
 };
 
 /// @brief Get options.
@@ -4,8 +4,10 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <thread>
 
+#include "ubench/measure/sampler.h"
 #include "ubench/net.h"
 #include "ubench/thread.h"
 #include "options.h"
@@ -32,6 +34,7 @@ auto main(int argc, char* argv[]) -> int {
   std::atomic<std::uint32_t> wait_time{0};
   std::atomic<std::uint32_t> sent_time{0};
   std::atomic<std::uint32_t> thread_failures{0};
+  std::atomic<std::uint64_t> packets_progress{0};
 
   ubench::thread::sync_event sync{};
   std::vector<std::thread> runners{};
@@ -74,6 +77,11 @@ auto main(int argc, char* argv[]) -> int {
       std::cerr << "Error: Couldn't initialise talker" << std::endl;
       return 1;
     }
+    // The counter is shared by all talkers, so it's only updated when
+    // sampling, to not add contention to the load being measured.
+    if (options->sample_period().count() > 0) {
+      talker->set_progress(&packets_progress);
+    }
 
     auto runner = [&sync, &packets_sent, &packets_expected, &wait_time,
                       &sent_time,
@@ -145,13 +153,26 @@ auto main(int argc, char* argv[]) -> int {
 
   std::this_thread::sleep_for(std::chrono::milliseconds(500));
   std::cout << "Performing TEST... " << std::flush;
+  // The sampler runs on the last core, which the talkers aren't pinned away
+  // from, but it only wakes once a period.
+  std::optional<ubench::measure::sampler> sampler{};
+  if (options->sample_period().count() > 0) {
+    auto samples = (options->duration() + options->sample_period() * 10) /
+                   options->sample_period();
+    sampler.emplace(options->sample_period(), samples,
+        ubench::thread::thread_count() - 1);
+    sampler->add_counter("Packets", packets_progress);
+  }
+
   ubench::measure::busy_measurement run_measurement{};
   {
     ubench::measure::busy_stop_watch run{};
+    if (sampler) sampler->start();
     sync.set();
     for (auto& t : runners) {
       t.join();
     }
+    if (sampler) sampler->stop();
     run_measurement = run.measure();
   }
 
@@ -184,9 +205,28 @@ auto main(int argc, char* argv[]) -> int {
   std::cout << "Process CPU Busy: " << cputime / 100 << "." << std::setw(2)
             << std::setfill('0') << cputime % 100 << "%" << std::endl;
 
+  // The total hides a single CPU saturated by the receive interrupts.
+  auto cpus = ubench::measure::make_cpu_table(run_measurement);
+  if (cpus.size() > 0) {
+    std::cout << std::setfill(' ') << std::endl << cpus << std::endl;
+  }
+
   std::cout << "Time in send: " << sent_time << "ms" << std::endl;
   std::cout << "Time in sleep: " << wait_time << "ms" << std::endl;
   std::cout << "Packets Sent: " << packets_sent << std::endl;
   std::cout << "Packets Expected: " << packets_expected << std::endl;
+
+  if (sampler) {
+    if (!sampler->pinned()) {
+      std::cerr << "Warning: The sampler couldn't be pinned to a core"
+                << std::endl;
+    }
+    if (sampler->overwritten() > 0) {
+      std::cerr << "Warning: The first " << sampler->overwritten()
+                << " samples were overwritten" << std::endl;
+    }
+    std::cout << std::endl << "Timeline:" << std::endl;
+    std::cout << sampler->make_table() << std::endl;
+  }
   return 0;
 }
@@ -217,6 +217,7 @@ auto udp_talker::run(std::chrono::milliseconds duration) noexcept
                            .count();
         packet_sent_window_count += sent;
         total_sent += sent;
+        if (progress_) progress_->fetch_add(sent, std::memory_order_relaxed);
         r++;
 
         std::uint32_t sf = elapsed_time / width_;
@@ -8,6 +8,7 @@
 #include <sys/uio.h>
 #include <netinet/in.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -130,6 +131,14 @@ class udp_talker {
   /// @return true if initialisation succeeded, false otherwise.
   auto init() noexcept -> bool;
 
+  /// @brief Count the packets sent while running.
+  ///
+  /// @param sent the counter to increment as packets are sent, so that the
+  /// progress can be sampled during the test. It must outlive the run().
+  auto set_progress(std::atomic<std::uint64_t>* sent) noexcept -> void {
+    progress_ = sent;
+  }
+
   /// @brief Runs the simulation.
   ///
   /// @param duration The duration for the idle measurement. It is rounded to
@@ -153,6 +162,7 @@ class udp_talker {
   std::uint16_t size_{0};
   std::uint32_t packets_{0};
   bool init_{false};
+  std::atomic<std::uint64_t>* progress_{nullptr};
 
   unsigned int delay_count_{0};
 };